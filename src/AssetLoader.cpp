@@ -0,0 +1,100 @@
+// std
+#include <cstdint>
+
+// my
+#include "AssetLoader.hpp"
+#include "ImageIO.hpp"
+#include "djc_math/djc_math.hpp"
+
+namespace {
+    const int PLACEHOLDER_TEXTURE_SIZE = 8;
+}
+
+//------------------------------------------------------------
+AssetLoader::AssetLoader(size_t threadCount)
+:   m_pool(threadCount)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+AssetHandle<std::vector<Mesh>>
+AssetLoader::loadMeshes(std::string const & filePath) {
+    return load<std::vector<Mesh>>([filePath]() -> std::unique_ptr<std::vector<Mesh>> {
+        // already on a pool worker, loads run side by side rather than each starting threads of its own
+        std::vector<Mesh> meshes = loadMeshesFromFile(filePath, 1);
+        if(meshes.empty()) {
+            return nullptr;
+        }
+        return std::unique_ptr<std::vector<Mesh>>(new std::vector<Mesh>(std::move(meshes)));
+    });
+}
+
+//------------------------------------------------------------
+AssetHandle<Bitmap>
+AssetLoader::loadTexture(std::string const & filePath) {
+    return load<Bitmap>([filePath]() -> std::unique_ptr<Bitmap> {
+        std::unique_ptr<Bitmap> bitmap(new Bitmap(1, 1));
+        if(!readPPM(filePath, *bitmap)) {
+            return nullptr;
+        }
+        return bitmap;
+    });
+}
+
+//------------------------------------------------------------
+void
+AssetLoader::waitAll() {
+    m_pool.wait();
+}
+
+//------------------------------------------------------------
+Mesh const &
+getPlaceholderMesh() {
+    static Mesh const mesh = [] {
+        Mesh cube;
+
+        // corners coloured by position so the placeholder is visibly not the real asset
+        for(int corner = 0; corner < 8; corner++) {
+            djc_math::Vec3f position((corner & 1) ? 0.5f : -0.5f, (corner & 2) ? 0.5f : -0.5f, (corner & 4) ? 0.5f : -0.5f);
+            djc_math::Vec2f texCoord((corner & 1) ? 1.0f : 0.0f, (corner & 2) ? 1.0f : 0.0f);
+            cube.vertices.push_back(Vertex(position, texCoord, position + djc_math::Vec3f(0.5f)));
+        }
+
+        // counter clockwise seen from outside
+        static unsigned int const indices[36] = {
+            0, 2, 3,  0, 3, 1,   // -z
+            4, 5, 7,  4, 7, 6,   // +z
+            0, 4, 6,  0, 6, 2,   // -x
+            1, 3, 7,  1, 7, 5,   // +x
+            0, 1, 5,  0, 5, 4,   // -y
+            2, 6, 7,  2, 7, 3    // +y
+        };
+        cube.indices.assign(indices, indices + 36);
+
+        cube.bounds = computeBounds(cube.vertices);
+        cube.meshlets = buildMeshlets(cube.vertices, cube.indices);
+        return cube;
+    }();
+
+    return mesh;
+}
+
+//------------------------------------------------------------
+Bitmap &
+getPlaceholderTexture() {
+    static Bitmap texture = [] {
+        Bitmap checker(PLACEHOLDER_TEXTURE_SIZE, PLACEHOLDER_TEXTURE_SIZE);
+
+        for(int y = 0; y < PLACEHOLDER_TEXTURE_SIZE; y++) {
+            for(int x = 0; x < PLACEHOLDER_TEXTURE_SIZE; x++) {
+                unsigned char value = ((x + y) & 1) ? 255 : 64;
+                checker.setPixel(x, y, value, 0, value);
+            }
+        }
+
+        return checker;
+    }();
+
+    return texture;
+}
@@ -0,0 +1,211 @@
+#ifndef AssetLoader_hpp
+#define AssetLoader_hpp
+
+// std
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// my
+#include "Bitmap.hpp"
+#include "Mesh.hpp"
+#include "ThreadPool.hpp"
+
+/*
+    Asset
+
+    - the result of one load, filled in by a worker thread while the caller keeps going
+    - isReady() is cheap enough to poll every frame, get() is only valid once it returns true
+    - getOr(...) hands back the placeholder until the data has arrived, or for good when the load failed
+*/
+template<typename T>
+class Asset final {
+    friend class AssetLoader;
+public:
+    enum class State {
+        Pending,
+        Ready,
+        Failed
+    };
+
+public:
+    Asset();
+    Asset(Asset const &) = delete;
+    Asset & operator = (Asset const &) = delete;
+    ~Asset() = default;
+
+    State getState() const;
+    bool isReady() const;
+    bool isDone() const; // ready or failed
+
+    // non const for things drawing needs mutable, such as a Bitmap, only read from once ready
+    T & get();
+    T const & get() const;
+    T & getOr(T & placeholder);
+    T const & getOr(T const & placeholder) const;
+
+    // blocks until the load has finished, returns isReady()
+    bool wait() const;
+
+private:
+    void finish(std::unique_ptr<T> value);
+
+private:
+    std::unique_ptr<T> m_value;
+    std::atomic<State> m_state;
+
+    mutable std::mutex              m_mutex;
+    mutable std::condition_variable m_done;
+};
+
+template<typename T>
+using AssetHandle = std::shared_ptr<Asset<T>>;
+
+/*
+    AssetLoader
+
+    - runs loads on a ThreadPool and returns a handle straight away, the caller draws placeholders
+      until each handle is ready
+    - several files are parsed at once, so startup is bounded by the disk rather than by one core
+    - handles stay valid after the loader is gone, destroying the loader waits for queued loads
+*/
+class AssetLoader final {
+public:
+    // 0 uses one thread per hardware thread
+    explicit AssetLoader(size_t threadCount = 0);
+    AssetLoader(AssetLoader const &) = delete;
+    AssetLoader & operator = (AssetLoader const &) = delete;
+    ~AssetLoader() = default;
+
+    /*
+        loadMeshes(...)
+
+        - the loader is picked from the extension by loadMeshesFromFile(...)
+        - each file is read on one worker, .obj files too, many files load in parallel rather than
+          one file on many threads
+        - fails when the file has no meshes, the reason is printed by the loader that read it
+    */
+    AssetHandle<std::vector<Mesh>> loadMeshes(std::string const & filePath);
+
+    // a binary ppm through readPPM(...)
+    AssetHandle<Bitmap> loadTexture(std::string const & filePath);
+
+    /*
+        load(...)
+
+        - runs job on a worker, a null result marks the asset failed
+        - job must not throw and must only touch data it owns or that outlives the load
+    */
+    template<typename T>
+    AssetHandle<T> load(std::function<std::unique_ptr<T>()> job);
+
+    // blocks until every load so far has finished
+    void waitAll();
+
+private:
+    ThreadPool m_pool;
+};
+
+// a unit cube, for instances whose mesh is still loading
+Mesh const & getPlaceholderMesh();
+
+// a small checker, for textures that are still loading
+Bitmap & getPlaceholderTexture();
+
+//------------------------------------------------------------
+template<typename T>
+Asset<T>::Asset()
+:   m_state(State::Pending)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+template<typename T>
+typename Asset<T>::State
+Asset<T>::getState() const {
+    return m_state.load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------
+template<typename T>
+bool
+Asset<T>::isReady() const {
+    return getState() == State::Ready;
+}
+
+//------------------------------------------------------------
+template<typename T>
+bool
+Asset<T>::isDone() const {
+    return getState() != State::Pending;
+}
+
+//------------------------------------------------------------
+template<typename T>
+T &
+Asset<T>::get() {
+    return *m_value;
+}
+
+//------------------------------------------------------------
+template<typename T>
+T const &
+Asset<T>::get() const {
+    return *m_value;
+}
+
+//------------------------------------------------------------
+template<typename T>
+T &
+Asset<T>::getOr(T & placeholder) {
+    return isReady() ? *m_value : placeholder;
+}
+
+//------------------------------------------------------------
+template<typename T>
+T const &
+Asset<T>::getOr(T const & placeholder) const {
+    return isReady() ? *m_value : placeholder;
+}
+
+//------------------------------------------------------------
+template<typename T>
+bool
+Asset<T>::wait() const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return isDone(); });
+    return isReady();
+}
+
+//------------------------------------------------------------
+template<typename T>
+void
+Asset<T>::finish(std::unique_ptr<T> value) {
+    // the value is in place before the state says so, readers polling isReady() never see it half made
+    m_value = std::move(value);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_state.store(m_value ? State::Ready : State::Failed, std::memory_order_release);
+    }
+    m_done.notify_all();
+}
+
+//------------------------------------------------------------
+template<typename T>
+AssetHandle<T>
+AssetLoader::load(std::function<std::unique_ptr<T>()> job) {
+    std::shared_ptr<Asset<T>> asset = std::make_shared<Asset<T>>();
+
+    m_pool.submit([asset, job] {
+        asset->finish(job());
+    });
+
+    return asset;
+}
+
+#endif /* AssetLoader_hpp */
@@ -1,4 +1,5 @@
 // std
+#include <cstring>
 #include <iostream>
 
 // my
@@ -10,6 +11,8 @@ Bitmap::Bitmap(int width, int height) :
 ,   m_height(height)
 ,   m_widthF(static_cast<float>(width))
 ,   m_heightF(static_cast<float>(height))
+,   m_externalPixels(nullptr)
+,   m_pitch(width * 4)
 {
     m_buffer.resize(width * height * 4);
     clear();
@@ -18,7 +21,7 @@ Bitmap::Bitmap(int width, int height) :
 //------------------------------------------------------------
 unsigned char &
 Bitmap::operator[] (int index) {
-    return m_buffer[index];
+    return getPixels()[index];
 }
 
 //------------------------------------------------------------
@@ -54,28 +57,49 @@ Bitmap::getBuffer() {
 //------------------------------------------------------------
 void 
 Bitmap::setPixel(int x, int y, unsigned char b, unsigned char g, unsigned char r) {
-    int index = (m_width * (m_height - y) + x) * 4;
+    unsigned char * pixel = getPixels() + (m_height - 1 - y) * m_pitch + x * 4;
 
-    m_buffer[index + 0] = b;
-    m_buffer[index + 1] = g;
-    m_buffer[index + 2] = r;
-    m_buffer[index + 3] = 255;
+    pixel[0] = b;
+    pixel[1] = g;
+    pixel[2] = r;
+    pixel[3] = 255;
+
+    if(m_dirtyRegion.isEnabled()) {
+        m_dirtyRegion.markPixel(x, m_height - 1 - y);
+    }
 }
 
 //------------------------------------------------------------
 djc_math::Vec3f
 Bitmap::getPixel(int x, int y) {
-    int index = (m_width * (m_height - y) + x) * 4;
+    unsigned char const * pixel = getPixels() + (m_height - 1 - y) * m_pitch + x * 4;
 
-    return djc_math::Vec3f((float)m_buffer[index + 2] / 255.0f,  // r
-                           (float)m_buffer[index + 1] / 255.0f,  // g
-                           (float)m_buffer[index + 0] / 255.0f); // b
+    return djc_math::Vec3f((float)pixel[2] / 255.0f,  // r
+                           (float)pixel[1] / 255.0f,  // g
+                           (float)pixel[0] / 255.0f); // b
 }
 
 //------------------------------------------------------------
 void 
 Bitmap::clear() {
-   std::fill(std::begin(m_buffer), std::end(m_buffer), 0);
+    if(m_dirtyRegion.isEnabled()) {
+        // everything else is still clear from last time
+        unsigned char * pixels = getPixels();
+        m_dirtyRegion.clearTouched([this, pixels](int xStart, int xEnd, int row) {
+            std::memset(pixels + row * m_pitch + xStart * 4, 0, (xEnd - xStart) * 4);
+        });
+        return;
+    }
+
+    if(m_externalPixels == nullptr) {
+        std::fill(std::begin(m_buffer), std::end(m_buffer), 0);
+        return;
+    }
+
+    // external rows can be padded, only clear the visible part
+    for(int y = 0; y < m_height; y++) {
+        std::memset(m_externalPixels + y * m_pitch, 0, m_width * 4);
+    }
 }
 
 //------------------------------------------------------------
@@ -86,5 +110,49 @@ Bitmap::resize(int width, int height) {
     m_widthF  = static_cast<float>(width);
     m_heightF = static_cast<float>(height);
     m_buffer.resize(width * height * 4);
+    m_externalPixels = nullptr;
+    m_pitch = width * 4;
+
+    if(m_dirtyRegion.isEnabled()) {
+        m_dirtyRegion.resize(width, height);
+    }
     clear();
+}
+
+//------------------------------------------------------------
+void
+Bitmap::bindExternalMemory(unsigned char * pixels, int pitch) {
+    m_externalPixels = pixels;
+    m_pitch = pitch;
+}
+
+//------------------------------------------------------------
+void
+Bitmap::releaseExternalMemory() {
+    m_externalPixels = nullptr;
+    m_pitch = m_width * 4;
+}
+
+//------------------------------------------------------------
+bool
+Bitmap::hasExternalMemory() const {
+    return m_externalPixels != nullptr;
+}
+
+//------------------------------------------------------------
+void
+Bitmap::enableDirtyTracking(bool enable) {
+    m_dirtyRegion.setEnabled(enable, m_width, m_height);
+}
+
+//------------------------------------------------------------
+bool
+Bitmap::isDirtyTracking() const {
+    return m_dirtyRegion.isEnabled();
+}
+
+//------------------------------------------------------------
+DirtyRegion &
+Bitmap::getDirtyRegion() {
+    return m_dirtyRegion;
 }
\ No newline at end of file
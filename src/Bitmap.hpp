@@ -2,6 +2,7 @@
 #define Bitmap_hpp
 
 // my
+#include "DirtyRegion.hpp"
 #include "djc_math/Utils.hpp"
 #include "djc_math/Vec3.hpp"
 // std
@@ -23,6 +24,41 @@ public:
     float getHeightF() const;
 
     Buffer & getBuffer();
+
+    /*
+        getPixels() / getPitch()
+
+        - the memory that is actually drawn to, either the bitmap's own buffer or bound external memory
+        - pitch is the number of bytes between the start of two rows
+        - prefer these over getBuffer() when reading or writing pixels
+    */
+    unsigned char * getPixels();
+    int getPitch() const;
+
+    /*
+        bindExternalMemory(...)
+
+        - draws straight into memory owned by someone else, e.g. a locked streaming texture
+        - the memory must hold height rows of pitch bytes and stay valid until released
+        - resize() releases the binding
+    */
+    void bindExternalMemory(unsigned char * pixels, int pitch);
+    void releaseExternalMemory();
+    bool hasExternalMemory() const;
+
+    /*
+        enableDirtyTracking(...)
+
+        - records which tiles are written so a present only needs to upload those
+        - clear() then only clears the tiles drawn to since the last clear
+        - anything that writes pixels without setPixel must call markDirty
+    */
+    void enableDirtyTracking(bool enable);
+    bool isDirtyTracking() const;
+    DirtyRegion & getDirtyRegion();
+
+    // y is in bitmap space like setPixel, xEnd is one past the last pixel
+    void markDirty(int xStart, int xEnd, int y);
     
     void setPixel(int x, int y, unsigned char b, unsigned char g, unsigned char r);
     djc_math::Vec3f getPixel(int x, int y);
@@ -39,8 +75,34 @@ protected:
     float m_widthF;
     float m_heightF;
     Buffer m_buffer;
+
+    // external memory, nullptr when drawing to m_buffer
+    unsigned char * m_externalPixels;
+    int m_pitch;
+
+    DirtyRegion m_dirtyRegion;
 };
 
+//------------------------------------------------------------
+inline unsigned char *
+Bitmap::getPixels() {
+    return m_externalPixels != nullptr ? m_externalPixels : m_buffer.data();
+}
+
+//------------------------------------------------------------
+inline int
+Bitmap::getPitch() const {
+    return m_pitch;
+}
+
+//------------------------------------------------------------
+inline void
+Bitmap::markDirty(int xStart, int xEnd, int y) {
+    if(m_dirtyRegion.isEnabled() && y >= 0 && y < m_height) {
+        m_dirtyRegion.markSpan(xStart < 0 ? 0 : xStart, xEnd > m_width ? m_width : xEnd, m_height - 1 - y);
+    }
+}
+
 inline Bitmap
 createRandomBitmap(int width, int height) {
     Bitmap bMap(width, height);
@@ -0,0 +1,92 @@
+// std
+#include <algorithm>
+#include <cmath>
+
+// my
+#include "Bounds.hpp"
+
+//------------------------------------------------------------
+djc_math::Vec3f
+AABB::getCentre() const {
+    return (min + max) * 0.5f;
+}
+
+//------------------------------------------------------------
+djc_math::Vec3f
+AABB::getExtents() const {
+    return (max - min) * 0.5f;
+}
+
+//------------------------------------------------------------
+bool
+Bounds::empty() const {
+    return sphere.radius < 0.0f;
+}
+
+//------------------------------------------------------------
+Bounds
+computeBounds(std::vector<Vertex> const & vertices) {
+    Bounds bounds;
+
+    if(vertices.empty()) {
+        bounds.box.min = djc_math::Vec3f(0.0f);
+        bounds.box.max = djc_math::Vec3f(0.0f);
+        bounds.sphere.centre = djc_math::Vec3f(0.0f);
+        bounds.sphere.radius = -1.0f;
+        return bounds;
+    }
+
+    djc_math::Vec3f min(vertices[0].position.x, vertices[0].position.y, vertices[0].position.z);
+    djc_math::Vec3f max(min);
+
+    for(auto const & vertex : vertices) {
+        min.x = std::min(min.x, vertex.position.x);
+        min.y = std::min(min.y, vertex.position.y);
+        min.z = std::min(min.z, vertex.position.z);
+
+        max.x = std::max(max.x, vertex.position.x);
+        max.y = std::max(max.y, vertex.position.y);
+        max.z = std::max(max.z, vertex.position.z);
+    }
+
+    bounds.box.min = min;
+    bounds.box.max = max;
+
+    // centred on the box, the radius only has to reach the furthest vertex which is often well inside the corners
+    djc_math::Vec3f centre = bounds.box.getCentre();
+    float radius2 = 0.0f;
+
+    for(auto const & vertex : vertices) {
+        djc_math::Vec3f offset(vertex.position.x - centre.x, vertex.position.y - centre.y, vertex.position.z - centre.z);
+        radius2 = std::max(radius2, offset.length2());
+    }
+
+    bounds.sphere.centre = centre;
+    bounds.sphere.radius = std::sqrt(radius2);
+    return bounds;
+}
+
+//------------------------------------------------------------
+Bounds
+mergeBounds(Bounds const & lhs, Bounds const & rhs) {
+    if(lhs.empty()) {
+        return rhs;
+    }
+
+    if(rhs.empty()) {
+        return lhs;
+    }
+
+    Bounds bounds;
+    bounds.box.min = djc_math::Vec3f(std::min(lhs.box.min.x, rhs.box.min.x), std::min(lhs.box.min.y, rhs.box.min.y), std::min(lhs.box.min.z, rhs.box.min.z));
+    bounds.box.max = djc_math::Vec3f(std::max(lhs.box.max.x, rhs.box.max.x), std::max(lhs.box.max.y, rhs.box.max.y), std::max(lhs.box.max.z, rhs.box.max.z));
+
+    // whichever is smaller of the box's half diagonal and the sphere that reaches both child spheres
+    djc_math::Vec3f centre = bounds.box.getCentre();
+    float toLhs = (lhs.sphere.centre - centre).length() + lhs.sphere.radius;
+    float toRhs = (rhs.sphere.centre - centre).length() + rhs.sphere.radius;
+
+    bounds.sphere.centre = centre;
+    bounds.sphere.radius = std::min(bounds.box.getExtents().length(), std::max(toLhs, toRhs));
+    return bounds;
+}
@@ -0,0 +1,50 @@
+#ifndef Bounds_hpp
+#define Bounds_hpp
+
+// std
+#include <vector>
+
+// my
+#include "Vertex.hpp"
+#include "djc_math/Vec3.hpp"
+
+// axis aligned box in the space the vertices were given in
+struct AABB {
+    djc_math::Vec3f min;
+    djc_math::Vec3f max;
+
+    djc_math::Vec3f getCentre() const;
+    djc_math::Vec3f getExtents() const; // half the size along each axis
+};
+
+struct BoundingSphere {
+    djc_math::Vec3f centre;
+    float radius;
+};
+
+/*
+    Bounds
+
+    - both volumes of one set of vertices, the sphere is centred on the box
+    - the sphere gives the cheap accept / reject, the box the tighter one
+    - empty() is true for bounds built from no vertices, they are never visible
+*/
+struct Bounds {
+    AABB box;
+    BoundingSphere sphere;
+
+    bool empty() const;
+};
+
+/*
+    computeBounds(...)
+
+    - one pass over the positions for the box, a second for the sphere radius
+    - call once when a mesh is loaded, not per frame
+*/
+Bounds computeBounds(std::vector<Vertex> const & vertices);
+
+// bounds enclosing both, either may be empty
+Bounds mergeBounds(Bounds const & lhs, Bounds const & rhs);
+
+#endif /* Bounds_hpp */
@@ -19,7 +19,7 @@ public:
         // empty
     }
 
-    djc_math::Mat4f getViewMatrix() {
+    djc_math::Mat4x3f getViewMatrix() {
 
         //m_viewDirection =  djc_math::rotate(-0.001f, m_up) * m_viewDirection;
         
@@ -65,7 +65,7 @@ public:
 
 private:
     djc_math::Mat4f m_projection;
-    djc_math::Mat4f m_view;
+    djc_math::Mat4x3f m_view;
     djc_math::Vec3f m_viewDirection;
     djc_math::Vec3f m_up;
     djc_math::Vec3f m_position;
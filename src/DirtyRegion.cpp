@@ -0,0 +1,115 @@
+// std
+#include <algorithm>
+
+// my
+#include "DirtyRegion.hpp"
+
+//------------------------------------------------------------
+DirtyRegion::DirtyRegion() :
+    m_enabled(false)
+,   m_width(0)
+,   m_height(0)
+,   m_tilesX(0)
+,   m_tilesY(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+void
+DirtyRegion::setEnabled(bool enabled, int width, int height) {
+    m_enabled = enabled;
+
+    if(m_enabled) {
+        resize(width, height);
+    } else {
+        m_touched.clear();
+        m_upload.clear();
+    }
+}
+
+//------------------------------------------------------------
+bool
+DirtyRegion::isEnabled() const {
+    return m_enabled;
+}
+
+//------------------------------------------------------------
+void
+DirtyRegion::resize(int width, int height) {
+    m_width  = width;
+    m_height = height;
+    m_tilesX = (width  + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+    m_tilesY = (height + DIRTY_TILE_SIZE - 1) / DIRTY_TILE_SIZE;
+
+    // the destination has never seen this content
+    m_touched.assign(m_tilesX * m_tilesY, 1);
+    m_upload.assign(m_tilesX * m_tilesY, 1);
+}
+
+//------------------------------------------------------------
+void
+DirtyRegion::markAll() {
+    std::fill(std::begin(m_touched), std::end(m_touched), 1);
+    std::fill(std::begin(m_upload), std::end(m_upload), 1);
+}
+
+//------------------------------------------------------------
+void
+DirtyRegion::buildUploadRects(std::vector<DirtyRect> & rects) const {
+    rects.clear();
+
+    // rects that ended on the previous tile row and can still grow downwards
+    size_t openBegin = 0;
+
+    for(int tileY = 0; tileY < m_tilesY; tileY++) {
+        int y = tileY * DIRTY_TILE_SIZE;
+        int height = std::min(DIRTY_TILE_SIZE, m_height - y);
+        size_t rowBegin = rects.size();
+
+        int tileX = 0;
+        while(tileX < m_tilesX) {
+            if(!m_upload[tileY * m_tilesX + tileX]) {
+                tileX++;
+                continue;
+            }
+
+            int runStart = tileX;
+            while(tileX < m_tilesX && m_upload[tileY * m_tilesX + tileX]) {
+                tileX++;
+            }
+
+            int x = runStart * DIRTY_TILE_SIZE;
+            int width = std::min(tileX * DIRTY_TILE_SIZE, m_width) - x;
+
+            // extend a rect from the row above with exactly the same span
+            bool merged = false;
+            for(size_t i = openBegin; i < rowBegin; i++) {
+                DirtyRect & open = rects[i];
+                if(open.x == x && open.width == width && open.y + open.height == y) {
+                    open.height += height;
+                    merged = true;
+                    break;
+                }
+            }
+
+            if(!merged) {
+                rects.push_back(DirtyRect{ x, y, width, height });
+            }
+        }
+
+        // anything not extended on this row is closed, keep the order stable and move on
+        std::stable_partition(rects.begin() + openBegin, rects.end(), [y, height](DirtyRect const & rect) {
+            return rect.y + rect.height != y + height;
+        });
+        openBegin = std::partition_point(rects.begin() + openBegin, rects.end(), [y, height](DirtyRect const & rect) {
+            return rect.y + rect.height != y + height;
+        }) - rects.begin();
+    }
+}
+
+//------------------------------------------------------------
+void
+DirtyRegion::resetUpload() {
+    std::fill(std::begin(m_upload), std::end(m_upload), 0);
+}
@@ -0,0 +1,123 @@
+#ifndef DirtyRegion_hpp
+#define DirtyRegion_hpp
+
+// std
+#include <cstdint>
+#include <vector>
+
+// my defines
+#define DIRTY_TILE_SIZE 32
+
+// rows are in memory order, row 0 is the top of the image
+struct DirtyRect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+/*
+    DirtyRegion
+
+    - tracks which DIRTY_TILE_SIZE tiles of a bitmap were written, at tile granularity
+    - touched tiles are the ones drawn to since the last clear, only those need clearing
+    - upload tiles are the ones changed since the last present, drawn to or cleared
+*/
+class DirtyRegion final {
+public:
+    DirtyRegion();
+    ~DirtyRegion() = default;
+
+    void setEnabled(bool enabled, int width, int height);
+    bool isEnabled() const;
+
+    void resize(int width, int height);
+
+    // row is in memory order, xEnd is one past the last pixel
+    void markSpan(int xStart, int xEnd, int row);
+    void markPixel(int x, int row);
+    void markAll();
+
+    /*
+        clearTouched(...)
+
+        - calls function(xStart, xEnd, row) for every run of touched tiles, one call per pixel row
+        - moves the touched tiles into the upload set, they change when cleared
+    */
+    template<typename Function>
+    void clearTouched(Function function);
+
+    /*
+        buildUploadRects(...)
+
+        - merges the upload tiles into as few rects as it cheaply can, clipped to the bitmap
+        - horizontal runs of tiles become one rect, identical runs on consecutive tile rows are merged
+    */
+    void buildUploadRects(std::vector<DirtyRect> & rects) const;
+    void resetUpload();
+
+private:
+    bool m_enabled;
+    int m_width;
+    int m_height;
+    int m_tilesX;
+    int m_tilesY;
+    std::vector<uint8_t> m_touched;
+    std::vector<uint8_t> m_upload;
+};
+
+//------------------------------------------------------------
+inline void
+DirtyRegion::markSpan(int xStart, int xEnd, int row) {
+    if(xEnd <= xStart) {
+        return;
+    }
+
+    int tileRow = (row / DIRTY_TILE_SIZE) * m_tilesX;
+    int tileEnd = tileRow + (xEnd - 1) / DIRTY_TILE_SIZE;
+    for(int tile = tileRow + xStart / DIRTY_TILE_SIZE; tile <= tileEnd; tile++) {
+        m_touched[tile] = 1;
+        m_upload[tile] = 1;
+    }
+}
+
+//------------------------------------------------------------
+inline void
+DirtyRegion::markPixel(int x, int row) {
+    int tile = (row / DIRTY_TILE_SIZE) * m_tilesX + x / DIRTY_TILE_SIZE;
+    m_touched[tile] = 1;
+    m_upload[tile] = 1;
+}
+
+//------------------------------------------------------------
+template<typename Function> void
+DirtyRegion::clearTouched(Function function) {
+    for(int tileY = 0; tileY < m_tilesY; tileY++) {
+        int rowStart = tileY * DIRTY_TILE_SIZE;
+        int rowEnd = rowStart + DIRTY_TILE_SIZE < m_height ? rowStart + DIRTY_TILE_SIZE : m_height;
+
+        int tileX = 0;
+        while(tileX < m_tilesX) {
+            int index = tileY * m_tilesX + tileX;
+            if(!m_touched[index]) {
+                tileX++;
+                continue;
+            }
+
+            int runStart = tileX;
+            while(tileX < m_tilesX && m_touched[tileY * m_tilesX + tileX]) {
+                m_touched[tileY * m_tilesX + tileX] = 0;
+                m_upload[tileY * m_tilesX + tileX] = 1;
+                tileX++;
+            }
+
+            int xStart = runStart * DIRTY_TILE_SIZE;
+            int xEnd = tileX * DIRTY_TILE_SIZE < m_width ? tileX * DIRTY_TILE_SIZE : m_width;
+            for(int row = rowStart; row < rowEnd; row++) {
+                function(xStart, xEnd, row);
+            }
+        }
+    }
+}
+
+#endif /* DirtyRegion_hpp */
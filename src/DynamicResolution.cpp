@@ -0,0 +1,144 @@
+// std
+#include <algorithm>
+#include <cmath>
+
+// my
+#include "DynamicResolution.hpp"
+
+namespace {
+    const float AVERAGE_WEIGHT   = 0.2f;  // weight of the newest sample in the moving average
+    const int   SETTLE_FRAMES    = 8;     // frames to wait after a change before deciding again
+    const float HEADROOM         = 0.9f;  // aim a little under the budget so small spikes still fit
+    const float RAISE_THRESHOLD  = 0.75f; // only scale up when comfortably under budget
+    const float MAX_RAISE_STEP   = 0.05f; // per decision, going up slowly avoids oscillating
+    const int   SIZE_GRANULARITY = 8;     // widths snap to multiples of this
+    const float MAX_SAMPLE_SCALE = 4.0f;  // samples are capped at this many times the target
+    const int   OVERLOAD_FRAMES  = 3;     // consecutive frames over budget before dropping, ignores single hitches
+}
+
+//------------------------------------------------------------
+DynamicResolution::DynamicResolution(int maxWidth, int maxHeight, float targetFrameMs) :
+    m_maxWidth(maxWidth)
+,   m_maxHeight(maxHeight)
+,   m_targetFrameMs(targetFrameMs)
+,   m_minScale(0.5f)
+,   m_maxScale(1.0f)
+,   m_scale(1.0f)
+,   m_averageFrameMs(-1.0f)
+,   m_framesSinceChange(0)
+,   m_framesOverBudget(0)
+,   m_width(maxWidth)
+,   m_height(maxHeight)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+bool
+DynamicResolution::update(float frameMs) {
+    // the first frame at a new size also pays for the resize (and the first one ever for loading)
+    if(m_framesSinceChange++ == 0) {
+        return false;
+    }
+
+    // one long hitch should not throw away most of the resolution
+    frameMs = std::min(frameMs, m_targetFrameMs * MAX_SAMPLE_SCALE);
+    m_framesOverBudget = frameMs > m_targetFrameMs ? m_framesOverBudget + 1 : 0;
+
+    if(m_averageFrameMs < 0.0f) {
+        m_averageFrameMs = frameMs;
+    } else {
+        m_averageFrameMs += (frameMs - m_averageFrameMs) * AVERAGE_WEIGHT;
+    }
+
+    if(m_framesSinceChange < SETTLE_FRAMES || m_averageFrameMs <= 0.0f) {
+        return false;
+    }
+
+    // cost is roughly proportional to pixel count, so the scale that fits the budget goes with the square root
+    float budget = m_targetFrameMs * HEADROOM;
+    float wanted = m_scale * std::sqrt(budget / m_averageFrameMs);
+
+    if(m_averageFrameMs > m_targetFrameMs && m_framesOverBudget >= OVERLOAD_FRAMES) {
+        m_scale = wanted;
+    } else if(m_averageFrameMs < m_targetFrameMs * RAISE_THRESHOLD) {
+        m_scale = std::min(wanted, m_scale + MAX_RAISE_STEP);
+    } else {
+        return false;
+    }
+
+    m_scale = std::max(m_minScale, std::min(m_scale, m_maxScale));
+
+    if(!updateSize()) {
+        return false;
+    }
+
+    // samples taken at the old size say little about the new one
+    m_framesSinceChange = 0;
+    m_framesOverBudget = 0;
+    m_averageFrameMs = -1.0f;
+    return true;
+}
+
+//------------------------------------------------------------
+void
+DynamicResolution::setTargetFrameMs(float targetFrameMs) {
+    m_targetFrameMs = targetFrameMs;
+}
+
+//------------------------------------------------------------
+void
+DynamicResolution::setScaleRange(float minScale, float maxScale) {
+    m_minScale = std::max(0.0f, std::min(minScale, maxScale));
+    m_maxScale = std::min(1.0f, maxScale);
+    m_scale = std::max(m_minScale, std::min(m_scale, m_maxScale));
+    updateSize();
+}
+
+//------------------------------------------------------------
+float
+DynamicResolution::getScale() const {
+    return m_scale;
+}
+
+//------------------------------------------------------------
+int
+DynamicResolution::getWidth() const {
+    return m_width;
+}
+
+//------------------------------------------------------------
+int
+DynamicResolution::getHeight() const {
+    return m_height;
+}
+
+//------------------------------------------------------------
+float
+DynamicResolution::getAverageFrameMs() const {
+    return m_averageFrameMs;
+}
+
+/* PRIVATE */
+
+//------------------------------------------------------------
+bool
+DynamicResolution::updateSize() {
+    int width = m_maxWidth;
+
+    if(m_scale < 1.0f) {
+        width = static_cast<int>(m_maxWidth * m_scale / SIZE_GRANULARITY + 0.5f) * SIZE_GRANULARITY;
+        width = std::max(SIZE_GRANULARITY, std::min(width, m_maxWidth));
+    }
+
+    // keep the aspect ratio of the full size so the projection does not need to change
+    int height = std::max(1, static_cast<int>(static_cast<float>(width) * m_maxHeight / m_maxWidth + 0.5f));
+
+    if(width == m_width && height == m_height) {
+        return false;
+    }
+
+    m_width  = width;
+    m_height = height;
+    return true;
+}
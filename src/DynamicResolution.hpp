@@ -0,0 +1,52 @@
+#ifndef DynamicResolution_hpp
+#define DynamicResolution_hpp
+
+/*
+    DynamicResolution
+
+    - picks an internal render size from measured frame times against a target budget
+    - scale is per axis, so the pixel count (and roughly the cost) goes with scale * scale
+    - drops resolution straight away when over budget, climbs back slowly when under it
+    - no SDL, the owner resizes its render context when update() returns true
+*/
+class DynamicResolution final {
+public:
+    DynamicResolution(int maxWidth, int maxHeight, float targetFrameMs);
+
+    /*
+        update(...)
+
+        - frameMs should be the time spent rendering, not the time blocked on vsync
+        - returns true when getWidth() / getHeight() changed
+    */
+    bool update(float frameMs);
+
+    void setTargetFrameMs(float targetFrameMs);
+    void setScaleRange(float minScale, float maxScale);
+
+    float getScale() const;
+    int getWidth() const;
+    int getHeight() const;
+    float getAverageFrameMs() const;
+
+private:
+    // works out m_width / m_height from m_scale, returns true if either changed
+    bool updateSize();
+
+private:
+    int m_maxWidth;
+    int m_maxHeight;
+    float m_targetFrameMs;
+
+    float m_minScale;
+    float m_maxScale;
+    float m_scale;
+
+    float m_averageFrameMs;      // exponential moving average, < 0 until the first sample
+    int   m_framesSinceChange;   // lets the average settle at a new size before deciding again
+    int   m_framesOverBudget;    // consecutive samples over the target
+
+    int m_width;
+    int m_height;
+};
+#endif /* DynamicResolution_hpp */
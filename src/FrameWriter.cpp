@@ -0,0 +1,297 @@
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// my
+#include "FrameWriter.hpp"
+#include "ImageIO.hpp"
+
+namespace {
+    using clock = std::chrono::high_resolution_clock;
+    using FpMilliseconds = std::chrono::duration<double, std::milli>;
+}
+
+//------------------------------------------------------------
+FrameWriter::FrameWriter(std::string const & path, Format format, int width, int height, int bufferCount, FullPolicy policy, int framesPerSecond) :
+    m_path(path)
+,   m_format(format)
+,   m_policy(policy)
+,   m_width(width)
+,   m_height(height)
+,   m_file(nullptr)
+,   m_ownsFile(false)
+,   m_head(0)
+,   m_tail(0)
+,   m_queued(0)
+,   m_quit(false)
+{
+    // one allocation per slot, up front
+    m_ring.resize(std::max(bufferCount, 1));
+    for(auto & frame : m_ring) {
+        frame.resize(static_cast<size_t>(width) * height * 4);
+    }
+
+    if(m_format == Format::Y4M) {
+        int chromaWidth  = (width + 1) / 2;
+        int chromaHeight = (height + 1) / 2;
+        m_scratch.resize(static_cast<size_t>(width) * height + static_cast<size_t>(chromaWidth) * chromaHeight * 2);
+    } else if(m_format == Format::RawRGBA) {
+        m_scratch.resize(static_cast<size_t>(width) * 4);
+    }
+
+    if(m_format != Format::PPMSequence) {
+        if(m_path == "-") {
+            m_file = stdout;
+        } else {
+            m_file = std::fopen(m_path.c_str(), "wb");
+            m_ownsFile = true;
+        }
+
+        if(m_file == nullptr) {
+            std::cerr << "FrameWriter could not open " << m_path << std::endl;
+            m_stats.writeFailed = true;
+            return;
+        }
+
+        if(m_format == Format::Y4M) {
+            std::fprintf(m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, framesPerSecond);
+        }
+    }
+
+    m_thread = std::thread(&FrameWriter::writerLoop, this);
+}
+
+//------------------------------------------------------------
+FrameWriter::~FrameWriter() {
+    if(m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+        m_frameReady.notify_one();
+        m_thread.join();
+    }
+
+    if(m_file != nullptr) {
+        std::fflush(m_file);
+        if(m_ownsFile) {
+            std::fclose(m_file);
+        }
+    }
+}
+
+//------------------------------------------------------------
+bool
+FrameWriter::submit(unsigned char const * pixels, int pitch) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if(m_stats.writeFailed) {
+        return false;
+    }
+
+    m_stats.submitted++;
+
+    if(m_queued == m_ring.size()) {
+        if(m_policy == FullPolicy::Drop) {
+            m_stats.dropped++;
+            return false;
+        }
+
+        auto begin = clock::now();
+        m_stats.blockedSubmits++;
+        m_slotFree.wait(lock, [this] { return m_queued < m_ring.size(); });
+        m_stats.blockedMs += FpMilliseconds(clock::now() - begin).count();
+    }
+
+    // only the producer touches the head slot, so the copy happens outside the lock
+    auto & frame = m_ring[m_head];
+    lock.unlock();
+
+    size_t rowSize = static_cast<size_t>(m_width) * 4;
+    if(static_cast<size_t>(pitch) == rowSize) {
+        std::memcpy(frame.data(), pixels, rowSize * m_height);
+    } else {
+        for(int y = 0; y < m_height; y++) {
+            std::memcpy(frame.data() + y * rowSize, pixels + static_cast<size_t>(y) * pitch, rowSize);
+        }
+    }
+
+    lock.lock();
+    m_head = (m_head + 1) % m_ring.size();
+    m_queued++;
+    m_stats.maxQueued = std::max(m_stats.maxQueued, static_cast<int>(m_queued));
+    lock.unlock();
+
+    m_frameReady.notify_one();
+    return true;
+}
+
+//------------------------------------------------------------
+void
+FrameWriter::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_slotFree.wait(lock, [this] { return m_queued == 0 || m_stats.writeFailed; });
+    
+    if(m_file != nullptr) {
+        std::fflush(m_file);
+    }
+}
+
+//------------------------------------------------------------
+FrameWriter::Stats
+FrameWriter::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+//------------------------------------------------------------
+bool
+FrameWriter::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_stats.writeFailed;
+}
+
+/* PRIVATE */
+
+//------------------------------------------------------------
+void
+FrameWriter::writerLoop() {
+    uint64_t frameNumber = 0;
+
+    while(true) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_frameReady.wait(lock, [this] { return m_queued > 0 || m_quit; });
+
+        if(m_queued == 0) {
+            return; // quit and nothing left to write
+        }
+
+        // only the writer touches the tail slot, so the write happens outside the lock
+        auto const & frame = m_ring[m_tail];
+        lock.unlock();
+
+        auto begin = clock::now();
+        bool ok = writeFrame(frame, frameNumber++);
+        double elapsed = FpMilliseconds(clock::now() - begin).count();
+
+        lock.lock();
+        m_tail = (m_tail + 1) % m_ring.size();
+        m_queued--;
+        m_stats.writeMs += elapsed;
+        if(ok) {
+            m_stats.written++;
+        } else {
+            m_stats.writeFailed = true;
+        }
+        lock.unlock();
+
+        m_slotFree.notify_all();
+    }
+}
+
+//------------------------------------------------------------
+bool
+FrameWriter::writeFrame(std::vector<unsigned char> const & frame, uint64_t frameNumber) {
+    switch(m_format) {
+        case Format::RawRGBA:     return writeRawRGBA(frame);
+        case Format::PPMSequence: return writePPM(frame, frameNumber);
+        case Format::Y4M:         return writeY4M(frame);
+    }
+    return false;
+}
+
+//------------------------------------------------------------
+bool
+FrameWriter::writeRawRGBA(std::vector<unsigned char> const & frame) {
+    size_t rowSize = static_cast<size_t>(m_width) * 4;
+
+    for(int y = 0; y < m_height; y++) {
+        unsigned char const * src = frame.data() + y * rowSize;
+        unsigned char * dst = m_scratch.data();
+
+        for(int x = 0; x < m_width; x++) {
+            dst[0] = src[2];
+            dst[1] = src[1];
+            dst[2] = src[0];
+            dst[3] = src[3];
+            src += 4;
+            dst += 4;
+        }
+
+        if(std::fwrite(m_scratch.data(), 1, rowSize, m_file) != rowSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------
+bool
+FrameWriter::writePPM(std::vector<unsigned char> const & frame, uint64_t frameNumber) {
+    char fileName[32];
+    std::snprintf(fileName, sizeof(fileName), "%05llu.ppm", static_cast<unsigned long long>(frameNumber));
+
+    // the one ppm writer, frames are tightly packed so the pitch is a row of pixels
+    return ::writePPM(m_path + fileName, frame.data(), m_width, m_height, m_width * 4);
+}
+
+//------------------------------------------------------------
+bool
+FrameWriter::writeY4M(std::vector<unsigned char> const & frame) {
+    // full range bt.601 (jpeg), chroma averaged over 2x2 blocks
+    int chromaWidth  = (m_width + 1) / 2;
+    int chromaHeight = (m_height + 1) / 2;
+
+    unsigned char * yPlane = m_scratch.data();
+    unsigned char * uPlane = yPlane + static_cast<size_t>(m_width) * m_height;
+    unsigned char * vPlane = uPlane + static_cast<size_t>(chromaWidth) * chromaHeight;
+
+    auto clampByte = [](float value) -> unsigned char {
+        return static_cast<unsigned char>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+    };
+
+    for(int y = 0; y < m_height; y++) {
+        unsigned char const * src = frame.data() + static_cast<size_t>(y) * m_width * 4;
+        for(int x = 0; x < m_width; x++) {
+            float b = src[x * 4 + 0];
+            float g = src[x * 4 + 1];
+            float r = src[x * 4 + 2];
+            yPlane[y * m_width + x] = clampByte(0.299f * r + 0.587f * g + 0.114f * b);
+        }
+    }
+
+    for(int cy = 0; cy < chromaHeight; cy++) {
+        for(int cx = 0; cx < chromaWidth; cx++) {
+            float r = 0.0f;
+            float g = 0.0f;
+            float b = 0.0f;
+            int samples = 0;
+
+            for(int y = cy * 2; y < std::min(cy * 2 + 2, m_height); y++) {
+                for(int x = cx * 2; x < std::min(cx * 2 + 2, m_width); x++) {
+                    unsigned char const * src = frame.data() + (static_cast<size_t>(y) * m_width + x) * 4;
+                    b += src[0];
+                    g += src[1];
+                    r += src[2];
+                    samples++;
+                }
+            }
+
+            r /= samples;
+            g /= samples;
+            b /= samples;
+
+            uPlane[cy * chromaWidth + cx] = clampByte(-0.168736f * r - 0.331264f * g + 0.5f      * b + 128.0f);
+            vPlane[cy * chromaWidth + cx] = clampByte( 0.5f      * r - 0.418688f * g - 0.081312f * b + 128.0f);
+        }
+    }
+
+    static char const frameHeader[] = "FRAME\n";
+    if(std::fwrite(frameHeader, 1, sizeof(frameHeader) - 1, m_file) != sizeof(frameHeader) - 1) {
+        return false;
+    }
+
+    return std::fwrite(m_scratch.data(), 1, m_scratch.size(), m_file) == m_scratch.size();
+}
@@ -0,0 +1,112 @@
+#ifndef FrameWriter_hpp
+#define FrameWriter_hpp
+
+// std
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    FrameWriter
+
+    - records frames on a background thread so the render loop never waits on encoding or disk
+    - frames are copied into a ring of preallocated buffers, nothing is allocated per frame
+    - when every buffer is waiting to be written submit() either blocks or drops the frame
+*/
+class FrameWriter final {
+public:
+    enum class Format {
+        RawRGBA,     // every frame appended to one file, 4 bytes per pixel r, g, b, a
+        PPMSequence, // one binary ppm per frame, <path><frameNumber>.ppm
+        Y4M          // yuv4mpeg2 420jpeg stream, use "-" as the path for stdout
+    };
+
+    enum class FullPolicy {
+        Block, // wait for the writer, no frame is lost
+        Drop   // skip the frame, the render loop is never held up
+    };
+
+    // back-pressure statistics, read with getStats()
+    struct Stats {
+        uint64_t submitted      = 0;
+        uint64_t written        = 0;
+        uint64_t dropped        = 0;
+        uint64_t blockedSubmits = 0; // submits that had to wait for a free buffer
+        double   blockedMs      = 0.0;
+        double   writeMs        = 0.0;
+        int      maxQueued      = 0;
+        bool     writeFailed    = false;
+    };
+
+public:
+    /*
+        FrameWriter(...)
+
+        - path is a file for RawRGBA and Y4M ("-" is stdout) and a path prefix for PPMSequence
+        - bufferCount is the number of frames that can be queued, 2 is double buffering
+        - framesPerSecond only goes into the y4m header
+    */
+    FrameWriter(std::string const & path, Format format, int width, int height, int bufferCount = 3, FullPolicy policy = FullPolicy::Block, int framesPerSecond = 60);
+    FrameWriter(FrameWriter const &) = delete;
+    FrameWriter & operator = (FrameWriter const &) = delete;
+    ~FrameWriter();
+
+    /*
+        submit(...)
+
+        - pixels are in the Bitmap layout: b, g, r, a with the top row first
+        - only call from one thread, the render loop
+        - returns false if the frame was dropped or the writer has failed
+    */
+    bool submit(unsigned char const * pixels, int pitch);
+
+    /*
+        flush()
+
+        - blocks until every submitted frame has been written
+    */
+    void flush();
+
+    Stats getStats() const;
+    bool isOpen() const;
+
+private:
+    void writerLoop();
+    bool writeFrame(std::vector<unsigned char> const & frame, uint64_t frameNumber);
+
+    bool writeRawRGBA(std::vector<unsigned char> const & frame);
+    bool writePPM(std::vector<unsigned char> const & frame, uint64_t frameNumber);
+    bool writeY4M(std::vector<unsigned char> const & frame);
+
+private:
+    std::string m_path;
+    Format      m_format;
+    FullPolicy  m_policy;
+    int         m_width;
+    int         m_height;
+
+    FILE *      m_file;
+    bool        m_ownsFile;
+
+    // ring of frames, m_head is the next free slot, m_tail the next to be written
+    std::vector<std::vector<unsigned char>> m_ring;
+    size_t m_head;
+    size_t m_tail;
+    size_t m_queued;
+    bool   m_quit;
+
+    // conversion scratch owned by the writer thread
+    std::vector<unsigned char> m_scratch;
+
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_frameReady;
+    std::condition_variable m_slotFree;
+    Stats                   m_stats;
+
+    std::thread m_thread;
+};
+#endif /* FrameWriter_hpp */
@@ -0,0 +1,190 @@
+// std
+#include <cmath>
+
+// my
+#include "Frustum.hpp"
+#include "djc_math/djc_math.hpp"
+
+namespace {
+    // plane coefficients (a, b, c, d) scaled so (a, b, c) is unit length
+    Plane makePlane(djc_math::Vec4f const & coefficients) {
+        Plane plane;
+        plane.normal = djc_math::Vec3f(coefficients.x, coefficients.y, coefficients.z);
+        plane.distance = coefficients.w;
+
+        float length = plane.normal.length();
+        if(length > 0.0f) {
+            plane.normal /= length;
+            plane.distance /= length;
+        }
+        // a degenerate plane stays all zero, which everything is inside of
+
+        return plane;
+    }
+
+    // distance from the centre to the plane the box can reach
+    float projectedRadius(Plane const & plane, AABB const & box) {
+        djc_math::Vec3f extents = box.getExtents();
+        return std::fabs(plane.normal.x) * extents.x
+             + std::fabs(plane.normal.y) * extents.y
+             + std::fabs(plane.normal.z) * extents.z;
+    }
+}
+
+const unsigned int Frustum::ALL_PLANES;
+
+//------------------------------------------------------------
+float
+Plane::distanceTo(djc_math::Vec3f const & point) const {
+    return normal.dot(point) + distance;
+}
+
+//------------------------------------------------------------
+Frustum::Frustum() {
+    // empty planes, everything is visible until update(...) is called
+    for(auto & plane : m_planes) {
+        plane.normal = djc_math::Vec3f(0.0f);
+        plane.distance = 0.0f;
+    }
+}
+
+//------------------------------------------------------------
+Frustum::Frustum(djc_math::Mat4f const & viewProjection) {
+    update(viewProjection);
+}
+
+//------------------------------------------------------------
+void
+Frustum::update(djc_math::Mat4f const & viewProjection) {
+    // rows of the matrix, pulled out through the public api
+    djc_math::Mat4f transposed = djc_math::transpose(viewProjection);
+    djc_math::Vec4f row0 = transposed * djc_math::Vec4f(1.0f, 0.0f, 0.0f, 0.0f);
+    djc_math::Vec4f row1 = transposed * djc_math::Vec4f(0.0f, 1.0f, 0.0f, 0.0f);
+    djc_math::Vec4f row2 = transposed * djc_math::Vec4f(0.0f, 0.0f, 1.0f, 0.0f);
+    djc_math::Vec4f row3 = transposed * djc_math::Vec4f(0.0f, 0.0f, 0.0f, 1.0f);
+
+    // -w <= x <= w and so on, each side is one plane: w + x >= 0, w - x >= 0
+    m_planes[Left]   = makePlane(row3 + row0);
+    m_planes[Right]  = makePlane(row3 - row0);
+    m_planes[Bottom] = makePlane(row3 + row1);
+    m_planes[Top]    = makePlane(row3 - row1);
+    m_planes[Near]   = makePlane(row3 + row2);
+    m_planes[Far]    = makePlane(row3 - row2);
+}
+
+//------------------------------------------------------------
+Frustum::Visibility
+Frustum::classify(BoundingSphere const & sphere) const {
+    Visibility result = Visibility::Inside;
+
+    for(auto const & plane : m_planes) {
+        float distance = plane.distanceTo(sphere.centre);
+
+        if(distance < -sphere.radius) {
+            return Visibility::Outside;
+        }
+
+        if(distance < sphere.radius) {
+            result = Visibility::Intersecting;
+        }
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------
+Frustum::Visibility
+Frustum::classify(AABB const & box) const {
+    Visibility result = Visibility::Inside;
+    djc_math::Vec3f centre = box.getCentre();
+
+    for(auto const & plane : m_planes) {
+        float distance = plane.distanceTo(centre);
+        float radius = projectedRadius(plane, box);
+
+        if(distance < -radius) {
+            return Visibility::Outside;
+        }
+
+        if(distance < radius) {
+            result = Visibility::Intersecting;
+        }
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------
+Frustum::Visibility
+Frustum::classify(AABB const & box, unsigned int & planeMask) const {
+    djc_math::Vec3f centre = box.getCentre();
+
+    for(int i = 0; i < PlaneCount; i++) {
+        unsigned int bit = 1u << i;
+        if((planeMask & bit) == 0) {
+            continue;
+        }
+
+        Plane const & plane = m_planes[i];
+        float distance = plane.distanceTo(centre);
+        float radius = projectedRadius(plane, box);
+
+        if(distance < -radius) {
+            return Visibility::Outside;
+        }
+
+        if(distance >= radius) {
+            planeMask &= ~bit;
+        }
+    }
+
+    return planeMask == 0 ? Visibility::Inside : Visibility::Intersecting;
+}
+
+//------------------------------------------------------------
+Frustum::Visibility
+Frustum::classify(Bounds const & bounds) const {
+    if(bounds.empty()) {
+        return Visibility::Outside;
+    }
+
+    Visibility result = Visibility::Inside;
+    djc_math::Vec3f boxCentre = bounds.box.getCentre();
+
+    for(auto const & plane : m_planes) {
+        float distance = plane.distanceTo(bounds.sphere.centre);
+
+        if(distance < -bounds.sphere.radius) {
+            return Visibility::Outside;
+        }
+
+        if(distance >= bounds.sphere.radius) {
+            continue; // the sphere is entirely inside this plane so the box is too
+        }
+
+        float boxDistance = plane.distanceTo(boxCentre);
+        float boxRadius = projectedRadius(plane, bounds.box);
+
+        if(boxDistance < -boxRadius) {
+            return Visibility::Outside;
+        }
+
+        if(boxDistance < boxRadius) {
+            result = Visibility::Intersecting;
+        }
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------
+bool
+Frustum::isVisible(Bounds const & bounds) const {
+    return classify(bounds) != Visibility::Outside;
+}
+
+//------------------------------------------------------------
+Plane const &
+Frustum::getPlane(PlaneIndex index) const {
+    return m_planes[index];
+}
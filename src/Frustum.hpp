@@ -0,0 +1,84 @@
+#ifndef Frustum_hpp
+#define Frustum_hpp
+
+// std
+#include <array>
+
+// my
+#include "Bounds.hpp"
+#include "djc_math/Mat4.hpp"
+#include "djc_math/Vec3.hpp"
+
+// points with dot(normal, p) + distance >= 0 are on the inside, normal is unit length
+struct Plane {
+    djc_math::Vec3f normal;
+    float distance;
+
+    float distanceTo(djc_math::Vec3f const & point) const;
+};
+
+/*
+    Frustum
+
+    - the six clip planes of a view projection, in the space the matrix transforms from
+    - pass projection * view for world space bounds, or the full model view projection
+      to test a mesh's own bounds without transforming them
+    - planes follow the clip volume the rasterizer uses, -w <= x, y, z <= w
+*/
+class Frustum final {
+public:
+    enum PlaneIndex {
+        Left = 0,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount
+    };
+
+    static const unsigned int ALL_PLANES = (1u << PlaneCount) - 1;
+
+    // result of the box / sphere tests, Intersecting means it may be partly outside
+    enum class Visibility {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+public:
+    Frustum();
+    explicit Frustum(djc_math::Mat4f const & viewProjection);
+    ~Frustum() = default;
+
+    void update(djc_math::Mat4f const & viewProjection);
+
+    Visibility classify(BoundingSphere const & sphere) const;
+    Visibility classify(AABB const & box) const;
+
+    /*
+        classify(...)
+
+        - only tests the planes whose bit (1 << PlaneIndex) is set in planeMask
+        - clears the bit of every plane the box is entirely inside of, so a hierarchy
+          can pass the mask down and children skip planes their parent already passed
+    */
+    Visibility classify(AABB const & box, unsigned int & planeMask) const;
+
+    /*
+        classify(...)
+
+        - the sphere first, the box is only tested against the planes the sphere straddles
+        - empty bounds are always Outside
+    */
+    Visibility classify(Bounds const & bounds) const;
+
+    bool isVisible(Bounds const & bounds) const;
+
+    Plane const & getPlane(PlaneIndex index) const;
+
+private:
+    std::array<Plane, PlaneCount> m_planes;
+};
+
+#endif /* Frustum_hpp */
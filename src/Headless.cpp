@@ -0,0 +1,78 @@
+// std
+#include <cstdio>
+#include <iostream>
+#include <utility>
+
+// my
+#include "Headless.hpp"
+
+//------------------------------------------------------------
+Headless::Headless(int width, int height) :
+    m_width(width)
+,   m_height(height)
+,   m_rContext(width, height)
+,   m_writeImages(false)
+,   m_imageFormat(ImageFormat::PPM)
+,   m_frameCount(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+RenderContext &
+Headless::getRenderContext() {
+    return m_rContext;
+}
+
+//------------------------------------------------------------
+void
+Headless::writeImageSequence(std::string const & pathPrefix, ImageFormat format) {
+    m_writeImages = true;
+    m_pathPrefix  = pathPrefix;
+    m_imageFormat = format;
+}
+
+//------------------------------------------------------------
+void
+Headless::stopImageSequence() {
+    m_writeImages = false;
+}
+
+//------------------------------------------------------------
+void
+Headless::setFrameCallback(FrameCallback callback) {
+    m_frameCallback = std::move(callback);
+}
+
+//------------------------------------------------------------
+void
+Headless::clear() {
+    m_rContext.clear();
+}
+
+//------------------------------------------------------------
+void
+Headless::swapBackBuffer() {
+    unsigned char const * pixels = m_rContext.getPixels();
+    int pitch = m_rContext.getPitch();
+
+    if(m_writeImages) {
+        char frameNumber[16];
+        std::snprintf(frameNumber, sizeof(frameNumber), "%05d", m_frameCount);
+
+        std::string filePath = m_pathPrefix + frameNumber + (m_imageFormat == ImageFormat::PNG ? ".png" : ".ppm");
+        writeImage(filePath, pixels, m_width, m_height, pitch, m_imageFormat);
+    }
+
+    if(m_frameCallback) {
+        m_frameCallback(pixels, m_width, m_height, pitch, m_frameCount);
+    }
+
+    m_frameCount++;
+}
+
+//------------------------------------------------------------
+int
+Headless::getFrameCount() const {
+    return m_frameCount;
+}
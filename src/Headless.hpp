@@ -0,0 +1,63 @@
+#ifndef Headless_hpp
+#define Headless_hpp
+
+// std
+#include <functional>
+#include <string>
+
+// my
+#include "RenderContext.hpp"
+#include "ImageIO.hpp"
+
+/*
+    Headless
+
+    - drop in replacement for Window when there is no display
+    - no SDL, finished frames go to an image sequence and / or a frame callback
+*/
+class Headless final {
+public:
+    // pixels are in the Bitmap layout: b, g, r, a with the top row first
+    using FrameCallback = std::function<void(unsigned char const * pixels, int width, int height, int pitch, int frameNumber)>;
+
+public:
+    Headless(int width, int height);
+    ~Headless() = default;
+
+    RenderContext & getRenderContext();
+
+    /*
+        writeImageSequence(...)
+
+        - every swapBackBuffer() writes <pathPrefix><frameNumber>.<ppm|png>
+        - frame numbers are zero padded to 5 digits
+    */
+    void writeImageSequence(std::string const & pathPrefix, ImageFormat format);
+    void stopImageSequence();
+
+    /*
+        setFrameCallback(...)
+
+        - called from swapBackBuffer() with the finished frame, pass nullptr to remove
+        - the pixels are only valid for the duration of the call
+    */
+    void setFrameCallback(FrameCallback callback);
+
+    void clear();
+    void swapBackBuffer();
+
+    int getFrameCount() const;
+
+private:
+    int m_width;
+    int m_height;
+    RenderContext m_rContext;
+
+    bool        m_writeImages;
+    std::string m_pathPrefix;
+    ImageFormat m_imageFormat;
+
+    FrameCallback m_frameCallback;
+    int m_frameCount;
+};
+#endif /* Headless_hpp */
@@ -0,0 +1,261 @@
+// std
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// my
+#include "ImageIO.hpp"
+#include "Bitmap.hpp"
+
+namespace {
+
+//------------------------------------------------------------
+void
+bgraRowToRGB(unsigned char const * src, unsigned char * dst, int width) {
+    for(int x = 0; x < width; x++) {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+        src += 4;
+        dst += 3;
+    }
+}
+
+//------------------------------------------------------------
+std::array<uint32_t, 256> const &
+crcTable() {
+    static std::array<uint32_t, 256> const table = [] {
+        std::array<uint32_t, 256> result;
+        for(uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for(int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            result[n] = c;
+        }
+        return result;
+    }();
+    return table;
+}
+
+//------------------------------------------------------------
+uint32_t
+updateCrc(uint32_t crc, unsigned char const * data, size_t size) {
+    auto const & table = crcTable();
+    for(size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+//------------------------------------------------------------
+void
+appendBigEndian(std::vector<unsigned char> & out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+//------------------------------------------------------------
+void
+writeChunk(std::ofstream & file, char const * type, std::vector<unsigned char> const & data) {
+    std::vector<unsigned char> chunk;
+    chunk.reserve(data.size() + 12);
+    appendBigEndian(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+
+    // crc covers the type and the data, not the length
+    uint32_t crc = updateCrc(0xffffffffu, chunk.data() + 4, data.size() + 4) ^ 0xffffffffu;
+    appendBigEndian(chunk, crc);
+
+    file.write(reinterpret_cast<char const *>(chunk.data()), chunk.size());
+}
+
+//------------------------------------------------------------
+bool
+readHeaderNumber(std::ifstream & file, int & value) {
+    // whitespace and # comments may come before each header field
+    while(true) {
+        int c = file.peek();
+        if(c == '#') {
+            std::string comment;
+            std::getline(file, comment);
+        } else if(c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            file.get();
+        } else {
+            break;
+        }
+    }
+
+    return static_cast<bool>(file >> value);
+}
+
+} /* namespace */
+
+//------------------------------------------------------------
+bool
+writeImage(std::string const & filePath, unsigned char const * pixels, int width, int height, int pitch, ImageFormat format) {
+    switch(format) {
+        case ImageFormat::PPM: return writePPM(filePath, pixels, width, height, pitch);
+        case ImageFormat::PNG: return writePNG(filePath, pixels, width, height, pitch);
+    }
+    return false;
+}
+
+//------------------------------------------------------------
+bool
+writeImage(std::string const & filePath, Bitmap & bitmap, ImageFormat format) {
+    return writeImage(filePath, bitmap.getPixels(), bitmap.getWidth(), bitmap.getHeight(), bitmap.getPitch(), format);
+}
+
+//------------------------------------------------------------
+bool
+writePPM(std::string const & filePath, unsigned char const * pixels, int width, int height, int pitch) {
+    std::ofstream file(filePath, std::ios::binary);
+
+    if(!file.is_open()) {
+        std::cerr << "could not open " << filePath << " for writing" << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    std::vector<unsigned char> row(width * 3);
+    for(int y = 0; y < height; y++) {
+        bgraRowToRGB(pixels + y * pitch, row.data(), width);
+        file.write(reinterpret_cast<char const *>(row.data()), row.size());
+    }
+
+    return file.good();
+}
+
+//------------------------------------------------------------
+bool
+writePNG(std::string const & filePath, unsigned char const * pixels, int width, int height, int pitch) {
+    std::ofstream file(filePath, std::ios::binary);
+
+    if(!file.is_open()) {
+        std::cerr << "could not open " << filePath << " for writing" << std::endl;
+        return false;
+    }
+
+    static unsigned char const signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    file.write(reinterpret_cast<char const *>(signature), sizeof(signature));
+
+    // IHDR - 8 bit rgb, no interlacing
+    std::vector<unsigned char> header;
+    appendBigEndian(header, static_cast<uint32_t>(width));
+    appendBigEndian(header, static_cast<uint32_t>(height));
+    header.push_back(8); // bit depth
+    header.push_back(2); // colour type rgb
+    header.push_back(0); // compression
+    header.push_back(0); // filter
+    header.push_back(0); // interlace
+    writeChunk(file, "IHDR", header);
+
+    // raw scanlines, each starts with filter type 0
+    size_t const rowSize = static_cast<size_t>(width) * 3 + 1;
+    std::vector<unsigned char> raw(rowSize * height);
+    for(int y = 0; y < height; y++) {
+        raw[y * rowSize] = 0;
+        bgraRowToRGB(pixels + y * pitch, &raw[y * rowSize + 1], width);
+    }
+
+    // IDAT - zlib stream made of stored deflate blocks, so no compressor is needed
+    size_t const maxBlock = 65535;
+    std::vector<unsigned char> idat;
+    idat.reserve(raw.size() + (raw.size() / maxBlock + 1) * 5 + 6);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+    size_t offset = 0;
+    do {
+        size_t blockSize = std::min(maxBlock, raw.size() - offset);
+        bool lastBlock = offset + blockSize == raw.size();
+
+        idat.push_back(lastBlock ? 1 : 0);
+        idat.push_back(static_cast<unsigned char>(blockSize & 0xff));
+        idat.push_back(static_cast<unsigned char>(blockSize >> 8));
+        idat.push_back(static_cast<unsigned char>(~blockSize & 0xff));
+        idat.push_back(static_cast<unsigned char>((~blockSize >> 8) & 0xff));
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+
+        for(size_t i = offset; i < offset + blockSize; i++) {
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+
+        offset += blockSize;
+    } while(offset < raw.size());
+    appendBigEndian(idat, (adlerB << 16) | adlerA);
+    writeChunk(file, "IDAT", idat);
+
+    writeChunk(file, "IEND", std::vector<unsigned char>());
+
+    return file.good();
+}
+
+//------------------------------------------------------------
+bool
+readPPM(std::string const & filePath, Bitmap & bitmap) {
+    std::ifstream file(filePath, std::ios::binary);
+
+    if(!file.is_open()) {
+        std::cerr << "could not open " << filePath << std::endl;
+        return false;
+    }
+
+    char magic[2] = {};
+    file.read(magic, 2);
+
+    int width = 0;
+    int height = 0;
+    int maxValue = 0;
+
+    if(magic[0] != 'P' || magic[1] != '6'
+    || !readHeaderNumber(file, width) || !readHeaderNumber(file, height) || !readHeaderNumber(file, maxValue)
+    || width <= 0 || height <= 0 || maxValue != 255) {
+        std::cerr << filePath << " is not an 8 bit binary ppm" << std::endl;
+        return false;
+    }
+    file.get(); // the single whitespace before the pixels
+
+    // checked before allocating, a bogus header must fail here rather than in the allocator
+    uint64_t const pixelBytes = static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * 3;
+    std::streampos const pixelStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff const remaining = file.tellg() - pixelStart;
+    file.seekg(pixelStart);
+
+    if(!file || remaining < 0 || pixelBytes > static_cast<uint64_t>(remaining)) {
+        std::cerr << filePath << " is truncated" << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned char> rgb(static_cast<size_t>(pixelBytes));
+    file.read(reinterpret_cast<char *>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+
+    if(!file) {
+        std::cerr << filePath << " is truncated" << std::endl;
+        return false;
+    }
+
+    bitmap.resize(width, height);
+    unsigned char * pixels = bitmap.getPixels();
+    for(size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        pixels[i * 4 + 0] = rgb[i * 3 + 2];
+        pixels[i * 4 + 1] = rgb[i * 3 + 1];
+        pixels[i * 4 + 2] = rgb[i * 3 + 0];
+        pixels[i * 4 + 3] = 255;
+    }
+
+    return true;
+}
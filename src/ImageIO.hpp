@@ -0,0 +1,37 @@
+#ifndef ImageIO_hpp
+#define ImageIO_hpp
+
+// std
+#include <string>
+
+class Bitmap;
+
+enum class ImageFormat {
+    PPM, // binary P6
+    PNG  // uncompressed deflate, no dependencies
+};
+
+/*
+    writeImage(...)
+
+    - pixels are in the Bitmap layout, 4 bytes per pixel b, g, r, a with the top row first
+    - pitch is the number of bytes between the start of two rows
+    - alpha is dropped, both formats are written as 8 bit rgb
+    - returns false and prints to std::cerr if the file could not be written
+*/
+bool writeImage(std::string const & filePath, unsigned char const * pixels, int width, int height, int pitch, ImageFormat format);
+bool writeImage(std::string const & filePath, Bitmap & bitmap, ImageFormat format);
+
+bool writePPM(std::string const & filePath, unsigned char const * pixels, int width, int height, int pitch);
+bool writePNG(std::string const & filePath, unsigned char const * pixels, int width, int height, int pitch);
+
+/*
+    readPPM(...)
+
+    - reads a binary P6 ppm with 8 bit channels, as written by writePPM(...), into bitmap
+    - bitmap is resized to the image, alpha is set to 255
+    - returns false and prints to std::cerr if the file could not be read, bitmap is left as it was
+*/
+bool readPPM(std::string const & filePath, Bitmap & bitmap);
+
+#endif /* ImageIO_hpp */
@@ -0,0 +1,379 @@
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+// my
+#include "Lod.hpp"
+#include "VertexCache.hpp"
+#include "djc_math/djc_math.hpp"
+
+namespace {
+    // sum of squared distances to a set of planes, weighted by triangle area
+    struct Quadric {
+        float a2 = 0.0f, b2 = 0.0f, c2 = 0.0f, d2 = 0.0f;
+        float ab = 0.0f, ac = 0.0f, ad = 0.0f;
+        float bc = 0.0f, bd = 0.0f, cd = 0.0f;
+        float weight = 0.0f;
+
+        void addPlane(djc_math::Vec3f const & normal, float distance, float planeWeight) {
+            a2 += normal.x * normal.x * planeWeight;
+            b2 += normal.y * normal.y * planeWeight;
+            c2 += normal.z * normal.z * planeWeight;
+            d2 += distance * distance * planeWeight;
+            ab += normal.x * normal.y * planeWeight;
+            ac += normal.x * normal.z * planeWeight;
+            ad += normal.x * distance * planeWeight;
+            bc += normal.y * normal.z * planeWeight;
+            bd += normal.y * distance * planeWeight;
+            cd += normal.z * distance * planeWeight;
+            weight += planeWeight;
+        }
+
+        void add(Quadric const & other) {
+            a2 += other.a2; b2 += other.b2; c2 += other.c2; d2 += other.d2;
+            ab += other.ab; ac += other.ac; ad += other.ad;
+            bc += other.bc; bd += other.bd; cd += other.cd;
+            weight += other.weight;
+        }
+
+        float evaluate(djc_math::Vec3f const & p) const {
+            float result = a2 * p.x * p.x + b2 * p.y * p.y + c2 * p.z * p.z + d2
+                         + 2.0f * (ab * p.x * p.y + ac * p.x * p.z + ad * p.x + bc * p.y * p.z + bd * p.y + cd * p.z);
+            return std::max(result, 0.0f);
+        }
+    };
+
+    struct Collapse {
+        unsigned int source;
+        unsigned int target;
+        float cost;
+    };
+
+    djc_math::Vec3f positionOf(Vertex const & vertex) {
+        return djc_math::Vec3f(vertex.position.x, vertex.position.y, vertex.position.z);
+    }
+
+    // rms distance of the point from the planes a quadric was built from
+    float quadricError(Quadric const & quadric, djc_math::Vec3f const & point) {
+        return quadric.weight > 0.0f ? std::sqrt(quadric.evaluate(point) / quadric.weight) : 0.0f;
+    }
+
+    uint64_t edgeKey(unsigned int a, unsigned int b) {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+
+    // the first vertex at each position stands in for all of them, seams are found by positions with several vertices
+    std::vector<unsigned int> findCanonicalVertices(std::vector<Vertex> const & vertices, std::vector<uint8_t> & seam) {
+        struct PositionHash {
+            size_t operator () (djc_math::Vec3f const & p) const {
+                uint32_t bits[3];
+                std::memcpy(&bits[0], &p.x, sizeof(float));
+                std::memcpy(&bits[1], &p.y, sizeof(float));
+                std::memcpy(&bits[2], &p.z, sizeof(float));
+                return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+            }
+        };
+        struct PositionEqual {
+            bool operator () (djc_math::Vec3f const & lhs, djc_math::Vec3f const & rhs) const {
+                return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+            }
+        };
+
+        std::unordered_map<djc_math::Vec3f, unsigned int, PositionHash, PositionEqual> firstAt;
+        firstAt.reserve(vertices.size());
+
+        std::vector<unsigned int> canonical(vertices.size());
+        seam.assign(vertices.size(), 0);
+
+        for(size_t i = 0; i < vertices.size(); i++) {
+            auto inserted = firstAt.emplace(positionOf(vertices[i]), static_cast<unsigned int>(i));
+            canonical[i] = inserted.first->second;
+
+            if(!inserted.second) {
+                seam[canonical[i]] = 1;
+            }
+        }
+
+        return canonical;
+    }
+}
+
+//------------------------------------------------------------
+std::vector<unsigned int>
+simplifyMesh(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, size_t targetIndexCount, float maxError, float * resultError) {
+    std::vector<unsigned int> result(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+    float error = 0.0f;
+
+    std::vector<uint8_t> locked;
+    std::vector<unsigned int> canonical = findCanonicalVertices(vertices, locked);
+
+    // edges used by one triangle are open borders, more than two are non manifold, neither end is moved
+    std::unordered_map<uint64_t, unsigned int> edgeUse;
+    edgeUse.reserve(result.size());
+    for(size_t i = 0; i < result.size(); i += 3) {
+        for(int e = 0; e < 3; e++) {
+            edgeUse[edgeKey(canonical[result[i + e]], canonical[result[i + (e + 1) % 3]])]++;
+        }
+    }
+
+    for(auto const & edge : edgeUse) {
+        if(edge.second != 2) {
+            locked[static_cast<unsigned int>(edge.first >> 32)] = 1;
+            locked[static_cast<unsigned int>(edge.first & 0xFFFFFFFFu)] = 1;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertices.size());
+
+    for(size_t i = 0; i < result.size(); i += 3) {
+        unsigned int corners[3] = { canonical[result[i + 0]], canonical[result[i + 1]], canonical[result[i + 2]] };
+        djc_math::Vec3f p0 = positionOf(vertices[corners[0]]);
+        djc_math::Vec3f p1 = positionOf(vertices[corners[1]]);
+        djc_math::Vec3f p2 = positionOf(vertices[corners[2]]);
+
+        djc_math::Vec3f normal = (p1 - p0).cross(p2 - p0);
+        float doubleArea = normal.length();
+        if(doubleArea == 0.0f) {
+            continue;
+        }
+        normal /= doubleArea;
+
+        for(int e = 0; e < 3; e++) {
+            quadrics[corners[e]].addPlane(normal, -normal.dot(p0), doubleArea * 0.5f);
+        }
+
+    }
+
+    std::vector<Collapse> collapses;
+    std::vector<uint8_t> touched(vertices.size());
+    std::vector<unsigned int> remap(vertices.size());
+    std::vector<unsigned int> adjacencyOffsets(vertices.size() + 1);
+    std::vector<unsigned int> adjacency;
+
+    // passes of independent collapses, cheapest first, until the target or nothing collapses
+    while(result.size() > targetIndexCount) {
+        collapses.clear();
+
+        for(size_t i = 0; i < result.size(); i += 3) {
+            for(int e = 0; e < 3; e++) {
+                unsigned int ends[2] = { result[i + e], result[i + (e + 1) % 3] };
+
+                for(int direction = 0; direction < 2; direction++) {
+                    unsigned int source = ends[direction];
+                    unsigned int target = ends[1 - direction];
+
+                    // only vertices alone at their position move, so a collapse never tears a seam open
+                    if(locked[canonical[source]] || canonical[source] == canonical[target]) {
+                        continue;
+                    }
+
+                    Quadric combined = quadrics[canonical[source]];
+                    combined.add(quadrics[canonical[target]]);
+                    collapses.push_back(Collapse{ source, target, quadricError(combined, positionOf(vertices[target])) });
+                }
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](Collapse const & lhs, Collapse const & rhs) {
+            return lhs.cost < rhs.cost;
+        });
+
+        // triangles around each vertex as they are at the start of the pass
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for(unsigned int index : result) {
+            adjacencyOffsets[index + 1]++;
+        }
+        for(size_t v = 0; v < vertices.size(); v++) {
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        }
+        adjacency.resize(result.size());
+        std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for(size_t i = 0; i < result.size(); i++) {
+            adjacency[fill[result[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        std::fill(touched.begin(), touched.end(), 0);
+        for(size_t v = 0; v < remap.size(); v++) {
+            remap[v] = static_cast<unsigned int>(v);
+        }
+
+        size_t const triangleCount = result.size() / 3;
+        size_t const targetTriangles = targetIndexCount / 3;
+        size_t removed = 0;
+        size_t accepted = 0;
+
+        for(auto const & collapse : collapses) {
+            if(triangleCount - removed <= targetTriangles) {
+                break;
+            }
+
+            if(collapse.cost > maxError) {
+                break;
+            }
+
+            if(touched[canonical[collapse.source]] || touched[canonical[collapse.target]]) {
+                continue;
+            }
+
+            djc_math::Vec3f to = positionOf(vertices[collapse.target]);
+
+            // every triangle that survives the collapse has to keep facing the same way
+            bool flips = false;
+            size_t collapsing = 0;
+
+            for(unsigned int a = adjacencyOffsets[collapse.source]; a < adjacencyOffsets[collapse.source + 1] && !flips; a++) {
+                unsigned int const * triangle = result.data() + static_cast<size_t>(adjacency[a]) * 3;
+
+                bool hasTarget = false;
+                djc_math::Vec3f before[3];
+                djc_math::Vec3f after[3];
+
+                for(int corner = 0; corner < 3; corner++) {
+                    hasTarget |= canonical[triangle[corner]] == canonical[collapse.target];
+                    before[corner] = positionOf(vertices[triangle[corner]]);
+                    after[corner] = triangle[corner] == collapse.source ? to : before[corner];
+                }
+
+                if(hasTarget) {
+                    collapsing++;
+                    continue;
+                }
+
+                djc_math::Vec3f normalBefore = (before[1] - before[0]).cross(before[2] - before[0]);
+                djc_math::Vec3f normalAfter = (after[1] - after[0]).cross(after[2] - after[0]);
+                flips = normalBefore.dot(normalAfter) <= 0.0f;
+            }
+
+            if(flips) {
+                continue;
+            }
+
+            // nothing around the source may change again this pass, the flip test above would be stale
+            for(unsigned int a = adjacencyOffsets[collapse.source]; a < adjacencyOffsets[collapse.source + 1]; a++) {
+                unsigned int const * triangle = result.data() + static_cast<size_t>(adjacency[a]) * 3;
+                for(int corner = 0; corner < 3; corner++) {
+                    touched[canonical[triangle[corner]]] = 1;
+                }
+            }
+
+            remap[collapse.source] = collapse.target;
+            quadrics[canonical[collapse.target]].add(quadrics[canonical[collapse.source]]);
+            error = std::max(error, collapse.cost);
+            removed += collapsing;
+            accepted++;
+        }
+
+        if(accepted == 0) {
+            break;
+        }
+
+        // collapsed triangles end up with two corners at one position and are dropped
+        size_t write = 0;
+        for(size_t i = 0; i < result.size(); i += 3) {
+            unsigned int a = remap[result[i + 0]];
+            unsigned int b = remap[result[i + 1]];
+            unsigned int c = remap[result[i + 2]];
+
+            if(canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[c] == canonical[a]) {
+                continue;
+            }
+
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if(resultError) {
+        *resultError = error;
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------
+LodChain
+buildLodChain(Mesh mesh, size_t maxLevels, float reduction) {
+    LodChain chain;
+
+    // simplified index lists over the original vertices, compacted into meshes at the end
+    std::vector<std::vector<unsigned int>> levelIndices;
+    std::vector<float> levelErrors;
+
+    std::vector<unsigned int> const * previous = &mesh.indices;
+    float previousError = 0.0f;
+
+    for(size_t level = 1; level < maxLevels; level++) {
+        size_t target = static_cast<size_t>(static_cast<float>(previous->size() / 3) * reduction) * 3;
+        float error = 0.0f;
+
+        std::vector<unsigned int> indices = simplifyMesh(mesh.vertices, *previous, target, FLT_MAX, &error);
+
+        if(indices.empty() || static_cast<float>(indices.size()) > static_cast<float>(previous->size()) * LOD_MIN_PROGRESS) {
+            break;
+        }
+
+        // each level's error is measured from the level before it, added up it bounds the distance to the original
+        previousError += error;
+        levelIndices.push_back(std::move(indices));
+        levelErrors.push_back(previousError);
+        previous = &levelIndices.back();
+    }
+
+    for(size_t level = 0; level < levelIndices.size(); level++) {
+        std::vector<unsigned int> indices = optimizeVertexCache(levelIndices[level], mesh.vertices.size());
+
+        MeshLod lod;
+        lod.error = levelErrors[level];
+
+        // only the vertices this level uses, in the order it first uses them like optimizeVertexFetch(...)
+        std::vector<unsigned int> remap(mesh.vertices.size(), UINT32_MAX);
+        lod.mesh.indices.reserve(indices.size());
+
+        for(unsigned int index : indices) {
+            if(remap[index] == UINT32_MAX) {
+                remap[index] = static_cast<unsigned int>(lod.mesh.vertices.size());
+                lod.mesh.vertices.push_back(mesh.vertices[index]);
+            }
+            lod.mesh.indices.push_back(remap[index]);
+        }
+
+        lod.mesh.bounds = computeBounds(lod.mesh.vertices);
+        lod.mesh.meshlets = buildMeshlets(lod.mesh.vertices, lod.mesh.indices);
+        chain.levels.push_back(std::move(lod));
+    }
+
+    // the original goes in last, the levels above were built from it
+    MeshLod original;
+    original.mesh = std::move(mesh);
+    original.error = 0.0f;
+    chain.levels.insert(chain.levels.begin(), std::move(original));
+
+    return chain;
+}
+
+//------------------------------------------------------------
+size_t
+selectLod(LodChain const & chain, float pixelsPerUnit, size_t currentLevel, float pixelError, float hysteresis) {
+    if(chain.levels.empty()) {
+        return 0;
+    }
+
+    size_t level = std::min(currentLevel, chain.levels.size() - 1);
+
+    // finer while the current level is clearly too coarse
+    while(level > 0 && chain.levels[level].error * pixelsPerUnit > pixelError * (1.0f + hysteresis)) {
+        level--;
+    }
+
+    // coarser while the next level is clearly fine
+    while(level + 1 < chain.levels.size() && chain.levels[level + 1].error * pixelsPerUnit <= pixelError * (1.0f - hysteresis)) {
+        level++;
+    }
+
+    return level;
+}
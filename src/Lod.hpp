@@ -0,0 +1,67 @@
+#ifndef Lod_hpp
+#define Lod_hpp
+
+// std
+#include <cfloat>
+#include <vector>
+
+// my
+#include "Mesh.hpp"
+#include "Vertex.hpp"
+
+// my defines
+#define LOD_MAX_LEVELS   4
+#define LOD_REDUCTION    0.5f  // each level aims for this fraction of the previous level's triangles
+#define LOD_MIN_PROGRESS 0.85f // a level keeping more than this fraction of the previous one ends the chain
+#define LOD_PIXEL_ERROR  1.0f  // simplification error allowed on screen, in pixels
+#define LOD_HYSTERESIS   0.25f // fraction of LOD_PIXEL_ERROR a level has to clear before switching to it
+
+/*
+    MeshLod
+
+    - one level of detail, a mesh of its own with bounds and meshlets
+    - error is how far, in model units, the surface may be from the original
+*/
+struct MeshLod {
+    Mesh mesh;
+    float error;
+};
+
+// level 0 is the original mesh, every following level has fewer triangles and a larger error
+struct LodChain {
+    std::vector<MeshLod> levels;
+};
+
+/*
+    simplifyMesh(...)
+
+    - quadric error metric edge collapse, each collapse moves a vertex onto a neighbour so
+      the result indexes the same vertices and no new ones are made
+    - vertices on open borders or on seams, where one position has several vertices, never move
+    - collapses that would flip a triangle or go over maxError are skipped
+    - stops at targetIndexCount or when nothing more can be collapsed, whichever is first
+    - resultError receives the error reached, in model units
+*/
+std::vector<unsigned int> simplifyMesh(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, size_t targetIndexCount, float maxError = FLT_MAX, float * resultError = nullptr);
+
+/*
+    buildLodChain(...)
+
+    - each level is simplified from the one before it, down to reduction of its triangles
+    - the chain ends early once simplification stalls, a mesh made of seams may only have level 0
+    - coarser levels only use vertices of the original, the original bounds contain them all
+    - pass the mesh with std::move when it is not needed afterwards
+*/
+LodChain buildLodChain(Mesh mesh, size_t maxLevels = LOD_MAX_LEVELS, float reduction = LOD_REDUCTION);
+
+/*
+    selectLod(...)
+
+    - pixelsPerUnit is how many pixels one model unit covers at the mesh's nearest point
+    - picks the coarsest level whose error stays under pixelError on screen
+    - moves away from currentLevel only once the error has cleared pixelError by the hysteresis
+      fraction, so a mesh sitting at a switching distance does not flicker between two levels
+*/
+size_t selectLod(LodChain const & chain, float pixelsPerUnit, size_t currentLevel, float pixelError = LOD_PIXEL_ERROR, float hysteresis = LOD_HYSTERESIS);
+
+#endif /* Lod_hpp */
@@ -0,0 +1,275 @@
+// std
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <utility>
+
+// my
+#include "Mesh.hpp"
+#include "MeshFile.hpp"
+#include "ObjImport.hpp"
+#include "TextParse.hpp"
+#include "djc_math/djc_math.hpp"
+
+namespace {
+    const size_t READ_CHUNK_SIZE    = 4 << 20; // bytes read from the file at a time
+    const size_t MIN_VERTEX_BYTES   = 16;      // 8 numbers of at least one digit, each followed by a separator
+    const size_t MIN_INDEX_BYTES    = 2;       // one digit and a line break
+    const int    NUMBERS_PER_VERTEX = 8;       // position xyz, texture coordinates uv, colour rgb
+
+    /*
+        LineReader
+
+        - reads a file in large chunks and hands out whole lines that point into the chunk
+        - a line stays valid until the next call to nextLine(...)
+        - lines longer than a chunk grow the buffer
+    */
+    class LineReader {
+    public:
+        explicit LineReader(std::FILE * file)
+        :   m_file(file)
+        ,   m_buffer(READ_CHUNK_SIZE)
+        ,   m_begin(0)
+        ,   m_end(0)
+        ,   m_line(0)
+        ,   m_eof(false)
+        {
+            // empty
+        }
+
+        // begin / end exclude the line break, false at the end of the file
+        bool nextLine(char const *& begin, char const *& end) {
+            char const * found = nullptr;
+
+            while(true) {
+                char const * start = m_buffer.data() + m_begin;
+                found = static_cast<char const *>(std::memchr(start, '\n', m_end - m_begin));
+
+                if(found || m_eof) {
+                    break;
+                }
+
+                refill();
+            }
+
+            if(!found && m_begin == m_end) {
+                return false;
+            }
+
+            begin = m_buffer.data() + m_begin;
+            end   = found ? found : m_buffer.data() + m_end;
+            m_begin = found ? static_cast<size_t>(found - m_buffer.data()) + 1 : m_end;
+
+            if(end > begin && end[-1] == '\r') {
+                end--;
+            }
+
+            m_line++;
+            return true;
+        }
+
+        size_t getLineNumber() const {
+            return m_line;
+        }
+
+    private:
+        void refill() {
+            // keep the unfinished line, moved to the front
+            size_t kept = m_end - m_begin;
+            std::memmove(m_buffer.data(), m_buffer.data() + m_begin, kept);
+            m_begin = 0;
+            m_end = kept;
+
+            if(m_end == m_buffer.size()) {
+                m_buffer.resize(m_buffer.size() * 2);
+            }
+
+            size_t read = std::fread(m_buffer.data() + m_end, 1, m_buffer.size() - m_end, m_file);
+            m_end += read;
+            m_eof = read == 0;
+        }
+
+    private:
+        std::FILE *       m_file;
+        std::vector<char> m_buffer;
+        size_t            m_begin; // first byte not handed out yet
+        size_t            m_end;   // end of the bytes read
+        size_t            m_line;
+        bool              m_eof;
+    };
+
+    // the second token of a line, "meshCount: 2" and "mesh[0]: 24 36" both lead with a name
+    bool parseCounts(char const * begin, char const * end, size_t * counts, int countCount) {
+        char const * tokenBegin;
+        char const * tokenEnd;
+
+        if(!nextToken(begin, end, tokenBegin, tokenEnd)) {
+            return false;
+        }
+
+        for(int i = 0; i < countCount; i++) {
+            if(!nextToken(begin, end, tokenBegin, tokenEnd) || !parseNumber(tokenBegin, tokenEnd, counts[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+//------------------------------------------------------------
+std::vector<Mesh>
+loadDannyFile(std::string const & filePath, std::vector<VertexCacheStats> * cacheStats) {
+    std::vector<Mesh> meshes;
+
+    std::FILE * file = std::fopen(filePath.c_str(), "rb");
+    if(!file) {
+        std::cerr << "could not open " << filePath << std::endl;
+        return meshes;
+    }
+
+    // unknown for pipes and the like, the counts are then trusted and nothing is reserved from them
+    std::error_code sizeError;
+    uintmax_t const fileSize = std::filesystem::file_size(filePath, sizeError);
+    bool const sizeKnown = !sizeError;
+
+    LineReader reader(file);
+
+    char const * lineBegin;
+    char const * lineEnd;
+
+    // errors name the file and line, the whole load fails so a half read mesh is never drawn
+    auto fail = [&](char const * message) {
+        std::cerr << filePath << ":" << reader.getLineNumber() << ": " << message << std::endl;
+        std::fclose(file);
+        meshes.clear();
+        return meshes;
+    };
+
+    size_t meshCount = 0;
+    if(!reader.nextLine(lineBegin, lineEnd) || !parseCounts(lineBegin, lineEnd, &meshCount, 1)) {
+        return fail("expected \"meshCount: <count>\"");
+    }
+
+    struct MeshSize {
+        size_t numVertices;
+        size_t numIndices;
+    };
+
+    if(sizeKnown && meshCount > fileSize) {
+        return fail("more meshes than the file can hold");
+    }
+
+    std::vector<MeshSize> meshSizes;
+    if(sizeKnown) {
+        meshSizes.reserve(meshCount);
+    }
+    uintmax_t bytesNeeded = 0;
+
+    for(size_t currMesh = 0; currMesh < meshCount; currMesh++) {
+        size_t counts[2];
+        if(!reader.nextLine(lineBegin, lineEnd) || !parseCounts(lineBegin, lineEnd, counts, 2)) {
+            return fail("expected \"mesh[<index>]: <vertex count> <index count>\"");
+        }
+
+        if(counts[1] % 3 != 0) {
+            return fail("index count is not a multiple of 3");
+        }
+
+        // counts are checked against the file size before anything is reserved from them
+        if(sizeKnown) {
+            if(counts[0] > fileSize / MIN_VERTEX_BYTES || counts[1] > fileSize / MIN_INDEX_BYTES) {
+                return fail("counts are larger than the file can hold");
+            }
+            bytesNeeded += static_cast<uintmax_t>(counts[0]) * MIN_VERTEX_BYTES + static_cast<uintmax_t>(counts[1]) * MIN_INDEX_BYTES;
+        }
+
+        meshSizes.push_back({ counts[0], counts[1] });
+    }
+
+    if(sizeKnown && bytesNeeded > fileSize) {
+        return fail("counts are larger than the file can hold");
+    }
+
+    meshes.reserve(meshSizes.size());
+
+    for(size_t i = 0; i < meshSizes.size(); i++) {
+        Mesh mesh;
+        if(sizeKnown) {
+            mesh.vertices.reserve(meshSizes[i].numVertices);
+            mesh.indices.reserve(meshSizes[i].numIndices);
+        }
+
+        // extract vertices, position xyz, texture coordinates uv and colour rgb
+        for(size_t j = 0; j < meshSizes[i].numVertices; j++) {
+            if(!reader.nextLine(lineBegin, lineEnd)) {
+                return fail("file ended inside the vertices");
+            }
+
+            float numbers[NUMBERS_PER_VERTEX];
+            char const * cursor = lineBegin;
+
+            for(int n = 0; n < NUMBERS_PER_VERTEX; n++) {
+                char const * tokenBegin;
+                char const * tokenEnd;
+
+                if(!nextToken(cursor, lineEnd, tokenBegin, tokenEnd) || !parseNumber(tokenBegin, tokenEnd, numbers[n])) {
+                    return fail("expected 8 numbers for a vertex");
+                }
+            }
+
+            mesh.vertices.emplace_back(djc_math::Vec3f(numbers[0], numbers[1], numbers[2]),
+                                       djc_math::Vec2f(numbers[3], numbers[4]),
+                                       djc_math::Vec3f(numbers[5], numbers[6], numbers[7]));
+        }
+
+        // extract indices
+        for(size_t j = 0; j < meshSizes[i].numIndices; j++) {
+            if(!reader.nextLine(lineBegin, lineEnd)) {
+                return fail("file ended inside the indices");
+            }
+
+            char const * cursor = lineBegin;
+            char const * tokenBegin;
+            char const * tokenEnd;
+            size_t index;
+
+            if(!nextToken(cursor, lineEnd, tokenBegin, tokenEnd) || !parseNumber(tokenBegin, tokenEnd, index)) {
+                return fail("expected an index");
+            }
+
+            if(index >= meshSizes[i].numVertices) {
+                return fail("index is past the mesh's vertices");
+            }
+
+            mesh.indices.push_back(static_cast<unsigned int>(index));
+        }
+
+        VertexCacheStats stats = optimizeMesh(mesh.vertices, mesh.indices);
+        if(cacheStats) {
+            cacheStats->push_back(stats);
+        }
+
+        mesh.bounds = computeBounds(mesh.vertices);
+        mesh.meshlets = buildMeshlets(mesh.vertices, mesh.indices);
+        meshes.push_back(std::move(mesh));
+    }
+
+    std::fclose(file);
+    return meshes;
+}
+
+//------------------------------------------------------------
+std::vector<Mesh>
+loadMeshesFromFile(std::string const & filePath, size_t threadCount) {
+    if(endsWith(filePath, ".srmesh")) {
+        return loadMeshFile(filePath);
+    }
+
+    if(endsWith(filePath, ".obj")) {
+        return loadObjFile(filePath, threadCount);
+    }
+
+    return loadDannyFile(filePath);
+}
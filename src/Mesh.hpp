@@ -0,0 +1,47 @@
+#ifndef Mesh_hpp
+#define Mesh_hpp
+
+// std
+#include <string>
+#include <vector>
+
+// my
+#include "Bounds.hpp"
+#include "Meshlet.hpp"
+#include "Vertex.hpp"
+#include "VertexCache.hpp"
+
+//------------------------------------------------------------
+struct Mesh {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    Bounds bounds; // in model space, recompute with computeBounds(...) if vertices change
+    Meshlets meshlets; // rebuild with buildMeshlets(...) if vertices or indices change, empty draws the whole mesh at once
+};
+
+/*
+    loadDannyFile(...)
+
+    - loads every mesh in a .danny file
+    - streams the file in large chunks, numbers are parsed in place with std::from_chars
+    - returns an empty vector if the file could not be opened or is malformed, the file and line
+      of the problem are printed to std::cerr
+    - each mesh is reordered with optimizeMesh(...), then its bounds and meshlets are computed
+    - cacheStats, when given, receives one entry per mesh with the ACMR before and after
+    - text parsing is slow on big files, convert them with SoftRenderMeshConvert and use
+      MappedMeshFile or loadMeshFile(...) from MeshFile.hpp
+*/
+std::vector<Mesh> loadDannyFile(std::string const & filePath, std::vector<VertexCacheStats> * cacheStats = nullptr);
+
+/*
+    loadMeshesFromFile(...)
+
+    - picks the loader from the extension, .srmesh files go through loadMeshFile(...), .obj
+      through loadObjFile(...) and anything else through loadDannyFile(...)
+    - threadCount is passed on to loadObjFile(...), callers already on a worker thread pass 1 so
+      each load does not start a pool of its own
+    - returns an empty vector on failure, the reason is printed by the loader that read it
+*/
+std::vector<Mesh> loadMeshesFromFile(std::string const & filePath, size_t threadCount = 0);
+
+#endif /* Mesh_hpp */
@@ -0,0 +1,178 @@
+// std
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+// my
+#include "MeshCache.hpp"
+#include "Mesh.hpp"
+#include "MeshFile.hpp"
+
+namespace {
+    const size_t   HASH_CHUNK_SIZE = 4 << 20; // bytes hashed at a time, each chunk is seeded with the hash so far
+    const uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+    const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+    const uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+
+    uint64_t rotateLeft(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t readWord(unsigned char const * data) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return word;
+    }
+
+    uint64_t mixWord(uint64_t lane, uint64_t word) {
+        return rotateLeft(lane + word * PRIME_2, 31) * PRIME_1;
+    }
+
+    // four independent lanes over 32 byte stripes so the multiplies overlap, then the tail a word and a byte at a time
+    uint64_t hashBytes(unsigned char const * data, size_t size, uint64_t seed) {
+        uint64_t lanes[4] = { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+
+        size_t offset = 0;
+        for(; offset + 32 <= size; offset += 32) {
+            lanes[0] = mixWord(lanes[0], readWord(data + offset + 0));
+            lanes[1] = mixWord(lanes[1], readWord(data + offset + 8));
+            lanes[2] = mixWord(lanes[2], readWord(data + offset + 16));
+            lanes[3] = mixWord(lanes[3], readWord(data + offset + 24));
+        }
+
+        uint64_t hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+        hash += static_cast<uint64_t>(size);
+
+        for(; offset + 8 <= size; offset += 8) {
+            hash = rotateLeft(hash ^ mixWord(0, readWord(data + offset)), 27) * PRIME_1 + PRIME_3;
+        }
+        for(; offset < size; offset++) {
+            hash = rotateLeft(hash ^ (data[offset] * PRIME_3), 11) * PRIME_1;
+        }
+
+        // spread every input bit over the whole result
+        hash ^= hash >> 33;
+        hash *= PRIME_2;
+        hash ^= hash >> 29;
+        hash *= PRIME_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    uint64_t hashValue(uint64_t hash, uint64_t value) {
+        unsigned char bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        return hashBytes(bytes, sizeof(bytes), hash);
+    }
+}
+
+//------------------------------------------------------------
+bool
+hashFileContents(std::string const & filePath, uint64_t & hash) {
+    std::FILE * file = std::fopen(filePath.c_str(), "rb");
+    if(!file) {
+        std::cerr << "could not open " << filePath << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned char> chunk(HASH_CHUNK_SIZE);
+    hash = 0;
+
+    while(true) {
+        size_t read = std::fread(chunk.data(), 1, chunk.size(), file);
+        if(read == 0) {
+            break;
+        }
+        hash = hashBytes(chunk.data(), read, hash);
+    }
+
+    bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+
+    if(failed) {
+        std::cerr << "could not read " << filePath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------
+std::string
+getMeshCachePath(std::string const & cacheDirectory, uint64_t contentHash, MeshProcessOptions const & options) {
+    // everything that changes the processed output goes into the key
+    uint32_t reductionBits;
+    std::memcpy(&reductionBits, &options.lodReduction, sizeof(reductionBits));
+
+    uint64_t key = contentHash;
+    key = hashValue(key, MESH_CACHE_VERSION);
+    key = hashValue(key, MESH_FILE_VERSION);
+    key = hashValue(key, options.lodLevels);
+    key = hashValue(key, reductionBits);
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.srmesh", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(cacheDirectory) / name).string();
+}
+
+//------------------------------------------------------------
+std::vector<LodChain>
+loadProcessedMeshes(std::string const & sourcePath, std::string const & cacheDirectory, MeshProcessOptions const & options, bool * cacheHit) {
+    std::vector<LodChain> chains;
+
+    if(cacheHit) {
+        *cacheHit = false;
+    }
+
+    uint64_t contentHash;
+    if(!hashFileContents(sourcePath, contentHash)) {
+        return chains;
+    }
+
+    std::string const cachePath = getMeshCachePath(cacheDirectory, contentHash, options);
+
+    std::error_code error;
+    if(std::filesystem::exists(cachePath, error)) {
+        chains = loadLodChains(cachePath);
+
+        if(!chains.empty()) {
+            if(cacheHit) {
+                *cacheHit = true;
+            }
+            return chains;
+        }
+
+        // a stale or damaged entry is replaced below
+        std::cerr << "processing " << sourcePath << " again" << std::endl;
+    }
+
+    std::vector<Mesh> meshes = loadMeshesFromFile(sourcePath);
+    if(meshes.empty()) {
+        return chains;
+    }
+
+    chains.reserve(meshes.size());
+    for(auto & mesh : meshes) {
+        chains.push_back(buildLodChain(std::move(mesh), options.lodLevels, options.lodReduction));
+    }
+
+    // written aside and renamed, a run that stops half way or a second run loading the same
+    // source never leaves a partial entry under the real name
+    std::filesystem::create_directories(cacheDirectory, error);
+    std::string const temporaryPath = cachePath + ".tmp" + std::to_string(std::random_device()());
+
+    if(writeLodChains(temporaryPath, chains)) {
+        std::filesystem::rename(temporaryPath, cachePath, error);
+    }
+
+    if(error) {
+        std::cerr << "could not store " << cachePath << ": " << error.message() << std::endl;
+    }
+    std::filesystem::remove(temporaryPath, error);
+
+    return chains;
+}
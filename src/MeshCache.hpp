@@ -0,0 +1,50 @@
+#ifndef MeshCache_hpp
+#define MeshCache_hpp
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// my
+#include "Lod.hpp"
+
+// my defines
+#define MESH_CACHE_VERSION 1 // bump whenever processing changes its output, old entries are then never hit
+
+// processing applied to every mesh of a source file, part of the cache key
+struct MeshProcessOptions {
+    size_t lodLevels    = 1; // 1 keeps only the original, see buildLodChain(...)
+    float  lodReduction = LOD_REDUCTION;
+};
+
+/*
+    hashFileContents(...)
+
+    - 64 bit non cryptographic hash of a file's bytes, read in large chunks
+    - returns false and prints to std::cerr if the file could not be read
+*/
+bool hashFileContents(std::string const & filePath, uint64_t & hash);
+
+/*
+    getMeshCachePath(...)
+
+    - the entry in cacheDirectory for a source file with the given contents hash and options
+*/
+std::string getMeshCachePath(std::string const & cacheDirectory, uint64_t contentHash, MeshProcessOptions const & options);
+
+/*
+    loadProcessedMeshes(...)
+
+    - the meshes of a .danny or .obj file, read with loadMeshesFromFile(...), cache ordered, bounded, with meshlets and lod chains
+    - keyed on the source's contents rather than its name or time, so an edited file is processed
+      again and a copied one is not
+    - a hit maps the .srmesh entry and skips parsing and processing, a miss processes the source and
+      writes the entry for next time, entries are written under a temporary name and renamed into place
+    - cacheHit, when given, says which happened
+    - returns an empty vector if the source could not be loaded, a cache that cannot be written only
+      costs the next start its hit
+*/
+std::vector<LodChain> loadProcessedMeshes(std::string const & sourcePath, std::string const & cacheDirectory, MeshProcessOptions const & options = MeshProcessOptions(), bool * cacheHit = nullptr);
+
+#endif /* MeshCache_hpp */
@@ -0,0 +1,584 @@
+// std
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+// my
+#include "MeshCompression.hpp"
+
+// dependancies
+#if defined(__SSSE3__)
+    #define MESH_CODEC_SSSE3
+    #include <tmmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define MESH_CODEC_SSE2
+    #include <emmintrin.h>
+#endif
+
+static_assert(std::is_trivially_copyable<Meshlet>::value, "meshlet clusters are stored as they are in memory");
+static_assert(std::is_trivially_copyable<Bounds>::value, "bounds are written as they are in memory");
+
+namespace {
+    const char     MAGIC[8]        = { 'S', 'R', 'M', 'E', 'S', 'H', 'Z', 0 };
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    const size_t   STREAM_PADDING  = 16;  // zero bytes after the last stream, a 16 byte load anywhere in a stream stays inside data
+    const size_t   DECODE_BLOCK    = 256; // values decoded into scratch at a time, a multiple of 4 small enough to stay in L1
+    const size_t   VERTEX_STREAMS  = 9;   // 3 position, 2 texture coordinate and 4 colour channels
+
+    // bytes a value takes for each 2 bit code
+    const uint8_t CODE_LENGTHS[4] = { 0, 1, 2, 4 };
+
+    // per control byte, the bytes its 4 values take and the shuffle that spreads them over 4 lanes
+    struct DecodeTables {
+        uint8_t lengths[256];
+        alignas(16) uint8_t shuffles[256][16];
+    };
+
+    DecodeTables const & decodeTables() {
+        static DecodeTables const tables = [] {
+            DecodeTables built;
+
+            for(int control = 0; control < 256; control++) {
+                uint8_t offset = 0;
+
+                for(int lane = 0; lane < 4; lane++) {
+                    uint8_t length = CODE_LENGTHS[(control >> (lane * 2)) & 3];
+
+                    // 0x80 has the shuffle write a zero byte
+                    for(int byte = 0; byte < 4; byte++) {
+                        built.shuffles[control][lane * 4 + byte] = byte < length ? static_cast<uint8_t>(offset + byte) : 0x80;
+                    }
+                    offset += length;
+                }
+
+                built.lengths[control] = offset;
+            }
+
+            return built;
+        }();
+
+        return tables;
+    }
+
+    uint32_t zigzag(int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    // difference wrapped to the width of T, so a 16 bit channel never needs more than 2 bytes
+    template<typename T>
+    uint32_t zigzagDelta(T value, T previous) {
+        using Signed = typename std::make_signed<T>::type;
+        return zigzag(static_cast<Signed>(static_cast<T>(value - previous)));
+    }
+
+    void appendSize(std::vector<uint8_t> & data, size_t size) {
+        uint32_t size32 = static_cast<uint32_t>(size);
+        uint8_t const * bytes = reinterpret_cast<uint8_t const *>(&size32);
+        data.insert(data.end(), bytes, bytes + sizeof(size32));
+    }
+
+    // values are zigzagged differences, written as control bytes then the value bytes, little endian
+    void appendStream(std::vector<uint8_t> & data, std::vector<uint32_t> const & values) {
+        std::vector<uint8_t> controls((values.size() + 3) / 4, 0);
+        std::vector<uint8_t> bytes;
+        bytes.reserve(values.size() * 2);
+
+        for(size_t i = 0; i < values.size(); i++) {
+            uint32_t value = values[i];
+            uint8_t code = value == 0 ? 0 : value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : 3;
+
+            controls[i / 4] |= static_cast<uint8_t>(code << ((i % 4) * 2));
+            for(uint8_t byte = 0; byte < CODE_LENGTHS[code]; byte++) {
+                bytes.push_back(static_cast<uint8_t>(value >> (byte * 8)));
+            }
+        }
+
+        appendSize(data, controls.size() + bytes.size());
+        data.insert(data.end(), controls.begin(), controls.end());
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+
+    template<typename T, typename Get>
+    void appendChannel(std::vector<uint8_t> & data, size_t count, Get const & get) {
+        std::vector<uint32_t> values(count);
+        T previous = 0;
+
+        for(size_t i = 0; i < count; i++) {
+            T value = get(i);
+            values[i] = zigzagDelta<T>(value, previous);
+            previous = value;
+        }
+
+        appendStream(data, values);
+    }
+
+    void appendRaw(std::vector<uint8_t> & data, void const * raw, size_t size) {
+        uint8_t const * bytes = static_cast<uint8_t const *>(raw);
+        appendSize(data, size);
+        data.insert(data.end(), bytes, bytes + size);
+    }
+
+    // the 4 values of one control byte starting at bytes, little endian
+    inline void readGroup(uint8_t control, uint8_t const * bytes, uint32_t * values) {
+        for(int lane = 0; lane < 4; lane++) {
+            uint8_t length = CODE_LENGTHS[(control >> (lane * 2)) & 3];
+            uint32_t value = 0;
+            for(uint8_t byte = 0; byte < length; byte++) {
+                value |= static_cast<uint32_t>(bytes[byte]) << (byte * 8);
+            }
+            values[lane] = value;
+            bytes += length;
+        }
+    }
+
+#if defined(MESH_CODEC_SSSE3)
+    // as readGroup(...) into the lanes of a register, bytes has 16 readable bytes
+    inline __m128i readGroup(uint8_t control, uint8_t const * bytes, DecodeTables const & tables) {
+        __m128i packed  = _mm_loadu_si128(reinterpret_cast<__m128i const *>(bytes));
+        __m128i shuffle = _mm_load_si128(reinterpret_cast<__m128i const *>(tables.shuffles[control]));
+        return _mm_shuffle_epi8(packed, shuffle);
+    }
+#endif
+
+#if defined(MESH_CODEC_SSE2)
+    // zigzagged differences back into values, running holds the value before them in every lane and is left holding the last
+    inline __m128i undoDeltas(__m128i zigzagged, __m128i & running) {
+        __m128i const one = _mm_set1_epi32(1);
+        __m128i delta = _mm_xor_si128(_mm_srli_epi32(zigzagged, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(zigzagged, one)));
+
+        // prefix sum across the 4 lanes
+        delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 4));
+        delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 8));
+        delta = _mm_add_epi32(delta, running);
+
+        running = _mm_shuffle_epi32(delta, _MM_SHUFFLE(3, 3, 3, 3));
+        return delta;
+    }
+#endif
+
+    /*
+        StreamDecoder
+
+        - decodes a stream written by appendStream(...) a block of values at a time, so several
+          streams can be decoded side by side into one array of structs
+        - open(...) is false when the stream's length does not match its control bytes
+    */
+    class StreamDecoder {
+    public:
+        StreamDecoder()
+        :   m_tables(decodeTables())
+        ,   m_control(nullptr)
+        ,   m_bytes(nullptr)
+        ,   m_previous(0)
+        {
+            // empty
+        }
+
+        bool open(uint8_t const * stream, size_t size, size_t count) {
+            size_t const controlSize = (count + 3) / 4;
+            if(size < controlSize) {
+                return false;
+            }
+
+            m_control = stream;
+            m_bytes = stream + controlSize;
+            m_previous = 0;
+
+            // the control bytes give the length of the rest, checked up front so decoding never reads past it
+            size_t expected = 0;
+            for(size_t c = 0; c < controlSize; c++) {
+                expected += m_tables.lengths[stream[c]];
+            }
+
+            return expected == size - controlSize;
+        }
+
+        // the next count values, count is a multiple of 4 except at the end, values has room for a whole group
+        void decode(uint32_t * values, size_t count) {
+            size_t const groupCount = (count + 3) / 4;
+
+            // values past the end of the last group are written as 0 differences, they leave m_previous alone
+#if defined(MESH_CODEC_SSSE3)
+            __m128i running = _mm_set1_epi32(static_cast<int>(m_previous));
+
+            for(size_t group = 0; group < groupCount; group++) {
+                uint8_t code = *m_control++;
+                __m128i decoded = undoDeltas(readGroup(code, m_bytes, m_tables), running);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(values + group * 4), decoded);
+                m_bytes += m_tables.lengths[code];
+            }
+
+            m_previous = static_cast<uint32_t>(_mm_cvtsi128_si32(running));
+#else
+            // without a byte shuffle the groups are read first, then the differences undone in a second pass
+            for(size_t group = 0; group < groupCount; group++) {
+                uint8_t code = *m_control++;
+                readGroup(code, m_bytes, values + group * 4);
+                m_bytes += m_tables.lengths[code];
+            }
+
+#if defined(MESH_CODEC_SSE2)
+            __m128i running = _mm_set1_epi32(static_cast<int>(m_previous));
+
+            for(size_t group = 0; group < groupCount; group++) {
+                __m128i * lanes = reinterpret_cast<__m128i *>(values + group * 4);
+                _mm_storeu_si128(lanes, undoDeltas(_mm_loadu_si128(lanes), running));
+            }
+
+            m_previous = static_cast<uint32_t>(_mm_cvtsi128_si32(running));
+#else
+            for(size_t i = 0; i < groupCount * 4; i++) {
+                uint32_t zigzagged = values[i];
+                m_previous += (zigzagged >> 1) ^ (0u - (zigzagged & 1));
+                values[i] = m_previous;
+            }
+#endif
+#endif
+        }
+
+    private:
+        DecodeTables const & m_tables;
+        uint8_t const *      m_control;
+        uint8_t const *      m_bytes;
+        uint32_t             m_previous;
+    };
+
+    // walks the size prefixed streams of a CompressedMesh's data
+    class StreamReader {
+    public:
+        explicit StreamReader(std::vector<uint8_t> const & data)
+        :   m_cursor(data.data())
+        ,   m_end(data.data() + data.size() - STREAM_PADDING)
+        {
+            // empty
+        }
+
+        bool next(uint8_t const * & stream, size_t & size) {
+            uint32_t size32;
+            if(static_cast<size_t>(m_end - m_cursor) < sizeof(size32)) {
+                return false;
+            }
+
+            std::memcpy(&size32, m_cursor, sizeof(size32));
+            m_cursor += sizeof(size32);
+
+            if(size32 > static_cast<size_t>(m_end - m_cursor)) {
+                return false;
+            }
+
+            stream = m_cursor;
+            size = size32;
+            m_cursor += size32;
+            return true;
+        }
+
+        bool atEnd() const {
+            return m_cursor == m_end;
+        }
+
+    private:
+        uint8_t const * m_cursor;
+        uint8_t const * m_end;
+    };
+}
+
+//------------------------------------------------------------
+CompressedMesh
+compressMesh(PackedMesh const & mesh) {
+    CompressedMesh compressed;
+    compressed.vertexCount          = static_cast<uint32_t>(mesh.vertices.size());
+    compressed.indexCount           = static_cast<uint32_t>(mesh.indices.size());
+    compressed.clusterCount         = static_cast<uint32_t>(mesh.meshlets.clusters.size());
+    compressed.meshletVertexCount   = static_cast<uint32_t>(mesh.meshlets.vertices.size());
+    compressed.meshletTriangleCount = static_cast<uint32_t>(mesh.meshlets.triangles.size());
+    compressed.positionScale        = mesh.positionScale;
+    compressed.positionOffset       = mesh.positionOffset;
+    compressed.bounds               = mesh.bounds;
+
+    std::vector<uint8_t> & data = compressed.data;
+    std::vector<PackedVertex> const & vertices = mesh.vertices;
+
+    appendChannel<uint32_t>(data, mesh.indices.size(), [&mesh](size_t i) { return static_cast<uint32_t>(mesh.indices[i]); });
+
+    for(int axis = 0; axis < 3; axis++) {
+        appendChannel<uint16_t>(data, vertices.size(), [&vertices, axis](size_t i) { return vertices[i].position[axis]; });
+    }
+    for(int axis = 0; axis < 2; axis++) {
+        appendChannel<uint16_t>(data, vertices.size(), [&vertices, axis](size_t i) { return vertices[i].texCoord[axis]; });
+    }
+    for(int channel = 0; channel < 4; channel++) {
+        appendChannel<uint8_t>(data, vertices.size(), [&vertices, channel](size_t i) { return vertices[i].colour[channel]; });
+    }
+
+    appendChannel<uint32_t>(data, mesh.meshlets.vertices.size(), [&mesh](size_t i) { return static_cast<uint32_t>(mesh.meshlets.vertices[i]); });
+    appendRaw(data, mesh.meshlets.clusters.data(), mesh.meshlets.clusters.size() * sizeof(Meshlet));
+    appendRaw(data, mesh.meshlets.triangles.data(), mesh.meshlets.triangles.size());
+
+    data.insert(data.end(), STREAM_PADDING, 0);
+    return compressed;
+}
+
+//------------------------------------------------------------
+bool
+decompressMesh(CompressedMesh const & compressed, PackedMesh & mesh) {
+    auto damaged = [](char const * what) {
+        std::cerr << "compressed mesh is damaged: " << what << std::endl;
+        return false;
+    };
+
+    if(compressed.data.size() < STREAM_PADDING) {
+        return damaged("no streams");
+    }
+
+    // every value takes at least its share of a control byte, or its raw bytes, so counts the data can not
+    // hold are refused before anything is allocated from them
+    auto controlBytes = [](uint64_t count) { return (count + 3) / 4; };
+    uint64_t const minimumSize = (VERTEX_STREAMS + 4) * sizeof(uint32_t)
+                               + controlBytes(compressed.indexCount)
+                               + controlBytes(compressed.vertexCount) * VERTEX_STREAMS
+                               + controlBytes(compressed.meshletVertexCount)
+                               + static_cast<uint64_t>(compressed.clusterCount) * sizeof(Meshlet)
+                               + compressed.meshletTriangleCount;
+
+    if(minimumSize > compressed.data.size() - STREAM_PADDING) {
+        return damaged("counts larger than the data");
+    }
+
+    mesh.vertices.resize(compressed.vertexCount);
+    mesh.indices.resize(compressed.indexCount);
+    mesh.meshlets.clusters.resize(compressed.clusterCount);
+    mesh.meshlets.vertices.resize(compressed.meshletVertexCount);
+    mesh.meshlets.triangles.resize(compressed.meshletTriangleCount);
+    mesh.positionScale  = compressed.positionScale;
+    mesh.positionOffset = compressed.positionOffset;
+    mesh.bounds         = compressed.bounds;
+
+    StreamReader reader(compressed.data);
+    uint8_t const * stream;
+    size_t size;
+
+    alignas(16) uint32_t block[VERTEX_STREAMS][DECODE_BLOCK];
+
+    // a stream of unsigned int straight into array, false when any is not below limit as the renderer does not check
+    auto decodeIndices = [&](std::vector<unsigned int> & array, size_t limit) {
+        StreamDecoder decoder;
+        if(!reader.next(stream, size) || !decoder.open(stream, size, array.size())) {
+            return false;
+        }
+
+        // whole groups go straight into array, the last few through the scratch
+        size_t const whole = array.size() / 4 * 4;
+        decoder.decode(array.data(), whole);
+        decoder.decode(block[0], array.size() - whole);
+        std::copy(block[0], block[0] + (array.size() - whole), array.data() + whole);
+
+        unsigned int maxValue = 0;
+        for(unsigned int value : array) {
+            maxValue = std::max(maxValue, value);
+        }
+
+        return array.empty() || maxValue < limit;
+    };
+
+    if(!decodeIndices(mesh.indices, mesh.vertices.size())) {
+        return damaged("indices");
+    }
+
+    // every channel a block at a time, so the vertices are written in one pass
+    StreamDecoder decoders[VERTEX_STREAMS];
+    for(size_t s = 0; s < VERTEX_STREAMS; s++) {
+        if(!reader.next(stream, size) || !decoders[s].open(stream, size, mesh.vertices.size())) {
+            return damaged("vertices");
+        }
+    }
+
+    for(size_t first = 0; first < mesh.vertices.size(); first += DECODE_BLOCK) {
+        size_t const count = std::min(DECODE_BLOCK, mesh.vertices.size() - first);
+        for(size_t s = 0; s < VERTEX_STREAMS; s++) {
+            decoders[s].decode(block[s], count);
+        }
+
+        PackedVertex * vertices = mesh.vertices.data() + first;
+        for(size_t i = 0; i < count; i++) {
+            vertices[i].position[0] = static_cast<uint16_t>(block[0][i]);
+            vertices[i].position[1] = static_cast<uint16_t>(block[1][i]);
+            vertices[i].position[2] = static_cast<uint16_t>(block[2][i]);
+            vertices[i].texCoord[0] = static_cast<uint16_t>(block[3][i]);
+            vertices[i].texCoord[1] = static_cast<uint16_t>(block[4][i]);
+            vertices[i].colour[0]   = static_cast<uint8_t>(block[5][i]);
+            vertices[i].colour[1]   = static_cast<uint8_t>(block[6][i]);
+            vertices[i].colour[2]   = static_cast<uint8_t>(block[7][i]);
+            vertices[i].colour[3]   = static_cast<uint8_t>(block[8][i]);
+        }
+    }
+
+    if(!decodeIndices(mesh.meshlets.vertices, mesh.vertices.size())) {
+        return damaged("meshlet vertices");
+    }
+
+    if(!reader.next(stream, size) || size != mesh.meshlets.clusters.size() * sizeof(Meshlet)) {
+        return damaged("meshlets");
+    }
+    std::memcpy(static_cast<void *>(mesh.meshlets.clusters.data()), stream, size);
+
+    if(!reader.next(stream, size) || size != mesh.meshlets.triangles.size()) {
+        return damaged("meshlet triangles");
+    }
+    std::memcpy(mesh.meshlets.triangles.data(), stream, size);
+
+    Meshlets const & meshlets = mesh.meshlets;
+    if(!reader.atEnd() || !meshletsFit(meshlets.clusters.data(), meshlets.clusters.size(), meshlets.vertices.data(), meshlets.vertices.size(),
+                                       meshlets.triangles.data(), meshlets.triangles.size(), mesh.vertices.size())) {
+        return damaged("meshlets");
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------
+bool
+writeCompressedMeshFile(std::string const & filePath, std::vector<CompressedMesh> const & meshes) {
+    std::ofstream file(filePath, std::ios::binary);
+
+    if(!file.is_open()) {
+        std::cerr << "could not open " << filePath << " for writing" << std::endl;
+        return false;
+    }
+
+    CompressedMeshFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version     = MESH_CODEC_VERSION;
+    header.byteOrder   = BYTE_ORDER_MARK;
+    header.meshletSize = sizeof(Meshlet);
+    header.meshCount   = static_cast<uint32_t>(meshes.size());
+    header.fileSize    = sizeof(header);
+
+    for(auto const & mesh : meshes) {
+        header.fileSize += sizeof(CompressedMeshFileEntry) + mesh.data.size();
+    }
+
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+    for(auto const & mesh : meshes) {
+        CompressedMeshFileEntry entry;
+        std::memset(static_cast<void *>(&entry), 0, sizeof(entry));
+        entry.vertexCount          = mesh.vertexCount;
+        entry.indexCount           = mesh.indexCount;
+        entry.clusterCount         = mesh.clusterCount;
+        entry.meshletVertexCount   = mesh.meshletVertexCount;
+        entry.meshletTriangleCount = mesh.meshletTriangleCount;
+        entry.positionScale[0]     = mesh.positionScale.x;
+        entry.positionScale[1]     = mesh.positionScale.y;
+        entry.positionScale[2]     = mesh.positionScale.z;
+        entry.positionOffset[0]    = mesh.positionOffset.x;
+        entry.positionOffset[1]    = mesh.positionOffset.y;
+        entry.positionOffset[2]    = mesh.positionOffset.z;
+        entry.bounds               = mesh.bounds;
+        entry.dataSize             = mesh.data.size();
+
+        file.write(reinterpret_cast<char const *>(&entry), sizeof(entry));
+        file.write(reinterpret_cast<char const *>(mesh.data.data()), static_cast<std::streamsize>(mesh.data.size()));
+    }
+
+    if(!file.good()) {
+        std::cerr << "could not write " << filePath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------
+std::vector<CompressedMesh>
+loadCompressedMeshFile(std::string const & filePath) {
+    std::vector<CompressedMesh> meshes;
+
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if(!file.is_open()) {
+        std::cerr << "could not open " << filePath << std::endl;
+        return meshes;
+    }
+
+    uint64_t const fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    CompressedMeshFileHeader header;
+    if(fileSize < sizeof(header) || !file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+        std::cerr << filePath << " is not a compressed mesh file" << std::endl;
+        return meshes;
+    }
+
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != MESH_CODEC_VERSION) {
+        std::cerr << filePath << " is not a version " << MESH_CODEC_VERSION << " compressed mesh file" << std::endl;
+        return meshes;
+    }
+
+    if(header.byteOrder != BYTE_ORDER_MARK || header.meshletSize != sizeof(Meshlet)) {
+        std::cerr << filePath << " was written on a different kind of machine" << std::endl;
+        return meshes;
+    }
+
+    if(header.fileSize != fileSize) {
+        std::cerr << filePath << " is truncated" << std::endl;
+        return meshes;
+    }
+
+    if(header.meshCount > (fileSize - sizeof(header)) / sizeof(CompressedMeshFileEntry)) {
+        std::cerr << filePath << " is truncated" << std::endl;
+        return meshes;
+    }
+
+    uint64_t position = sizeof(header);
+    meshes.resize(header.meshCount);
+
+    for(auto & mesh : meshes) {
+        CompressedMeshFileEntry entry;
+        if(fileSize - position < sizeof(entry) || !file.read(reinterpret_cast<char *>(&entry), sizeof(entry))) {
+            std::cerr << filePath << " is truncated" << std::endl;
+            return std::vector<CompressedMesh>();
+        }
+        position += sizeof(entry);
+
+        if(entry.dataSize > fileSize - position) {
+            std::cerr << filePath << " is truncated" << std::endl;
+            return std::vector<CompressedMesh>();
+        }
+
+        mesh.vertexCount          = entry.vertexCount;
+        mesh.indexCount           = entry.indexCount;
+        mesh.clusterCount         = entry.clusterCount;
+        mesh.meshletVertexCount   = entry.meshletVertexCount;
+        mesh.meshletTriangleCount = entry.meshletTriangleCount;
+        mesh.positionScale        = djc_math::Vec3f(entry.positionScale[0], entry.positionScale[1], entry.positionScale[2]);
+        mesh.positionOffset       = djc_math::Vec3f(entry.positionOffset[0], entry.positionOffset[1], entry.positionOffset[2]);
+        mesh.bounds               = entry.bounds;
+
+        mesh.data.resize(static_cast<size_t>(entry.dataSize));
+        file.read(reinterpret_cast<char *>(mesh.data.data()), static_cast<std::streamsize>(mesh.data.size()));
+        position += entry.dataSize;
+    }
+
+    if(!file.good()) {
+        std::cerr << "could not read " << filePath << std::endl;
+        return std::vector<CompressedMesh>();
+    }
+
+    return meshes;
+}
+
+//------------------------------------------------------------
+char const *
+getMeshCodecPath() {
+#if defined(MESH_CODEC_SSSE3)
+    return "SSSE3";
+#elif defined(MESH_CODEC_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,108 @@
+#ifndef MeshCompression_hpp
+#define MeshCompression_hpp
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// my
+#include "Bounds.hpp"
+#include "PackedMesh.hpp"
+#include "djc_math/Vec3.hpp"
+
+// my defines
+#define MESH_CODEC_VERSION 1
+
+/*
+    CompressedMesh
+
+    - a PackedMesh with every array encoded into data, small enough to keep resident for meshes
+      that are rarely drawn and decoded with decompressMesh(...) when they are
+    - data is one stream per array: the indices, each position, texture coordinate and colour
+      channel, the meshlet vertices, then the meshlet clusters and triangles as they are
+    - integer streams hold the difference from the previous value, so runs of neighbouring
+      vertices and rising indices are small numbers. differences are zigzagged and stored in 0, 1,
+      2 or 4 bytes, with 2 bit lengths for 4 values packed into a control byte ahead of the bytes
+      (stream vbyte), which a 16 byte shuffle decodes 4 values at a time
+*/
+struct CompressedMesh {
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t clusterCount;
+    uint32_t meshletVertexCount;
+    uint32_t meshletTriangleCount;
+    djc_math::Vec3f positionScale;
+    djc_math::Vec3f positionOffset;
+    Bounds bounds;
+    std::vector<uint8_t> data;
+};
+
+/*
+    compressed mesh file layout (.srmeshz)
+
+    - CompressedMeshFileHeader, then per mesh a CompressedMeshFileEntry followed by its data
+    - meshlet clusters are stored as they are in memory, so like .srmesh files are only read on
+      the kind of machine that wrote them, the header records the byte order and Meshlet size
+*/
+struct CompressedMeshFileHeader {
+    char     magic[8];    // "SRMESHZ" followed by a zero
+    uint32_t version;
+    uint32_t byteOrder;   // 0x01020304 as written
+    uint32_t meshletSize; // sizeof(Meshlet)
+    uint32_t meshCount;
+    uint64_t fileSize;
+};
+
+struct CompressedMeshFileEntry {
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t clusterCount;
+    uint32_t meshletVertexCount;
+    uint32_t meshletTriangleCount;
+    uint32_t reserved;
+    float    positionScale[3];
+    float    positionOffset[3];
+    Bounds   bounds;
+    uint64_t dataSize;
+};
+
+/*
+    compressMesh(...)
+
+    - encodes every array of mesh, run packMesh(...) first on a Mesh
+    - positions are predicted from the vertex before, so compress cache ordered meshes, the
+      loaders and weldMesh(...) already give those
+*/
+CompressedMesh compressMesh(PackedMesh const & mesh);
+
+/*
+    decompressMesh(...)
+
+    - decodes into mesh, reusing its arrays' storage
+    - counts are checked against the size of the data before anything is allocated from them
+    - checks every stream's length, that indices and meshlet vertices are in range and that the
+      meshlets lie inside their arrays, so damaged data can not make the renderer read out of bounds
+    - returns false and prints to std::cerr if the data is damaged
+*/
+bool decompressMesh(CompressedMesh const & compressed, PackedMesh & mesh);
+
+/*
+    writeCompressedMeshFile(...)
+
+    - returns false and prints to std::cerr if the file could not be written
+*/
+bool writeCompressedMeshFile(std::string const & filePath, std::vector<CompressedMesh> const & meshes);
+
+/*
+    loadCompressedMeshFile(...)
+
+    - reads every mesh of a .srmeshz file, still compressed
+    - returns an empty vector if the file could not be opened or is not a compressed mesh file
+*/
+std::vector<CompressedMesh> loadCompressedMeshFile(std::string const & filePath);
+
+// the instruction set the stream decoder was compiled for: "SSSE3", "SSE2" or "scalar"
+char const * getMeshCodecPath();
+
+#endif /* MeshCompression_hpp */
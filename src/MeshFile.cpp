@@ -0,0 +1,396 @@
+// std
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+// my
+#include "MeshFile.hpp"
+
+// dependancies
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable<Vertex>::value, "vertices are written and mapped as they are in memory");
+static_assert(std::is_trivially_copyable<Meshlet>::value, "meshlets are written and mapped as they are in memory");
+static_assert(std::is_trivially_copyable<Bounds>::value, "bounds are written and mapped as they are in memory");
+
+namespace {
+    const char     MAGIC[8]   = { 'S', 'R', 'M', 'E', 'S', 'H', 0, 0 };
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    uint64_t alignUp(uint64_t offset) {
+        return (offset + MESH_FILE_ALIGNMENT - 1) & ~static_cast<uint64_t>(MESH_FILE_ALIGNMENT - 1);
+    }
+
+    // a blob of count elements of elementSize at offset lies inside a file of fileSize bytes
+    bool blobFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize) {
+        if(offset % MESH_FILE_ALIGNMENT != 0 || offset > fileSize) {
+            return false;
+        }
+        return count <= (fileSize - offset) / elementSize;
+    }
+
+    bool indicesFit(unsigned int const * indices, size_t count, size_t vertexCount) {
+        unsigned int maxIndex = 0;
+        for(size_t i = 0; i < count; i++) {
+            maxIndex = std::max(maxIndex, indices[i]);
+        }
+        return count == 0 || maxIndex < vertexCount;
+    }
+
+    template<typename T>
+    void writeBlob(std::ofstream & file, uint64_t & position, uint64_t offset, std::vector<T> const & data) {
+        static char const padding[MESH_FILE_ALIGNMENT] = {};
+        file.write(padding, static_cast<std::streamsize>(offset - position));
+        file.write(reinterpret_cast<char const *>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(T)));
+        position = offset + data.size() * sizeof(T);
+    }
+
+    template<typename T>
+    std::vector<T> copyBlob(T const * data, size_t count) {
+        return std::vector<T>(data, data + count);
+    }
+
+    // one table entry to be, a mesh or one level of a chain
+    struct FileMesh {
+        Mesh const * mesh;
+        uint32_t     lodLevel;
+        float        lodError;
+    };
+
+    // header, table and every blob, shared by writeMeshFile(...) and writeLodChains(...)
+    bool writeFileMeshes(std::string const & filePath, std::vector<FileMesh> const & meshes) {
+        std::ofstream file(filePath, std::ios::binary);
+
+        if(!file.is_open()) {
+            std::cerr << "could not open " << filePath << " for writing" << std::endl;
+            return false;
+        }
+
+        // lay every blob out first, the table holds their offsets, entries start zeroed padding and all
+        std::vector<MeshFileEntry> entries(meshes.size());
+        uint64_t offset = sizeof(MeshFileHeader) + meshes.size() * sizeof(MeshFileEntry);
+
+        auto place = [&offset](uint64_t count, uint64_t elementSize) -> uint64_t {
+            uint64_t start = alignUp(offset);
+            offset = start + count * elementSize;
+            return start;
+        };
+
+        for(size_t i = 0; i < meshes.size(); i++) {
+            Mesh const & mesh = *meshes[i].mesh;
+            MeshFileEntry & entry = entries[i];
+
+            entry.vertexCount           = mesh.vertices.size();
+            entry.vertexOffset          = place(entry.vertexCount, sizeof(Vertex));
+            entry.indexCount            = mesh.indices.size();
+            entry.indexOffset           = place(entry.indexCount, sizeof(unsigned int));
+            entry.clusterCount          = mesh.meshlets.clusters.size();
+            entry.clusterOffset         = place(entry.clusterCount, sizeof(Meshlet));
+            entry.meshletVertexCount    = mesh.meshlets.vertices.size();
+            entry.meshletVertexOffset   = place(entry.meshletVertexCount, sizeof(unsigned int));
+            entry.meshletTriangleCount  = mesh.meshlets.triangles.size();
+            entry.meshletTriangleOffset = place(entry.meshletTriangleCount, sizeof(uint8_t));
+            entry.lodLevel              = meshes[i].lodLevel;
+            entry.lodError              = meshes[i].lodError;
+            entry.bounds                = mesh.bounds;
+        }
+
+        MeshFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version     = MESH_FILE_VERSION;
+        header.byteOrder   = BYTE_ORDER_MARK;
+        header.vertexSize  = sizeof(Vertex);
+        header.meshletSize = sizeof(Meshlet);
+        header.meshCount   = static_cast<uint32_t>(meshes.size());
+        header.fileSize    = offset;
+
+        file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        file.write(reinterpret_cast<char const *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(MeshFileEntry)));
+
+        uint64_t position = sizeof(MeshFileHeader) + meshes.size() * sizeof(MeshFileEntry);
+        for(size_t i = 0; i < meshes.size(); i++) {
+            writeBlob(file, position, entries[i].vertexOffset, meshes[i].mesh->vertices);
+            writeBlob(file, position, entries[i].indexOffset, meshes[i].mesh->indices);
+            writeBlob(file, position, entries[i].clusterOffset, meshes[i].mesh->meshlets.clusters);
+            writeBlob(file, position, entries[i].meshletVertexOffset, meshes[i].mesh->meshlets.vertices);
+            writeBlob(file, position, entries[i].meshletTriangleOffset, meshes[i].mesh->meshlets.triangles);
+        }
+
+        if(!file.good()) {
+            std::cerr << "could not write " << filePath << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+}
+
+//------------------------------------------------------------
+MappedMeshFile::MappedMeshFile()
+:   m_data(nullptr)
+,   m_size(0)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+MappedMeshFile::~MappedMeshFile() {
+    close();
+}
+
+//------------------------------------------------------------
+bool
+MappedMeshFile::open(std::string const & filePath) {
+    close();
+
+#if !defined(_WIN32)
+    int descriptor = ::open(filePath.c_str(), O_RDONLY);
+    if(descriptor < 0) {
+        std::cerr << "could not open " << filePath << std::endl;
+        return false;
+    }
+
+    struct stat status;
+    if(fstat(descriptor, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(MeshFileHeader))) {
+        std::cerr << filePath << " is not a mesh file" << std::endl;
+        ::close(descriptor);
+        return false;
+    }
+
+    void * mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor); // the mapping keeps the file alive
+
+    if(mapping == MAP_FAILED) {
+        std::cerr << "could not map " << filePath << std::endl;
+        return false;
+    }
+
+    m_data = static_cast<unsigned char const *>(mapping);
+    m_size = static_cast<size_t>(status.st_size);
+#else
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if(!file.is_open()) {
+        std::cerr << "could not open " << filePath << std::endl;
+        return false;
+    }
+
+    m_size = static_cast<size_t>(file.tellg());
+    m_buffer.resize((m_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(m_buffer.data()), static_cast<std::streamsize>(m_size));
+
+    if(!file) {
+        std::cerr << "could not read " << filePath << std::endl;
+        m_buffer = std::vector<uint64_t>();
+        m_size = 0;
+        return false;
+    }
+
+    m_data = reinterpret_cast<unsigned char const *>(m_buffer.data());
+#endif
+
+    if(!validate(filePath)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------
+void
+MappedMeshFile::close() {
+#if !defined(_WIN32)
+    if(m_data) {
+        munmap(const_cast<unsigned char *>(m_data), m_size);
+    }
+#else
+    m_buffer = std::vector<uint64_t>();
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+//------------------------------------------------------------
+bool
+MappedMeshFile::isOpen() const {
+    return m_data != nullptr;
+}
+
+//------------------------------------------------------------
+size_t
+MappedMeshFile::getMeshCount() const {
+    return m_data ? reinterpret_cast<MeshFileHeader const *>(m_data)->meshCount : 0;
+}
+
+//------------------------------------------------------------
+MeshView
+MappedMeshFile::getMesh(size_t index) const {
+    MeshFileEntry const & entry = reinterpret_cast<MeshFileEntry const *>(m_data + sizeof(MeshFileHeader))[index];
+
+    MeshView view;
+    view.vertices             = reinterpret_cast<Vertex const *>(m_data + entry.vertexOffset);
+    view.vertexCount          = static_cast<size_t>(entry.vertexCount);
+    view.indices              = reinterpret_cast<unsigned int const *>(m_data + entry.indexOffset);
+    view.indexCount           = static_cast<size_t>(entry.indexCount);
+    view.clusters             = reinterpret_cast<Meshlet const *>(m_data + entry.clusterOffset);
+    view.clusterCount         = static_cast<size_t>(entry.clusterCount);
+    view.meshletVertices      = reinterpret_cast<unsigned int const *>(m_data + entry.meshletVertexOffset);
+    view.meshletVertexCount   = static_cast<size_t>(entry.meshletVertexCount);
+    view.meshletTriangles     = m_data + entry.meshletTriangleOffset;
+    view.meshletTriangleCount = static_cast<size_t>(entry.meshletTriangleCount);
+    view.lodLevel             = entry.lodLevel;
+    view.lodError             = entry.lodError;
+    view.bounds               = entry.bounds;
+    return view;
+}
+
+//------------------------------------------------------------
+Mesh
+MappedMeshFile::copyMesh(size_t index) const {
+    MeshView view = getMesh(index);
+
+    Mesh mesh;
+    mesh.vertices           = copyBlob(view.vertices, view.vertexCount);
+    mesh.indices            = copyBlob(view.indices, view.indexCount);
+    mesh.bounds             = view.bounds;
+    mesh.meshlets.clusters  = copyBlob(view.clusters, view.clusterCount);
+    mesh.meshlets.vertices  = copyBlob(view.meshletVertices, view.meshletVertexCount);
+    mesh.meshlets.triangles = copyBlob(view.meshletTriangles, view.meshletTriangleCount);
+    return mesh;
+}
+
+/* PRIVATE */
+
+//------------------------------------------------------------
+bool
+MappedMeshFile::validate(std::string const & filePath) const {
+    if(m_size < sizeof(MeshFileHeader)) {
+        std::cerr << filePath << " is not a mesh file" << std::endl;
+        return false;
+    }
+
+    MeshFileHeader const & header = *reinterpret_cast<MeshFileHeader const *>(m_data);
+
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << filePath << " is not a mesh file" << std::endl;
+        return false;
+    }
+
+    if(header.version != MESH_FILE_VERSION || header.byteOrder != BYTE_ORDER_MARK
+    || header.vertexSize != sizeof(Vertex) || header.meshletSize != sizeof(Meshlet)) {
+        std::cerr << filePath << " was written by a different version or machine, convert it again" << std::endl;
+        return false;
+    }
+
+    if(header.fileSize != m_size || header.meshCount > (m_size - sizeof(MeshFileHeader)) / sizeof(MeshFileEntry)) {
+        std::cerr << filePath << " is truncated" << std::endl;
+        return false;
+    }
+
+    MeshFileEntry const * entries = reinterpret_cast<MeshFileEntry const *>(m_data + sizeof(MeshFileHeader));
+    for(uint32_t i = 0; i < header.meshCount; i++) {
+        MeshFileEntry const & entry = entries[i];
+
+        if(!blobFits(entry.vertexOffset, entry.vertexCount, sizeof(Vertex), m_size)
+        || !blobFits(entry.indexOffset, entry.indexCount, sizeof(unsigned int), m_size)
+        || !blobFits(entry.clusterOffset, entry.clusterCount, sizeof(Meshlet), m_size)
+        || !blobFits(entry.meshletVertexOffset, entry.meshletVertexCount, sizeof(unsigned int), m_size)
+        || !blobFits(entry.meshletTriangleOffset, entry.meshletTriangleCount, sizeof(uint8_t), m_size)) {
+            std::cerr << filePath << " mesh " << i << " points outside the file" << std::endl;
+            return false;
+        }
+
+        // the renderer indexes with these unchecked, a damaged file must not get that far
+        auto at = [this](uint64_t offset) { return m_data + offset; };
+        if(!indicesFit(reinterpret_cast<unsigned int const *>(at(entry.indexOffset)), entry.indexCount, entry.vertexCount)
+        || !meshletsFit(reinterpret_cast<Meshlet const *>(at(entry.clusterOffset)), entry.clusterCount,
+                        reinterpret_cast<unsigned int const *>(at(entry.meshletVertexOffset)), entry.meshletVertexCount,
+                        at(entry.meshletTriangleOffset), entry.meshletTriangleCount, entry.vertexCount)) {
+            std::cerr << filePath << " mesh " << i << " indexes outside its arrays" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------
+bool
+writeMeshFile(std::string const & filePath, std::vector<Mesh> const & meshes) {
+    std::vector<FileMesh> fileMeshes;
+    fileMeshes.reserve(meshes.size());
+
+    for(auto const & mesh : meshes) {
+        fileMeshes.push_back(FileMesh{ &mesh, 0, 0.0f });
+    }
+
+    return writeFileMeshes(filePath, fileMeshes);
+}
+
+//------------------------------------------------------------
+bool
+writeLodChains(std::string const & filePath, std::vector<LodChain> const & chains) {
+    std::vector<FileMesh> fileMeshes;
+
+    for(auto const & chain : chains) {
+        for(size_t level = 0; level < chain.levels.size(); level++) {
+            fileMeshes.push_back(FileMesh{ &chain.levels[level].mesh, static_cast<uint32_t>(level), chain.levels[level].error });
+        }
+    }
+
+    return writeFileMeshes(filePath, fileMeshes);
+}
+
+//------------------------------------------------------------
+std::vector<Mesh>
+loadMeshFile(std::string const & filePath) {
+    std::vector<Mesh> meshes;
+
+    MappedMeshFile file;
+    if(!file.open(filePath)) {
+        return meshes;
+    }
+
+    meshes.reserve(file.getMeshCount());
+    for(size_t i = 0; i < file.getMeshCount(); i++) {
+        meshes.push_back(file.copyMesh(i));
+    }
+
+    return meshes;
+}
+
+//------------------------------------------------------------
+std::vector<LodChain>
+loadLodChains(std::string const & filePath) {
+    std::vector<LodChain> chains;
+
+    MappedMeshFile file;
+    if(!file.open(filePath)) {
+        return chains;
+    }
+
+    for(size_t i = 0; i < file.getMeshCount(); i++) {
+        MeshView view = file.getMesh(i);
+
+        if(view.lodLevel == 0 || chains.empty()) {
+            chains.emplace_back();
+        }
+
+        MeshLod lod;
+        lod.mesh = file.copyMesh(i);
+        lod.error = view.lodError;
+        chains.back().levels.push_back(std::move(lod));
+    }
+
+    return chains;
+}
@@ -0,0 +1,148 @@
+#ifndef MeshFile_hpp
+#define MeshFile_hpp
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// my
+#include "Bounds.hpp"
+#include "Lod.hpp"
+#include "Mesh.hpp"
+#include "Meshlet.hpp"
+#include "Vertex.hpp"
+
+// my defines
+#define MESH_FILE_VERSION   2
+#define MESH_FILE_ALIGNMENT 64 // every blob starts on a cache line
+
+/*
+    mesh file layout (.srmesh)
+
+    - MeshFileHeader, then meshCount MeshFileEntry, then the blobs each entry points at
+    - blobs are the in memory arrays of a Mesh written as they are, Vertex, unsigned int, Meshlet
+      and uint8_t, so a mapped file is used in place
+    - written and read on the same kind of machine, the header records the byte order and the
+      struct sizes it was written with and files that do not match are refused
+*/
+struct MeshFileHeader {
+    char     magic[8];       // "SRMESH" followed by two zeros
+    uint32_t version;
+    uint32_t byteOrder;      // 0x01020304 as written
+    uint32_t vertexSize;     // sizeof(Vertex)
+    uint32_t meshletSize;    // sizeof(Meshlet)
+    uint32_t meshCount;
+    uint32_t reserved;
+    uint64_t fileSize;
+};
+
+// offsets are in bytes from the start of the file, counts in elements
+struct MeshFileEntry {
+    uint64_t vertexOffset;
+    uint64_t vertexCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    uint64_t clusterOffset;
+    uint64_t clusterCount;
+    uint64_t meshletVertexOffset;
+    uint64_t meshletVertexCount;
+    uint64_t meshletTriangleOffset;
+    uint64_t meshletTriangleCount; // local indices, 3 per triangle
+    uint32_t lodLevel;             // 0 starts a lod chain, meshes written without one are all 0
+    float    lodError;
+    Bounds   bounds;
+};
+
+/*
+    MeshView
+
+    - one mesh of a MappedMeshFile, pointing into the mapping
+    - only valid while the file stays open
+*/
+struct MeshView {
+    Vertex const *       vertices;
+    size_t               vertexCount;
+    unsigned int const * indices;
+    size_t               indexCount;
+    Meshlet const *      clusters;
+    size_t               clusterCount;
+    unsigned int const * meshletVertices;
+    size_t               meshletVertexCount;
+    uint8_t const *      meshletTriangles;
+    size_t               meshletTriangleCount;
+    uint32_t             lodLevel;
+    float                lodError;
+    Bounds               bounds;
+};
+
+/*
+    MappedMeshFile
+
+    - maps a .srmesh file read only, nothing is parsed
+    - open(...) checks the header, that every blob lies inside the file and that indices and
+      meshlets stay inside their arrays, so a damaged file is refused rather than drawn
+    - meshes are ready to draw, cache ordered with bounds and meshlets as they were when written
+    - on systems without mmap the file is read into memory in one go instead
+*/
+class MappedMeshFile {
+public:
+    MappedMeshFile();
+    MappedMeshFile(MappedMeshFile const &) = delete;
+    MappedMeshFile & operator = (MappedMeshFile const &) = delete;
+    ~MappedMeshFile();
+
+    // returns false and prints to std::cerr if the file could not be mapped or is not a mesh file
+    bool open(std::string const & filePath);
+    void close();
+    bool isOpen() const;
+
+    size_t getMeshCount() const;
+    MeshView getMesh(size_t index) const;
+
+    // copies one mesh out of the mapping, a straight copy of each array
+    Mesh copyMesh(size_t index) const;
+
+private:
+    bool validate(std::string const & filePath) const;
+
+private:
+    unsigned char const * m_data;
+    size_t                m_size;
+    std::vector<uint64_t> m_buffer; // the file's contents when it could not be mapped
+};
+
+/*
+    writeMeshFile(...)
+
+    - writes meshes, with their bounds and meshlets, as a .srmesh file
+    - returns false and prints to std::cerr if the file could not be written
+*/
+bool writeMeshFile(std::string const & filePath, std::vector<Mesh> const & meshes);
+
+/*
+    writeLodChains(...)
+
+    - writes every level of every chain as a mesh, in order, each with its level and error
+*/
+bool writeLodChains(std::string const & filePath, std::vector<LodChain> const & chains);
+
+/*
+    loadMeshFile(...)
+
+    - every mesh of a .srmesh file copied into a Mesh, the counterpart of loadDannyFile(...)
+    - returns an empty vector if the file could not be opened
+    - prefer MappedMeshFile and MeshView when the meshes only need reading
+*/
+std::vector<Mesh> loadMeshFile(std::string const & filePath);
+
+/*
+    loadLodChains(...)
+
+    - the chains of a file written by writeLodChains(...), a plain mesh file gives one level chains
+    - returns an empty vector if the file could not be opened
+*/
+std::vector<LodChain> loadLodChains(std::string const & filePath);
+
+#endif /* MeshFile_hpp */
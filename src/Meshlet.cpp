@@ -0,0 +1,321 @@
+// std
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// my
+#include "Meshlet.hpp"
+#include "djc_math/djc_math.hpp"
+
+namespace {
+    const uint8_t NOT_IN_MESHLET   = 0xFF;
+    const float   NO_CONE          = 2.0f; // a cutoff no cosine reaches
+    const float   MIN_CONE_SPREAD  = 0.1f; // cones with a normal this close to perpendicular to the axis are not worth testing
+    const size_t  SEAM_SEARCH      = 32;   // unconnected triangles looked at past the seed once nothing connected is left
+    const float   SEAM_MIN_FACING  = 0.5f; // and how closely they have to face the meshlet's way to join it
+
+    djc_math::Vec3f positionOf(Vertex const & vertex) {
+        return djc_math::Vec3f(vertex.position.x, vertex.position.y, vertex.position.z);
+    }
+
+    // unit normal of a counter clockwise triangle, zero when it has no area
+    djc_math::Vec3f triangleNormal(djc_math::Vec3f const & p0, djc_math::Vec3f const & p1, djc_math::Vec3f const & p2) {
+        djc_math::Vec3f normal = (p1 - p0).cross(p2 - p0);
+        float length = normal.length();
+        return length > 0.0f ? normal / length : djc_math::Vec3f(0.0f);
+    }
+
+    // same construction as computeBounds(...), centred on the box of the meshlet's vertices
+    BoundingSphere meshletSphere(std::vector<Vertex> const & vertices, unsigned int const * vertexIndices, size_t count) {
+        djc_math::Vec3f min = positionOf(vertices[vertexIndices[0]]);
+        djc_math::Vec3f max = min;
+
+        for(size_t i = 1; i < count; i++) {
+            djc_math::Vec3f position = positionOf(vertices[vertexIndices[i]]);
+            min.x = std::min(min.x, position.x);
+            min.y = std::min(min.y, position.y);
+            min.z = std::min(min.z, position.z);
+            max.x = std::max(max.x, position.x);
+            max.y = std::max(max.y, position.y);
+            max.z = std::max(max.z, position.z);
+        }
+
+        BoundingSphere sphere;
+        sphere.centre = (min + max) * 0.5f;
+
+        float radius2 = 0.0f;
+        for(size_t i = 0; i < count; i++) {
+            radius2 = std::max(radius2, (positionOf(vertices[vertexIndices[i]]) - sphere.centre).length2());
+        }
+
+        sphere.radius = std::sqrt(radius2);
+        return sphere;
+    }
+}
+
+//------------------------------------------------------------
+bool
+NormalCone::isBackFacing(djc_math::Vec3f const & eye) const {
+    djc_math::Vec3f toApex = apex - eye;
+    float distance = toApex.length();
+
+    // compared without the divide, distance is never negative
+    return toApex.dot(axis) >= cutoff * distance;
+}
+
+//------------------------------------------------------------
+bool
+Meshlets::empty() const {
+    return clusters.empty();
+}
+
+//------------------------------------------------------------
+Meshlets
+buildMeshlets(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, size_t maxVertices, size_t maxTriangles) {
+    Meshlets meshlets;
+
+    maxVertices  = std::min<size_t>(std::max<size_t>(maxVertices, 3), NOT_IN_MESHLET);
+    maxTriangles = std::max<size_t>(maxTriangles, 1);
+
+    size_t const triangleCount = indices.size() / 3;
+    if(triangleCount == 0) {
+        return meshlets;
+    }
+
+    // triangles around each vertex, one flat array with an offset per vertex
+    std::vector<unsigned int> adjacencyOffsets(vertices.size() + 1, 0);
+    for(size_t i = 0; i < triangleCount * 3; i++) {
+        adjacencyOffsets[indices[i] + 1]++;
+    }
+    for(size_t v = 0; v < vertices.size(); v++) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for(size_t i = 0; i < triangleCount * 3; i++) {
+        adjacency[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+
+    std::vector<djc_math::Vec3f> normals(triangleCount);
+    for(size_t t = 0; t < triangleCount; t++) {
+        normals[t] = triangleNormal(positionOf(vertices[indices[t * 3 + 0]]),
+                                    positionOf(vertices[indices[t * 3 + 1]]),
+                                    positionOf(vertices[indices[t * 3 + 2]]));
+    }
+
+    std::vector<uint8_t> used(triangleCount, 0);
+    std::vector<uint8_t> localIndex(vertices.size(), NOT_IN_MESHLET);
+    std::vector<uint32_t> candidateOf(triangleCount, UINT32_MAX); // meshlet a triangle was last made a candidate for
+    std::vector<unsigned int> candidates;
+
+    meshlets.clusters.reserve(triangleCount / maxTriangles + 1);
+    meshlets.vertices.reserve(triangleCount);
+    meshlets.triangles.reserve(triangleCount * 3);
+
+    size_t seed = 0;
+    while(true) {
+        while(seed < triangleCount && used[seed]) {
+            seed++;
+        }
+
+        if(seed == triangleCount) {
+            break;
+        }
+
+        uint32_t const meshletIndex = static_cast<uint32_t>(meshlets.clusters.size());
+
+        Meshlet meshlet;
+        meshlet.vertexOffset   = static_cast<uint32_t>(meshlets.vertices.size());
+        meshlet.vertexCount    = 0;
+        meshlet.triangleOffset = static_cast<uint32_t>(meshlets.triangles.size() / 3);
+        meshlet.triangleCount  = 0;
+
+        djc_math::Vec3f normalSum(0.0f);
+
+        auto addTriangle = [&](size_t triangle) {
+            used[triangle] = 1;
+            normalSum += normals[triangle];
+
+            for(int corner = 0; corner < 3; corner++) {
+                unsigned int vertex = indices[triangle * 3 + corner];
+
+                if(localIndex[vertex] == NOT_IN_MESHLET) {
+                    localIndex[vertex] = static_cast<uint8_t>(meshlet.vertexCount++);
+                    meshlets.vertices.push_back(vertex);
+
+                    // everything touching a new vertex can now join without adding it again
+                    for(unsigned int a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; a++) {
+                        unsigned int neighbour = adjacency[a];
+                        if(!used[neighbour] && candidateOf[neighbour] != meshletIndex) {
+                            candidateOf[neighbour] = meshletIndex;
+                            candidates.push_back(neighbour);
+                        }
+                    }
+                }
+
+                meshlets.triangles.push_back(localIndex[vertex]);
+            }
+
+            meshlet.triangleCount++;
+        };
+
+        addTriangle(seed);
+
+        while(meshlet.triangleCount < maxTriangles) {
+            djc_math::Vec3f axis = normalSum;
+            float axisLength = axis.length();
+            if(axisLength > 0.0f) {
+                axis /= axisLength;
+            }
+
+            size_t best = triangleCount;
+            float bestScore = FLT_MAX;
+
+            // scores are the new vertex count plus how far the facing is off the meshlet's, in 0..2
+            size_t kept = 0;
+            for(size_t c = 0; c < candidates.size(); c++) {
+                unsigned int triangle = candidates[c];
+                if(used[triangle]) {
+                    continue;
+                }
+                candidates[kept++] = triangle;
+
+                unsigned int newVertices = 0;
+                for(int corner = 0; corner < 3; corner++) {
+                    newVertices += localIndex[indices[triangle * 3 + corner]] == NOT_IN_MESHLET;
+                }
+
+                if(meshlet.vertexCount + newVertices > maxVertices) {
+                    continue;
+                }
+
+                float score = static_cast<float>(newVertices) + (1.0f - normals[triangle].dot(axis));
+                if(score < bestScore) {
+                    bestScore = score;
+                    best = triangle;
+                }
+            }
+            candidates.resize(kept);
+
+            // nothing connected is left, meshes split at seams carry on a little further along the
+            // index order, only with triangles facing the same way so the cone stays narrow
+            if(best == triangleCount) {
+                size_t looked = 0;
+
+                for(size_t triangle = seed + 1; triangle < triangleCount && looked < SEAM_SEARCH; triangle++) {
+                    if(used[triangle]) {
+                        continue;
+                    }
+                    looked++;
+
+                    unsigned int newVertices = 0;
+                    for(int corner = 0; corner < 3; corner++) {
+                        newVertices += localIndex[indices[triangle * 3 + corner]] == NOT_IN_MESHLET;
+                    }
+
+                    float facing = normals[triangle].dot(axis);
+                    if(meshlet.vertexCount + newVertices > maxVertices || facing < SEAM_MIN_FACING) {
+                        continue;
+                    }
+
+                    float score = static_cast<float>(newVertices) + (1.0f - facing);
+                    if(score < bestScore) {
+                        bestScore = score;
+                        best = triangle;
+                    }
+                }
+            }
+
+            // full, or nothing left that fits
+            if(best == triangleCount) {
+                break;
+            }
+
+            addTriangle(best);
+        }
+
+        unsigned int const * meshletVertices = meshlets.vertices.data() + meshlet.vertexOffset;
+        meshlet.sphere = meshletSphere(vertices, meshletVertices, meshlet.vertexCount);
+
+        // normal cone, the axis is the average facing and the cutoff comes from the normal furthest from it
+        meshlet.cone.apex   = meshlet.sphere.centre;
+        meshlet.cone.axis   = djc_math::Vec3f(0.0f);
+        meshlet.cone.cutoff = NO_CONE;
+
+        float axisLength = normalSum.length();
+        if(axisLength > 0.0f) {
+            djc_math::Vec3f axis = normalSum / axisLength;
+            float minDot = 1.0f;
+
+            uint8_t const * local = meshlets.triangles.data() + static_cast<size_t>(meshlet.triangleOffset) * 3;
+            for(uint32_t t = 0; t < meshlet.triangleCount; t++) {
+                djc_math::Vec3f normal = triangleNormal(positionOf(vertices[meshletVertices[local[t * 3 + 0]]]),
+                                                        positionOf(vertices[meshletVertices[local[t * 3 + 1]]]),
+                                                        positionOf(vertices[meshletVertices[local[t * 3 + 2]]]));
+                // degenerate triangles are never drawn, they do not widen the cone
+                if(normal.length2() > 0.0f) {
+                    minDot = std::min(minDot, normal.dot(axis));
+                }
+            }
+
+            if(minDot > MIN_CONE_SPREAD) {
+                // move the apex back along the axis until it is behind every triangle's plane,
+                // from there any eye seeing the apex from behind the cone sees every triangle from behind
+                float maxT = 0.0f;
+
+                for(uint32_t t = 0; t < meshlet.triangleCount; t++) {
+                    djc_math::Vec3f p0 = positionOf(vertices[meshletVertices[local[t * 3 + 0]]]);
+                    djc_math::Vec3f normal = triangleNormal(p0,
+                                                            positionOf(vertices[meshletVertices[local[t * 3 + 1]]]),
+                                                            positionOf(vertices[meshletVertices[local[t * 3 + 2]]]));
+                    if(normal.length2() > 0.0f) {
+                        maxT = std::max(maxT, (meshlet.sphere.centre - p0).dot(normal) / axis.dot(normal));
+                    }
+                }
+
+                meshlet.cone.apex   = meshlet.sphere.centre - axis * maxT;
+                meshlet.cone.axis   = axis;
+                meshlet.cone.cutoff = std::sqrt(1.0f - minDot * minDot);
+            }
+        }
+
+        for(uint32_t v = 0; v < meshlet.vertexCount; v++) {
+            localIndex[meshletVertices[v]] = NOT_IN_MESHLET;
+        }
+        candidates.clear();
+
+        meshlets.clusters.push_back(meshlet);
+    }
+
+    return meshlets;
+}
+
+//------------------------------------------------------------
+bool
+meshletsFit(Meshlet const * clusters, size_t clusterCount, unsigned int const * meshletVertices, size_t meshletVertexCount, uint8_t const * meshletTriangles, size_t meshletTriangleCount, size_t vertexCount) {
+    for(size_t i = 0; i < meshletVertexCount; i++) {
+        if(meshletVertices[i] >= vertexCount) {
+            return false;
+        }
+    }
+
+    for(size_t c = 0; c < clusterCount; c++) {
+        Meshlet const & meshlet = clusters[c];
+        uint64_t vertexEnd = static_cast<uint64_t>(meshlet.vertexOffset) + meshlet.vertexCount;
+        uint64_t triangleEnd = (static_cast<uint64_t>(meshlet.triangleOffset) + meshlet.triangleCount) * 3;
+
+        if(vertexEnd > meshletVertexCount || triangleEnd > meshletTriangleCount) {
+            return false;
+        }
+
+        uint8_t const * local = meshletTriangles + static_cast<size_t>(meshlet.triangleOffset) * 3;
+        for(size_t i = 0; i < static_cast<size_t>(meshlet.triangleCount) * 3; i++) {
+            if(local[i] >= meshlet.vertexCount) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
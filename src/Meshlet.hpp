@@ -0,0 +1,80 @@
+#ifndef Meshlet_hpp
+#define Meshlet_hpp
+
+// std
+#include <cstdint>
+#include <vector>
+
+// my
+#include "Bounds.hpp"
+#include "Vertex.hpp"
+#include "djc_math/Vec3.hpp"
+
+// my defines
+#define MESHLET_MAX_VERTICES  64  // local indices are stored in a byte
+#define MESHLET_MAX_TRIANGLES 128
+
+/*
+    NormalCone
+
+    - bounds the facing of every triangle in a meshlet
+    - the meshlet is back facing from eye when dot(normalise(apex - eye), axis) >= cutoff
+    - cutoff is greater than 1 when the normals spread too far to ever be back facing together
+*/
+struct NormalCone {
+    djc_math::Vec3f apex;
+    djc_math::Vec3f axis;
+    float cutoff;
+
+    bool isBackFacing(djc_math::Vec3f const & eye) const;
+};
+
+/*
+    Meshlet
+
+    - a cluster of neighbouring triangles from one mesh
+    - vertexOffset / vertexCount is a range of Meshlets::vertices
+    - triangleOffset / triangleCount is a range of triangles in Meshlets::triangles, 3 entries each
+*/
+struct Meshlet {
+    uint32_t vertexOffset;
+    uint32_t vertexCount;
+    uint32_t triangleOffset;
+    uint32_t triangleCount;
+
+    BoundingSphere sphere; // in model space like the mesh's bounds
+    NormalCone cone;
+};
+
+// the meshlets of one mesh, sharing two flat arrays
+struct Meshlets {
+    std::vector<Meshlet> clusters;
+    std::vector<unsigned int> vertices; // mesh vertex index of each meshlet local vertex
+    std::vector<uint8_t> triangles;     // meshlet local vertex indices, 3 per triangle
+
+    bool empty() const;
+};
+
+/*
+    buildMeshlets(...)
+
+    - splits an indexed triangle list into meshlets of at most maxVertices and maxTriangles
+    - each meshlet grows from a seed triangle, picking neighbours that add the fewest vertices
+      and then the ones facing closest to the meshlet so far, which keeps the cones narrow
+    - where the mesh is split at seams growth carries on with nearby triangles in index order
+      that face the same way
+    - triangles keep their winding, counter clockwise is front facing
+    - call once when a mesh is loaded, not per frame
+*/
+Meshlets buildMeshlets(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, size_t maxVertices = MESHLET_MAX_VERTICES, size_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+/*
+    meshletsFit(...)
+
+    - true when every meshlet lies inside the meshlet arrays, its triangles only use its own
+      vertices and every meshlet vertex is below vertexCount, the mesh's vertex count
+    - buildMeshlets(...) always gives meshlets that fit, this is for meshlets read from a file
+*/
+bool meshletsFit(Meshlet const * clusters, size_t clusterCount, unsigned int const * meshletVertices, size_t meshletVertexCount, uint8_t const * meshletTriangles, size_t meshletTriangleCount, size_t vertexCount);
+
+#endif /* Meshlet_hpp */
@@ -0,0 +1,448 @@
+// std
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+// my
+#include "ObjImport.hpp"
+#include "TextParse.hpp"
+#include "ThreadPool.hpp"
+#include "djc_math/djc_math.hpp"
+
+namespace {
+    const uint32_t EMPTY_SLOT        = UINT32_MAX;
+    const size_t   MIN_TABLE_SIZE    = 1024;
+    const int      MAX_VERTEX_VALUES = 7; // x y z, an optional w, and r g b
+
+    /*
+        ObjChunk
+
+        - whole lines of the file and what parsing them found, indices still as written
+        - one job parses it, the reading thread merges chunks in file order
+    */
+    struct ObjChunk {
+        std::vector<char> text;
+
+        std::vector<float>   positions; // x y z per v
+        std::vector<float>   colours;   // r g b per v, white when the line has none
+        std::vector<float>   texCoords; // u v per vt
+        std::vector<int64_t> corners;   // position, texture coordinate pairs, 0 is no texture coordinate
+        std::vector<uint32_t> faceSizes;
+        std::vector<uint32_t> faceLines;  // line of each face within the chunk, for errors found when merging
+        std::vector<uint32_t> faceCounts; // v and vt lines in the chunk before each face, indices may only reach those
+
+        size_t lineCount = 0;
+        size_t errorLine = 0;
+        char const * error = nullptr;
+
+        std::promise<void> parsed;
+    };
+
+    void parseChunk(ObjChunk & chunk) {
+        char const * cursor = chunk.text.data();
+        char const * const end = cursor + chunk.text.size();
+
+        while(cursor < end) {
+            char const * lineEnd = static_cast<char const *>(std::memchr(cursor, '\n', end - cursor));
+            if(!lineEnd) {
+                lineEnd = end;
+            }
+
+            char const * line = cursor;
+            cursor = lineEnd + 1;
+            chunk.lineCount++;
+
+            char const * keyword;
+            char const * keywordEnd;
+            if(!nextToken(line, lineEnd, keyword, keywordEnd)) {
+                continue;
+            }
+
+            size_t const keywordLength = static_cast<size_t>(keywordEnd - keyword);
+            char const * tokenBegin;
+            char const * tokenEnd;
+
+            if(keywordLength == 1 && keyword[0] == 'v') {
+                float values[MAX_VERTEX_VALUES];
+                int count = 0;
+
+                while(count < MAX_VERTEX_VALUES && nextToken(line, lineEnd, tokenBegin, tokenEnd)) {
+                    if(!parseNumber(tokenBegin, tokenEnd, values[count++])) {
+                        chunk.error = "expected numbers for a vertex";
+                        break;
+                    }
+                }
+
+                if(!chunk.error && count < 3) {
+                    chunk.error = "expected at least 3 numbers for a vertex";
+                }
+
+                if(chunk.error) {
+                    chunk.errorLine = chunk.lineCount;
+                    return;
+                }
+
+                chunk.positions.insert(chunk.positions.end(), values, values + 3);
+
+                // the colour extension puts r g b last, after x y z and an optional w
+                if(count >= 6) {
+                    chunk.colours.insert(chunk.colours.end(), values + count - 3, values + count);
+                } else {
+                    chunk.colours.insert(chunk.colours.end(), { 1.0f, 1.0f, 1.0f });
+                }
+            } else if(keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 't') {
+                float values[2] = { 0.0f, 0.0f };
+                int count = 0;
+
+                while(count < 2 && nextToken(line, lineEnd, tokenBegin, tokenEnd)) {
+                    if(!parseNumber(tokenBegin, tokenEnd, values[count++])) {
+                        count = 0;
+                        break;
+                    }
+                }
+
+                if(count == 0) {
+                    chunk.error = "expected numbers for a texture coordinate";
+                    chunk.errorLine = chunk.lineCount;
+                    return;
+                }
+
+                chunk.texCoords.insert(chunk.texCoords.end(), values, values + 2);
+            } else if(keywordLength == 1 && keyword[0] == 'f') {
+                uint32_t size = 0;
+
+                // p, p/t, p/t/n or p//n, the normal is skipped
+                while(nextToken(line, lineEnd, tokenBegin, tokenEnd)) {
+                    char const * slash = static_cast<char const *>(std::memchr(tokenBegin, '/', tokenEnd - tokenBegin));
+                    char const * positionEnd = slash ? slash : tokenEnd;
+
+                    int64_t position = 0;
+                    int64_t texCoord = 0;
+
+                    bool valid = parseNumber(tokenBegin, positionEnd, position) && position != 0;
+
+                    if(valid && slash) {
+                        char const * texCoordBegin = slash + 1;
+                        char const * texCoordEnd = static_cast<char const *>(std::memchr(texCoordBegin, '/', tokenEnd - texCoordBegin));
+                        if(!texCoordEnd) {
+                            texCoordEnd = tokenEnd;
+                        }
+
+                        if(texCoordEnd > texCoordBegin) {
+                            valid = parseNumber(texCoordBegin, texCoordEnd, texCoord) && texCoord != 0;
+                        }
+                    }
+
+                    if(!valid) {
+                        chunk.error = "expected position/texture/normal indices for a face";
+                        chunk.errorLine = chunk.lineCount;
+                        return;
+                    }
+
+                    chunk.corners.push_back(position);
+                    chunk.corners.push_back(texCoord);
+                    size++;
+                }
+
+                if(size < 3) {
+                    chunk.error = "a face needs at least 3 corners";
+                    chunk.errorLine = chunk.lineCount;
+                    return;
+                }
+
+                chunk.faceSizes.push_back(size);
+                chunk.faceLines.push_back(static_cast<uint32_t>(chunk.lineCount));
+                chunk.faceCounts.push_back(static_cast<uint32_t>(chunk.positions.size() / 3));
+                chunk.faceCounts.push_back(static_cast<uint32_t>(chunk.texCoords.size() / 2));
+            }
+        }
+    }
+
+    /*
+        VertexTable
+
+        - open addressing hash set of the mesh's vertices, keyed on their values
+        - stores vertex indices only, the values are compared in the vertex array itself
+    */
+    class VertexTable {
+    public:
+        explicit VertexTable(std::vector<Vertex> & vertices)
+        :   m_vertices(vertices)
+        ,   m_slots(MIN_TABLE_SIZE, EMPTY_SLOT)
+        {
+            // empty
+        }
+
+        // index of an equal vertex, added when there is none
+        uint32_t insert(Vertex const & vertex) {
+            // kept under half full so probe runs stay short
+            if((m_vertices.size() + 1) * 2 > m_slots.size()) {
+                grow();
+            }
+
+            size_t const mask = m_slots.size() - 1;
+            for(size_t slot = hashOf(vertex) & mask; ; slot = (slot + 1) & mask) {
+                uint32_t index = m_slots[slot];
+
+                if(index == EMPTY_SLOT) {
+                    m_slots[slot] = static_cast<uint32_t>(m_vertices.size());
+                    m_vertices.push_back(vertex);
+                    return m_slots[slot];
+                }
+
+                if(equal(m_vertices[index], vertex)) {
+                    return index;
+                }
+            }
+        }
+
+    private:
+        static uint64_t hashOf(Vertex const & vertex) {
+            float values[8] = { vertex.position.x, vertex.position.y, vertex.position.z,
+                                vertex.texCoord.x, vertex.texCoord.y,
+                                vertex.colour.x, vertex.colour.y, vertex.colour.z };
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for(float value : values) {
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                hash = (hash ^ bits) * 0x100000001b3ull;
+                hash ^= hash >> 29;
+            }
+            return hash;
+        }
+
+        static bool equal(Vertex const & lhs, Vertex const & rhs) {
+            return lhs.position.x == rhs.position.x && lhs.position.y == rhs.position.y && lhs.position.z == rhs.position.z
+                && lhs.texCoord.x == rhs.texCoord.x && lhs.texCoord.y == rhs.texCoord.y
+                && lhs.colour.x == rhs.colour.x && lhs.colour.y == rhs.colour.y && lhs.colour.z == rhs.colour.z;
+        }
+
+        void grow() {
+            std::vector<uint32_t> slots(m_slots.size() * 2, EMPTY_SLOT);
+            size_t const mask = slots.size() - 1;
+
+            for(uint32_t index = 0; index < m_vertices.size(); index++) {
+                size_t slot = hashOf(m_vertices[index]) & mask;
+                while(slots[slot] != EMPTY_SLOT) {
+                    slot = (slot + 1) & mask;
+                }
+                slots[slot] = index;
+            }
+
+            m_slots.swap(slots);
+        }
+
+    private:
+        std::vector<Vertex> & m_vertices;
+        std::vector<uint32_t> m_slots;
+    };
+
+    /*
+        ChunkReader
+
+        - cuts the file into chunks of whole lines, the partial line at the end of a read is carried
+          into the next chunk
+    */
+    class ChunkReader {
+    public:
+        explicit ChunkReader(std::FILE * file)
+        :   m_file(file)
+        ,   m_eof(false)
+        {
+            // empty
+        }
+
+        // false once the file is used up
+        bool read(std::vector<char> & text) {
+            text.swap(m_carry);
+            m_carry.clear();
+
+            size_t const wanted = std::max<size_t>(OBJ_CHUNK_SIZE, text.size() * 2);
+            while(!m_eof) {
+                size_t used = text.size();
+                text.resize(std::max(wanted, used * 2));
+                size_t got = std::fread(text.data() + used, 1, text.size() - used, m_file);
+                text.resize(used + got);
+                m_eof = got == 0;
+
+                // a line longer than a whole chunk keeps reading until it ends
+                char const * lastBreak = lastLineBreak(text);
+                if(lastBreak) {
+                    size_t cut = static_cast<size_t>(lastBreak - text.data()) + 1;
+                    m_carry.assign(text.begin() + cut, text.end());
+                    text.resize(cut);
+                    return true;
+                }
+            }
+
+            return !text.empty();
+        }
+
+    private:
+        static char const * lastLineBreak(std::vector<char> const & text) {
+            for(size_t i = text.size(); i-- > 0;) {
+                if(text[i] == '\n') {
+                    return text.data() + i;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        std::FILE *       m_file;
+        std::vector<char> m_carry;
+        bool              m_eof;
+    };
+
+    // index as written, 1 based or negative from the end, into a list of count entries
+    bool resolveIndex(int64_t written, size_t count, size_t & index) {
+        int64_t resolved = written > 0 ? written - 1 : static_cast<int64_t>(count) + written;
+        if(resolved < 0 || resolved >= static_cast<int64_t>(count)) {
+            return false;
+        }
+        index = static_cast<size_t>(resolved);
+        return true;
+    }
+}
+
+//------------------------------------------------------------
+std::vector<Mesh>
+loadObjFile(std::string const & filePath, size_t threadCount) {
+    std::vector<Mesh> meshes;
+
+    std::FILE * file = std::fopen(filePath.c_str(), "rb");
+    if(!file) {
+        std::cerr << "could not open " << filePath << std::endl;
+        return meshes;
+    }
+
+    std::unique_ptr<ThreadPool> pool;
+    if(threadCount != 1) {
+        pool.reset(new ThreadPool(threadCount));
+    }
+    size_t const maxInFlight = pool ? pool->getThreadCount() * OBJ_CHUNKS_PER_THREAD : 1;
+
+    ChunkReader reader(file);
+    std::deque<std::shared_ptr<ObjChunk>> inFlight;
+
+    Mesh mesh;
+    VertexTable table(mesh.vertices);
+
+    // everything merged so far, faces index into these
+    std::vector<float> positions;
+    std::vector<float> colours;
+    std::vector<float> texCoords;
+    size_t linesMerged = 0;
+
+    char const * error = nullptr;
+    size_t errorLine = 0;
+
+    while(!error) {
+        // keep the workers busy, a chunk holds its text until it is merged
+        while(inFlight.size() < maxInFlight) {
+            std::shared_ptr<ObjChunk> chunk = std::make_shared<ObjChunk>();
+            if(!reader.read(chunk->text)) {
+                break;
+            }
+
+            if(pool) {
+                pool->submit([chunk] {
+                    parseChunk(*chunk);
+                    chunk->parsed.set_value();
+                });
+            } else {
+                parseChunk(*chunk);
+                chunk->parsed.set_value();
+            }
+
+            inFlight.push_back(std::move(chunk));
+        }
+
+        if(inFlight.empty()) {
+            break;
+        }
+
+        std::shared_ptr<ObjChunk> chunk = std::move(inFlight.front());
+        inFlight.pop_front();
+        chunk->parsed.get_future().wait();
+
+        if(chunk->error) {
+            error = chunk->error;
+            errorLine = linesMerged + chunk->errorLine;
+            break;
+        }
+
+        size_t const positionsBefore = positions.size() / 3;
+        size_t const texCoordsBefore = texCoords.size() / 2;
+
+        positions.insert(positions.end(), chunk->positions.begin(), chunk->positions.end());
+        colours.insert(colours.end(), chunk->colours.begin(), chunk->colours.end());
+        texCoords.insert(texCoords.end(), chunk->texCoords.begin(), chunk->texCoords.end());
+
+        // a face reaches what was defined above it, negative indices count back from there
+        int64_t const * corner = chunk->corners.data();
+        for(size_t face = 0; face < chunk->faceSizes.size() && !error; face++) {
+            uint32_t const size = chunk->faceSizes[face];
+            size_t const positionCount = positionsBefore + chunk->faceCounts[face * 2];
+            size_t const texCoordCount = texCoordsBefore + chunk->faceCounts[face * 2 + 1];
+            uint32_t first = 0;
+            uint32_t previous = 0;
+
+            for(uint32_t c = 0; c < size; c++, corner += 2) {
+                size_t p;
+                size_t t = 0;
+
+                if(!resolveIndex(corner[0], positionCount, p) || (corner[1] != 0 && !resolveIndex(corner[1], texCoordCount, t))) {
+                    error = "face refers to a vertex or texture coordinate that is not defined";
+                    errorLine = linesMerged + chunk->faceLines[face];
+                    break;
+                }
+
+                djc_math::Vec2f texCoord = corner[1] != 0 ? djc_math::Vec2f(texCoords[t * 2], texCoords[t * 2 + 1]) : djc_math::Vec2f(0.0f);
+                Vertex vertex(djc_math::Vec3f(positions[p * 3], positions[p * 3 + 1], positions[p * 3 + 2]),
+                              texCoord,
+                              djc_math::Vec3f(colours[p * 3], colours[p * 3 + 1], colours[p * 3 + 2]));
+
+                uint32_t index = table.insert(vertex);
+
+                // fanned from the first corner, winding kept
+                if(c == 0) {
+                    first = index;
+                } else if(c >= 2) {
+                    mesh.indices.push_back(first);
+                    mesh.indices.push_back(previous);
+                    mesh.indices.push_back(index);
+                }
+                previous = index;
+            }
+        }
+
+        linesMerged += chunk->lineCount;
+    }
+
+    // queued jobs only touch their own chunks, the pool finishes them before it goes
+    pool.reset();
+    std::fclose(file);
+
+    if(error) {
+        std::cerr << filePath << ":" << errorLine << ": " << error << std::endl;
+        return meshes;
+    }
+
+    if(mesh.indices.empty()) {
+        std::cerr << filePath << " has no faces" << std::endl;
+        return meshes;
+    }
+
+    optimizeMesh(mesh.vertices, mesh.indices);
+    mesh.bounds = computeBounds(mesh.vertices);
+    mesh.meshlets = buildMeshlets(mesh.vertices, mesh.indices);
+    meshes.push_back(std::move(mesh));
+    return meshes;
+}
@@ -0,0 +1,32 @@
+#ifndef ObjImport_hpp
+#define ObjImport_hpp
+
+// std
+#include <string>
+#include <vector>
+
+// my
+#include "Mesh.hpp"
+
+// my defines
+#define OBJ_CHUNK_SIZE             (4 << 20) // bytes of whole lines each parse job gets
+#define OBJ_CHUNKS_PER_THREAD      2         // chunks read ahead per worker, bounds the text held at once
+
+/*
+    loadObjFile(...)
+
+    - imports a Wavefront .obj as one Mesh, the same as loadDannyFile(...) gives: cache ordered,
+      with bounds and meshlets
+    - reads v (with the x y z r g b colour extension), vt and f, polygons are fanned into triangles,
+      everything else (normals, groups, materials) is skipped
+    - vertices are de-duplicated on their position, texture coordinates and colour with a hash
+      table, so corners sharing all three share a vertex whatever indices the file used
+    - the file is streamed in OBJ_CHUNK_SIZE chunks parsed on threadCount workers (0 is one per
+      hardware thread), and merged in file order, at most OBJ_CHUNKS_PER_THREAD per worker are
+      held at once so memory is the mesh plus a few chunks however large the file is
+    - returns an empty vector if the file could not be opened or is malformed, the file and line
+      of the problem are printed to std::cerr
+*/
+std::vector<Mesh> loadObjFile(std::string const & filePath, size_t threadCount = 0);
+
+#endif /* ObjImport_hpp */
@@ -0,0 +1,390 @@
+// std
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// my
+#include "OcclusionBuffer.hpp"
+#include "djc_math/djc_math.hpp"
+
+// dependancies
+#if defined(__SSE2__) || defined(_M_X64)
+    #define OCCLUSION_SSE
+    #include <emmintrin.h>
+#endif
+
+namespace {
+    const float EMPTY_DEPTH     = FLT_MAX;
+    const float PIXEL_REACH     = 0.5005f; // centre to edge of a pixel, a little over to absorb rounding
+    const float DEPTH_ROUNDING  = 1e-6f;
+    const int   TILE_SIZE       = OCCLUSION_TILE_SIZE;
+
+    /*
+        edge a -> b as A * (x - ox) + B * (y - oy), positive on the left for counter clockwise triangles
+
+        - the origin is whichever end is lower in x then y, so two triangles sharing the edge evaluate it
+          from the same point and get exactly opposite values, no centre can fall between them
+        - centres exactly on the edge go to the triangle it is a left or top edge of
+    */
+    struct EdgeFunction {
+        float a;
+        float b;
+        float originX;
+        float originY;
+        bool  ownsZero;
+
+        EdgeFunction(float ax, float ay, float bx, float by)
+        :   a(ay - by)
+        ,   b(bx - ax)
+        ,   originX((ax < bx || (ax == bx && ay < by)) ? ax : bx)
+        ,   originY((ax < bx || (ax == bx && ay < by)) ? ay : by)
+        ,   ownsZero(a > 0.0f || (a == 0.0f && b < 0.0f))
+        {
+            // empty
+        }
+
+        float at(float x, float y) const {
+            return a * (x - originX) + b * (y - originY);
+        }
+
+        // everything but the a * x term for one row
+        float rowConstant(float y) const {
+            return b * (y - originY) - a * originX;
+        }
+
+        bool isInside(float value) const {
+            return value > 0.0f || (value == 0.0f && ownsZero);
+        }
+    };
+
+#if defined(OCCLUSION_SSE)
+    // EdgeFunction::isInside(...) for 4 values, ownsZero is all ones or all zeros
+    inline __m128 isInside(__m128 value, __m128 ownsZero) {
+        __m128 const zero = _mm_setzero_ps();
+        return _mm_or_ps(_mm_cmpgt_ps(value, zero), _mm_and_ps(_mm_cmpeq_ps(value, zero), ownsZero));
+    }
+
+    inline __m128 ownsZeroMask(EdgeFunction const & edge) {
+        return _mm_castsi128_ps(_mm_set1_epi32(edge.ownsZero ? -1 : 0));
+    }
+#endif
+}
+
+//------------------------------------------------------------
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+:   m_width((std::max(width, 4) + 3) & ~3)
+,   m_height(std::max(height, 1))
+,   m_depth(static_cast<size_t>(m_width) * m_height, EMPTY_DEPTH)
+,   m_tilesX((m_width + TILE_SIZE - 1) / TILE_SIZE)
+,   m_tilesY((m_height + TILE_SIZE - 1) / TILE_SIZE)
+,   m_tileMax(static_cast<size_t>(m_tilesX) * m_tilesY, EMPTY_DEPTH)
+,   m_tilesDirty(false)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+void
+OcclusionBuffer::clear() {
+    std::fill(m_depth.begin(), m_depth.end(), EMPTY_DEPTH);
+    std::fill(m_tileMax.begin(), m_tileMax.end(), EMPTY_DEPTH);
+    m_tilesDirty = false;
+}
+
+//------------------------------------------------------------
+void
+OcclusionBuffer::drawOccluder(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, djc_math::Mat4f const & modelViewProjection) {
+    m_stats.occluders++;
+    m_tilesDirty = true;
+
+    // the buffer covers ndc -1..1 on both axes, the same mapping the rasterizer uses for the back buffer
+    gatherPositions(vertices, m_positions);
+    transformPositions(modelViewProjection, m_positions, m_width * 0.5f, m_height * 0.5f, m_transformed);
+
+    float const minCoord = -OCCLUSION_GUARD_BAND;
+    float const maxX = static_cast<float>(m_width) + OCCLUSION_GUARD_BAND;
+    float const maxY = static_cast<float>(m_height) + OCCLUSION_GUARD_BAND;
+
+    for(size_t i = 0; i + 2 < indices.size(); i += 3) {
+        unsigned int i0 = indices[i + 0];
+        unsigned int i1 = indices[i + 1];
+        unsigned int i2 = indices[i + 2];
+
+        uint8_t const * outcodes = m_transformed.outcodes.data();
+
+        // entirely outside one plane covers nothing
+        if(outcodes[i0] & outcodes[i1] & outcodes[i2]) {
+            continue;
+        }
+
+        // the renderer clips what is in front of the near plane, so it can not hide anything
+        if((outcodes[i0] | outcodes[i1] | outcodes[i2]) & OUTCODE_NEAR) {
+            continue;
+        }
+
+        float x0 = m_transformed.screenX[i0], y0 = m_transformed.screenY[i0];
+        float x1 = m_transformed.screenX[i1], y1 = m_transformed.screenY[i1];
+        float x2 = m_transformed.screenX[i2], y2 = m_transformed.screenY[i2];
+
+        // far off the buffer the edge functions lose too much precision to place centres reliably
+        if(std::min(x0, std::min(x1, x2)) < minCoord || std::max(x0, std::max(x1, x2)) > maxX ||
+           std::min(y0, std::min(y1, y2)) < minCoord || std::max(y0, std::max(y1, y2)) > maxY) {
+            continue;
+        }
+
+        rasterizeTriangle(x0, y0, m_transformed.screenZ[i0],
+                          x1, y1, m_transformed.screenZ[i1],
+                          x2, y2, m_transformed.screenZ[i2]);
+    }
+}
+
+//------------------------------------------------------------
+bool
+OcclusionBuffer::isVisible(AABB const & box, djc_math::Mat4f const & viewProjection) {
+    m_stats.tested++;
+
+    if(m_tilesDirty) {
+        updateTiles();
+    }
+
+    float minX = FLT_MAX, minY = FLT_MAX;
+    float maxX = -FLT_MAX, maxY = -FLT_MAX;
+    float nearest = FLT_MAX;
+
+    for(int corner = 0; corner < 8; corner++) {
+        djc_math::Vec4f position((corner & 1) ? box.max.x : box.min.x,
+                                 (corner & 2) ? box.max.y : box.min.y,
+                                 (corner & 4) ? box.max.z : box.min.z,
+                                 1.0f);
+        djc_math::Vec4f clip = viewProjection * position;
+
+        // behind the eye the projection wraps around, the box could cover anything
+        if(clip.w <= 0.0f) {
+            return true;
+        }
+
+        float oneOverW = 1.0f / clip.w;
+        float x = (clip.x * oneOverW + 1.0f) * (m_width * 0.5f);
+        float y = (clip.y * oneOverW + 1.0f) * (m_height * 0.5f);
+
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        nearest = std::min(nearest, clip.z * oneOverW);
+    }
+
+    // every pixel the projected box touches, rounded out to whole groups of 4
+    int xStart = std::max(0, static_cast<int>(std::floor(minX))) & ~3;
+    int xEnd   = std::min(m_width - 1, static_cast<int>(std::floor(maxX)));
+    int yStart = std::max(0, static_cast<int>(std::floor(minY)));
+    int yEnd   = std::min(m_height - 1, static_cast<int>(std::floor(maxY)));
+
+    if(xStart > xEnd || yStart > yEnd) {
+        m_stats.occluded++;
+        return false; // off the view entirely
+    }
+
+    for(int tileY = yStart / TILE_SIZE; tileY <= yEnd / TILE_SIZE; tileY++) {
+        float const * tileRow = m_tileMax.data() + static_cast<size_t>(tileY) * m_tilesX;
+
+        for(int tileX = xStart / TILE_SIZE; tileX <= xEnd / TILE_SIZE; tileX++) {
+            // nothing in the tile is farther than the box, no need to look at its pixels
+            if(tileRow[tileX] <= nearest) {
+                continue;
+            }
+
+            if(isTileVisible(tileX, tileY, xStart, xEnd, yStart, yEnd, nearest)) {
+                return true;
+            }
+        }
+    }
+
+    m_stats.occluded++;
+    return false;
+}
+
+//------------------------------------------------------------
+int
+OcclusionBuffer::getWidth() const {
+    return m_width;
+}
+
+//------------------------------------------------------------
+int
+OcclusionBuffer::getHeight() const {
+    return m_height;
+}
+
+//------------------------------------------------------------
+float const *
+OcclusionBuffer::getDepth() const {
+    return m_depth.data();
+}
+
+//------------------------------------------------------------
+OcclusionBuffer::Stats const &
+OcclusionBuffer::getStats() const {
+    return m_stats;
+}
+
+//------------------------------------------------------------
+void
+OcclusionBuffer::resetStats() {
+    m_stats = Stats();
+}
+
+/* PRIVATE */
+
+//------------------------------------------------------------
+void
+OcclusionBuffer::updateTiles() {
+    for(int tileY = 0; tileY < m_tilesY; tileY++) {
+        int yEnd = std::min(m_height, (tileY + 1) * TILE_SIZE);
+
+        for(int tileX = 0; tileX < m_tilesX; tileX++) {
+            int xEnd = std::min(m_width, (tileX + 1) * TILE_SIZE);
+            float farthest = -FLT_MAX;
+
+            for(int y = tileY * TILE_SIZE; y < yEnd; y++) {
+                float const * row = m_depth.data() + static_cast<size_t>(y) * m_width;
+                for(int x = tileX * TILE_SIZE; x < xEnd; x++) {
+                    farthest = std::max(farthest, row[x]);
+                }
+            }
+
+            m_tileMax[static_cast<size_t>(tileY) * m_tilesX + tileX] = farthest;
+        }
+    }
+
+    m_tilesDirty = false;
+}
+
+//------------------------------------------------------------
+bool
+OcclusionBuffer::isTileVisible(int tileX, int tileY, int xStart, int xEnd, int yStart, int yEnd, float nearest) const {
+    // the part of the box's rect inside this tile, tiles are a multiple of 4 wide so x stays aligned
+    int x0 = std::max(xStart, tileX * TILE_SIZE);
+    int x1 = std::min(xEnd, (tileX + 1) * TILE_SIZE - 1);
+    int y0 = std::max(yStart, tileY * TILE_SIZE);
+    int y1 = std::min(yEnd, (tileY + 1) * TILE_SIZE - 1);
+
+    for(int y = y0; y <= y1; y++) {
+        float const * row = m_depth.data() + static_cast<size_t>(y) * m_width;
+
+#if defined(OCCLUSION_SSE)
+        __m128 const boxDepth = _mm_set1_ps(nearest);
+
+        for(int x = x0; x <= x1; x += 4) {
+            // any pixel whose occluder is farther than the box's nearest point lets it through
+            if(_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(row + x), boxDepth))) {
+                return true;
+            }
+        }
+#else
+        for(int x = x0; x <= x1; x++) {
+            if(row[x] > nearest) {
+                return true;
+            }
+        }
+#endif
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------
+void
+OcclusionBuffer::rasterizeTriangle(float x0, float y0, float z0, float x1, float y1, float z1, float x2, float y2, float z2) {
+    float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+
+    if(area == 0.0f) {
+        return;
+    }
+
+    // both windings are drawn, flip clockwise ones so inside is always positive
+    if(area < 0.0f) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+        std::swap(z1, z2);
+        area = -area;
+    }
+
+    int xStart = std::max(0, static_cast<int>(std::floor(std::min(x0, std::min(x1, x2))))) & ~3;
+    int xEnd   = std::min(m_width - 1, static_cast<int>(std::ceil(std::max(x0, std::max(x1, x2)))));
+    int yStart = std::max(0, static_cast<int>(std::floor(std::min(y0, std::min(y1, y2)))));
+    int yEnd   = std::min(m_height - 1, static_cast<int>(std::ceil(std::max(y0, std::max(y1, y2)))));
+
+    if(xStart > xEnd || yStart > yEnd) {
+        return;
+    }
+
+    m_stats.triangles++;
+
+    // edge 12 weights vertex 0 and so on
+    EdgeFunction e0(x1, y1, x2, y2);
+    EdgeFunction e1(x2, y2, x0, y0);
+    EdgeFunction e2(x0, y0, x1, y1);
+
+    // depth as a plane over the screen, z = z0 + zA * (x - x0) + zB * (y - y0)
+    float oneOverArea = 1.0f / area;
+    float zA = ((z1 - z0) * (y2 - y0) - (z2 - z0) * (y1 - y0)) * oneOverArea;
+    float zB = ((z2 - z0) * (x1 - x0) - (z1 - z0) * (x2 - x0)) * oneOverArea;
+
+    // the farthest the plane gets within half a pixel of the centre, stays conservative for pixels the triangle only partly covers
+    float zBias = PIXEL_REACH * (std::fabs(zA) + std::fabs(zB)) + DEPTH_ROUNDING;
+
+#if defined(OCCLUSION_SSE)
+    __m128 const offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    __m128 const a0 = _mm_set1_ps(e0.a), owns0 = ownsZeroMask(e0);
+    __m128 const a1 = _mm_set1_ps(e1.a), owns1 = ownsZeroMask(e1);
+    __m128 const a2 = _mm_set1_ps(e2.a), owns2 = ownsZeroMask(e2);
+    __m128 const depthA = _mm_set1_ps(zA);
+
+    for(int y = yStart; y <= yEnd; y++) {
+        float centreY = static_cast<float>(y) + 0.5f;
+        float * row = m_depth.data() + static_cast<size_t>(y) * m_width;
+
+        // row constant parts, x is the only thing that changes along the row
+        __m128 const row0 = _mm_set1_ps(e0.rowConstant(centreY));
+        __m128 const row1 = _mm_set1_ps(e1.rowConstant(centreY));
+        __m128 const row2 = _mm_set1_ps(e2.rowConstant(centreY));
+        __m128 const rowDepth = _mm_set1_ps(z0 + zB * (centreY - y0) - zA * x0 + zBias);
+
+        for(int x = xStart; x <= xEnd; x += 4) {
+            __m128 centreX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+            __m128 inside = isInside(_mm_add_ps(_mm_mul_ps(a0, centreX), row0), owns0);
+            inside = _mm_and_ps(inside, isInside(_mm_add_ps(_mm_mul_ps(a1, centreX), row1), owns1));
+            inside = _mm_and_ps(inside, isInside(_mm_add_ps(_mm_mul_ps(a2, centreX), row2), owns2));
+
+            if(_mm_movemask_ps(inside) == 0) {
+                continue;
+            }
+
+            __m128 depth = _mm_add_ps(_mm_mul_ps(depthA, centreX), rowDepth);
+            __m128 current = _mm_loadu_ps(row + x);
+            __m128 nearer = _mm_min_ps(current, depth);
+
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+        }
+    }
+#else
+    for(int y = yStart; y <= yEnd; y++) {
+        float centreY = static_cast<float>(y) + 0.5f;
+        float * row = m_depth.data() + static_cast<size_t>(y) * m_width;
+
+        for(int x = xStart; x <= xEnd; x++) {
+            float centreX = static_cast<float>(x) + 0.5f;
+
+            if(!e0.isInside(e0.at(centreX, centreY)) || !e1.isInside(e1.at(centreX, centreY)) || !e2.isInside(e2.at(centreX, centreY))) {
+                continue;
+            }
+
+            float depth = z0 + zA * (centreX - x0) + zB * (centreY - y0) + zBias;
+            row[x] = std::min(row[x], depth);
+        }
+    }
+#endif
+}
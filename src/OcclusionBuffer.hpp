@@ -0,0 +1,92 @@
+#ifndef OcclusionBuffer_hpp
+#define OcclusionBuffer_hpp
+
+// std
+#include <vector>
+
+// my
+#include "Bounds.hpp"
+#include "Vertex.hpp"
+#include "VertexTransform.hpp"
+#include "djc_math/Mat4.hpp"
+
+// my defines
+#define OCCLUSION_BUFFER_WIDTH  256
+#define OCCLUSION_BUFFER_HEIGHT 128
+#define OCCLUSION_GUARD_BAND    2048.0f // occluder triangles reaching further off the buffer than this are skipped
+#define OCCLUSION_TILE_SIZE     8       // pixels per side of the tiles whose farthest depth is kept for quick rejects
+
+/*
+    OcclusionBuffer
+
+    - a small depth only buffer covering the same view as the back buffer, depth is ndc z, smaller is nearer
+    - occluders write the pixels whose centre they cover, with the top-left rule so triangles sharing an
+      edge leave no gaps, and with the farthest depth the triangle's plane reaches over the whole pixel
+    - occludee boxes are tested against every pixel their projection touches with their nearest depth,
+      so only the occluders' silhouettes are approximated, to the nearest pixel centre
+    - boxes are first tested against the farthest depth of each tile they touch, pixels are only
+      read for tiles that can not reject the box on their own
+    - triangles crossing the near plane are not rasterized and boxes crossing it are always visible
+*/
+class OcclusionBuffer final {
+public:
+    struct Stats {
+        unsigned int occluders = 0;
+        unsigned int triangles = 0; // occluder triangles that reached the rasterizer
+        unsigned int tested = 0;
+        unsigned int occluded = 0;
+    };
+
+public:
+    OcclusionBuffer(int width = OCCLUSION_BUFFER_WIDTH, int height = OCCLUSION_BUFFER_HEIGHT);
+    ~OcclusionBuffer() = default;
+
+    // every pixel back to empty, nothing is occluded until occluders are drawn again
+    void clear();
+
+    /*
+        drawOccluder(...)
+
+        - modelViewProjection takes the vertices to clip space
+        - both windings are rasterized, the renderer does not cull back faces either
+    */
+    void drawOccluder(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, djc_math::Mat4f const & modelViewProjection);
+
+    /*
+        isVisible(...)
+
+        - box is in the space viewProjection transforms from
+        - false only when every pixel the box could cover already has a nearer occluder
+    */
+    bool isVisible(AABB const & box, djc_math::Mat4f const & viewProjection);
+
+    int getWidth() const;
+    int getHeight() const;
+    float const * getDepth() const; // row 0 is the bottom of the view, for debug views
+
+    Stats const & getStats() const;
+    void resetStats();
+
+private:
+    // screen space positions in buffer pixels, z is ndc depth
+    void rasterizeTriangle(float x0, float y0, float z0, float x1, float y1, float z1, float x2, float y2, float z2);
+    void updateTiles();
+    bool isTileVisible(int tileX, int tileY, int xStart, int xEnd, int yStart, int yEnd, float nearest) const;
+
+private:
+    int m_width; // rounded up to a multiple of 4 so rows can be walked 4 pixels at a time
+    int m_height;
+    std::vector<float> m_depth;
+
+    int m_tilesX;
+    int m_tilesY;
+    std::vector<float> m_tileMax; // farthest depth in each tile, rebuilt after occluders are drawn
+    bool m_tilesDirty;
+
+    PositionStream    m_positions;
+    TransformedStream m_transformed;
+
+    Stats m_stats;
+};
+
+#endif /* OcclusionBuffer_hpp */
@@ -0,0 +1,182 @@
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// my
+#include "PackedMesh.hpp"
+
+// dependancies
+#if defined(__F16C__)
+    #define PACKED_MESH_F16C
+    #include <immintrin.h>
+#endif
+
+namespace {
+    const float COLOUR_STEPS = 255.0f;
+
+    uint16_t quantise(float value, float offset, float scale) {
+        if(scale == 0.0f) {
+            return 0;
+        }
+
+        float steps = std::round((value - offset) / scale);
+        return static_cast<uint16_t>(std::max(0.0f, std::min(PACKED_POSITION_STEPS, steps)));
+    }
+
+    uint8_t quantiseColour(float value) {
+        // NaN goes to 0 along with everything below it
+        float clamped = value > 0.0f ? std::min(value, 1.0f) : 0.0f;
+        return static_cast<uint8_t>(std::round(clamped * COLOUR_STEPS));
+    }
+
+    Vertex decodeVertex(PackedVertex const & packed, djc_math::Vec3f const & scale, djc_math::Vec3f const & offset) {
+        float const toColour = 1.0f / COLOUR_STEPS;
+
+        return Vertex(djc_math::Vec3f(offset.x + static_cast<float>(packed.position[0]) * scale.x,
+                                      offset.y + static_cast<float>(packed.position[1]) * scale.y,
+                                      offset.z + static_cast<float>(packed.position[2]) * scale.z),
+                      djc_math::Vec2f(halfToFloat(packed.texCoord[0]), halfToFloat(packed.texCoord[1])),
+                      djc_math::Vec3f(static_cast<float>(packed.colour[0]) * toColour,
+                                      static_cast<float>(packed.colour[1]) * toColour,
+                                      static_cast<float>(packed.colour[2]) * toColour));
+    }
+}
+
+//------------------------------------------------------------
+PackedMesh
+packMesh(Mesh const & mesh) {
+    PackedMesh packed;
+    packed.indices = mesh.indices;
+    packed.positionScale = djc_math::Vec3f(0.0f);
+    packed.positionOffset = djc_math::Vec3f(0.0f);
+
+    // quantised onto the box of the vertices themselves, mesh.bounds may be stale
+    Bounds bounds = computeBounds(mesh.vertices);
+    if(!bounds.empty()) {
+        packed.positionOffset = bounds.box.min;
+        packed.positionScale = (bounds.box.max - bounds.box.min) / PACKED_POSITION_STEPS;
+    }
+
+    djc_math::Vec3f const & scale = packed.positionScale;
+    djc_math::Vec3f const & offset = packed.positionOffset;
+
+    packed.vertices.resize(mesh.vertices.size());
+    for(size_t i = 0; i < mesh.vertices.size(); i++) {
+        Vertex const & vertex = mesh.vertices[i];
+        PackedVertex & out = packed.vertices[i];
+
+        out.position[0] = quantise(vertex.position.x, offset.x, scale.x);
+        out.position[1] = quantise(vertex.position.y, offset.y, scale.y);
+        out.position[2] = quantise(vertex.position.z, offset.z, scale.z);
+        out.texCoord[0] = floatToHalf(vertex.texCoord.x);
+        out.texCoord[1] = floatToHalf(vertex.texCoord.y);
+        out.colour[0] = quantiseColour(vertex.colour.x);
+        out.colour[1] = quantiseColour(vertex.colour.y);
+        out.colour[2] = quantiseColour(vertex.colour.z);
+        out.colour[3] = 255;
+    }
+
+    // culling has to bound what is drawn, which is the decoded positions
+    std::vector<Vertex> decoded(packed.vertices.size());
+    for(size_t i = 0; i < packed.vertices.size(); i++) {
+        decoded[i] = decodeVertex(packed.vertices[i], scale, offset);
+    }
+
+    packed.bounds = computeBounds(decoded);
+    packed.meshlets = buildMeshlets(decoded, packed.indices);
+    return packed;
+}
+
+//------------------------------------------------------------
+Mesh
+unpackMesh(PackedMesh const & mesh) {
+    Mesh unpacked;
+    unpacked.vertices.resize(mesh.vertices.size());
+
+    for(size_t i = 0; i < mesh.vertices.size(); i++) {
+        unpacked.vertices[i] = decodeVertex(mesh.vertices[i], mesh.positionScale, mesh.positionOffset);
+    }
+
+    unpacked.indices = mesh.indices;
+    unpacked.bounds = mesh.bounds;
+    unpacked.meshlets = mesh.meshlets;
+    return unpacked;
+}
+
+//------------------------------------------------------------
+void
+decodeVertices(PackedMesh const & mesh, unsigned int const * vertexIndices, size_t count, std::vector<Vertex> & decoded) {
+    decoded.resize(count);
+
+    for(size_t i = 0; i < count; i++) {
+        size_t index = vertexIndices ? vertexIndices[i] : i;
+        decoded[i] = decodeVertex(mesh.vertices[index], mesh.positionScale, mesh.positionOffset);
+    }
+}
+
+//------------------------------------------------------------
+uint16_t
+floatToHalf(float value) {
+#if defined(PACKED_MESH_F16C)
+    return static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t const sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t const magnitude = bits & 0x7fffffff;
+
+    // infinity stays infinity, NaN stays a quiet NaN
+    if(magnitude >= 0x7f800000) {
+        return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x0200 : 0);
+    }
+
+    // 65520 and up round past the largest half, 65504
+    if(magnitude >= 0x477ff000) {
+        return sign | 0x7c00;
+    }
+
+    // under 2^-14 is a denormal half, counted in steps of 2^-24, rounding up to 1024 gives the smallest normal
+    if(magnitude < 0x38800000) {
+        float steps = std::nearbyint(std::fabs(value) * 16777216.0f);
+        return sign | static_cast<uint16_t>(steps);
+    }
+
+    // rebias the exponent from 127 to 15 and drop 13 mantissa bits, a carry out of the mantissa bumps the exponent
+    uint32_t half = (magnitude - (112u << 23)) >> 13;
+    uint32_t const dropped = magnitude & 0x1fff;
+    if(dropped > 0x1000 || (dropped == 0x1000 && (half & 1))) {
+        half++;
+    }
+
+    return sign | static_cast<uint16_t>(half);
+#endif
+}
+
+//------------------------------------------------------------
+float
+halfToFloat(uint16_t value) {
+#if defined(PACKED_MESH_F16C)
+    return _cvtsh_ss(value);
+#else
+    uint32_t const sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t const exponent = (value >> 10) & 0x1f;
+    uint32_t const mantissa = value & 0x3ff;
+
+    uint32_t bits;
+    if(exponent == 0) {
+        // zero or denormal, mantissa steps of 2^-24
+        float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        return sign ? -magnitude : magnitude;
+    } else if(exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+#endif
+}
@@ -0,0 +1,75 @@
+#ifndef PackedMesh_hpp
+#define PackedMesh_hpp
+
+// std
+#include <cstdint>
+#include <vector>
+
+// my
+#include "Bounds.hpp"
+#include "Mesh.hpp"
+#include "Meshlet.hpp"
+#include "Vertex.hpp"
+#include "djc_math/Vec3.hpp"
+
+// my defines
+#define PACKED_POSITION_STEPS 65535.0f // a position axis is quantised to this many steps across the mesh's box
+
+/*
+    PackedVertex
+
+    - 14 bytes where Vertex is 36
+    - position is 16 bit unsigned along each axis of the mesh's box, w is always 1
+    - texCoord is half float, exact to 1 / 2048 between 0.5 and 1, texture coordinates past
+      2048 lose whole texels
+    - colour is 8 bit per channel, clamped to 0..1, alpha is always 255 as Vertex has none
+*/
+struct PackedVertex {
+    uint16_t position[3];
+    uint16_t texCoord[2];
+    uint8_t  colour[4];
+};
+
+/*
+    PackedMesh
+
+    - a Mesh with PackedVertex vertices, drawn with RenderContext::drawIndexedMesh(PackedMesh const &, ...)
+    - position = positionOffset + quantised * positionScale, per axis
+    - bounds and meshlets are built from the decoded positions, so they hold what is drawn
+*/
+struct PackedMesh {
+    std::vector<PackedVertex> vertices;
+    std::vector<unsigned int> indices;
+    djc_math::Vec3f positionScale;
+    djc_math::Vec3f positionOffset;
+    Bounds bounds;
+    Meshlets meshlets;
+};
+
+/*
+    packMesh(...)
+
+    - quantises every vertex of mesh onto its bounding box, rounding to the nearest step
+    - a position moves by half a step at most, (box size / PACKED_POSITION_STEPS) / 2 on each axis
+      give or take float rounding
+    - indices are copied as they are, meshlets are rebuilt so run it on a cache ordered mesh
+*/
+PackedMesh packMesh(Mesh const & mesh);
+
+// every vertex decoded back into a Mesh, meshlets and bounds copied
+Mesh unpackMesh(PackedMesh const & mesh);
+
+/*
+    decodeVertices(...)
+
+    - decodes count vertices picked by vertexIndices into decoded, in that order, or the first
+      count when vertexIndices is nullptr
+    - the vertex stage runs this on each visible meshlet, so only drawn vertices are decoded
+*/
+void decodeVertices(PackedMesh const & mesh, unsigned int const * vertexIndices, size_t count, std::vector<Vertex> & decoded);
+
+// IEEE half floats, rounding to nearest even, out of range values become infinity
+uint16_t floatToHalf(float value);
+float halfToFloat(uint16_t value);
+
+#endif /* PackedMesh_hpp */
@@ -5,140 +5,345 @@
 
 // std
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <utility>
 #include <cmath>
 #include <cstdint> // used for inline asm
 #include <limits>
 
-#define DEPTH_MAX -1000
-
 /* PUBLIC */
 
 //------------------------------------------------------------
 RenderContext::RenderContext(int width, int height) 
 :   Bitmap(width, height)
+,   m_defaultTarget(width, height)
+,   m_target(&m_defaultTarget)
 ,   m_halfWidth(static_cast<float>(width) / 2.0f)
 ,   m_halfHeight(static_cast<float>(height) / 2.0f)
+,   m_fillMode(FillMode::Solid)
+,   m_cullMode(CullMode::None)
 {   
     m_screenSpaceTransform = djc_math::createMat4ScreenSpaceTransform(m_halfWidth, m_halfHeight); 
 
-    m_depthBuffer.resize(width * height);
-    std::fill(std::begin(m_depthBuffer), std::end(m_depthBuffer), DEPTH_MAX);
+    // the context is its own default colour target
+    m_defaultTarget.attachColour(*this, FragmentOutput::Colour);
 }
 
 //------------------------------------------------------------
 void
-RenderContext::drawMesh(std::vector<Vertex> vertices, djc_math::Mat4f & transform, Bitmap & bitmap) {  
-
-    // transform vertices
-    for(auto & vertex : vertices) {
-        djc_math::transform(vertex.position, transform);
-    }
+RenderContext::drawMesh(std::vector<Vertex> const & vertices, djc_math::Mat4f const & transform, Bitmap & bitmap) {  
+    transformVertices(vertices, transform);
 
     // draw triangles
-    for(size_t i = 0; i < vertices.size(); i+= 3) {
-        drawTriangle(vertices[i + 0],
-                    vertices[i + 1],
-                    vertices[i + 2],
-                    bitmap);
+    for(size_t i = 0; i + 2 < vertices.size(); i+= 3) {
+        drawTransformedTriangle(vertices, nullptr, i + 0, i + 1, i + 2, bitmap);
     }    
 }
 
 //------------------------------------------------------------
 void 
-RenderContext::drawIndexedMesh(std::vector<Vertex> vertices, std::vector<unsigned int> const & indices, djc_math::Mat4f const & transform, Bitmap & bitmap) {
-    for(auto & vertex : vertices) {
-        djc_math::transform(vertex.position, transform);
-    }
+RenderContext::drawIndexedMesh(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, djc_math::Mat4f const & transform, Bitmap & bitmap) {
+    transformVertices(vertices, transform);
 
     // draw triangles
-    for(size_t i = 0; i < indices.size(); i+= 3) {
+    for(size_t i = 0; i + 2 < indices.size(); i+= 3) {
+        drawTransformedTriangle(vertices, nullptr, indices[i + 0], indices[i + 1], indices[i + 2], bitmap);
+    }
+}
 
-        size_t index1 = indices[i + 0];
-        size_t index2 = indices[i + 1];
-        size_t index3 = indices[i + 2];
+//------------------------------------------------------------
+void
+RenderContext::drawIndexedMesh(Mesh const & mesh, djc_math::Mat4f const & transform, Bitmap & bitmap) {
+    m_cullStats.meshesTested++;
+
+    // planes of the model view projection are in model space, so the bounds are tested as loaded
+    m_frustum.update(transform);
+    Frustum::Visibility visibility = m_frustum.classify(mesh.bounds);
+
+    if(visibility == Frustum::Visibility::Outside) {
+        m_cullStats.meshesCulled++;
+        return;
+    }
 
-        drawTriangle(vertices[index1], 
-                     vertices[index2],
-                     vertices[index3], 
-                     bitmap);   
+    if(mesh.meshlets.empty()) {
+        drawIndexedMesh(mesh.vertices, mesh.indices, transform, bitmap);
+        return;
     }
+
+    drawMeshlets(mesh, transform, visibility == Frustum::Visibility::Intersecting, bitmap);
 }
 
 //------------------------------------------------------------
 void
-RenderContext::clearDepthBuffer() {
-    std::fill(std::begin(m_depthBuffer), std::end(m_depthBuffer), DEPTH_MAX); // fix : remove this magic number
+RenderContext::drawIndexedMesh(PackedMesh const & mesh, djc_math::Mat4f const & transform, Bitmap & bitmap) {
+    m_cullStats.meshesTested++;
+
+    m_frustum.update(transform);
+    Frustum::Visibility visibility = m_frustum.classify(mesh.bounds);
+
+    if(visibility == Frustum::Visibility::Outside) {
+        m_cullStats.meshesCulled++;
+        return;
+    }
+
+    if(mesh.meshlets.empty()) {
+        decodeVertices(mesh, nullptr, mesh.vertices.size(), m_decoded);
+        drawIndexedMesh(m_decoded, mesh.indices, transform, bitmap);
+        return;
+    }
+
+    drawMeshlets(mesh, transform, visibility == Frustum::Visibility::Intersecting, bitmap);
 }
 
-/* PRIVATE */
+//------------------------------------------------------------
+RenderContext::CullStats const &
+RenderContext::getCullStats() const {
+    return m_cullStats;
+}
 
 //------------------------------------------------------------
 void
-RenderContext::drawTriangle(Vertex v1, Vertex v2, Vertex v3, Bitmap & bitmap) {
+RenderContext::resetCullStats() {
+    m_cullStats = CullStats();
+}
+
+//------------------------------------------------------------
+void
+RenderContext::drawLine(Vertex v1, Vertex v2, bool depthTest) {
+    // liang-barsky in homogeneous clip space, each plane is written as d = w +- component >= 0
+    float tEnter = 0.0f;
+    float tExit  = 1.0f;
+
+    auto clipAgainst = [&tEnter, &tExit](float d1, float d2) -> bool {
+        if(d1 < 0.0f && d2 < 0.0f) {
+            return false; // both ends outside the same plane
+        }
 
-    auto isXinsidePosW = [](Vertex & vert) -> void {
-        if(vert.position.x <= vert.position.w) {
-            
-        } else {
-            std::cout << "vert went off screen: w " << vert.position.w << " x: " << vert.position.x << std::endl;
-            vert.position.x = vert.position.w;
+        if(d1 < 0.0f) {
+            tEnter = std::max(tEnter, d1 / (d1 - d2));
+        } else if(d2 < 0.0f) {
+            tExit = std::min(tExit, d1 / (d1 - d2));
         }
+
+        return tEnter <= tExit;
     };
 
-    // isXinsidePosW(v1);
-    // isXinsidePosW(v2);
-    // isXinsidePosW(v3);
-    
-    // * clipping * //
+    auto const & p1 = v1.position;
+    auto const & p2 = v2.position;
+
+    if(!clipAgainst(p1.w + p1.x, p2.w + p2.x) || !clipAgainst(p1.w - p1.x, p2.w - p2.x) ||
+       !clipAgainst(p1.w + p1.y, p2.w + p2.y) || !clipAgainst(p1.w - p1.y, p2.w - p2.y) ||
+       !clipAgainst(p1.w + p1.z, p2.w + p2.z) || !clipAgainst(p1.w - p1.z, p2.w - p2.z)) {
+        return;
+    }
+
+    if(tEnter > 0.0f || tExit < 1.0f) {
+        Vertex start = lerp(v1, v2, tEnter);
+        Vertex end   = lerp(v1, v2, tExit);
+        drawLineWithinScreenBounds(start, end, depthTest);
+    } else {
+        drawLineWithinScreenBounds(v1, v2, depthTest);
+    }
+}
+
+//------------------------------------------------------------
+void
+RenderContext::drawLines(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, djc_math::Mat4f const & transform, bool depthTest) {
+    transformVertices(vertices, transform);
+
+    for(size_t i = 0; i + 1 < indices.size(); i += 2) {
+        unsigned int index1 = indices[i + 0];
+        unsigned int index2 = indices[i + 1];
+
+        // both ends outside the same plane
+        if(m_transformed.outcodes[index1] & m_transformed.outcodes[index2]) {
+            continue;
+        }
+
+        drawLine(clipVertex(vertices[index1], index1), clipVertex(vertices[index2], index2), depthTest);
+    }
+}
+
+//------------------------------------------------------------
+void
+RenderContext::setFillMode(FillMode mode) {
+    m_fillMode = mode;
+}
+
+//------------------------------------------------------------
+RenderContext::FillMode
+RenderContext::getFillMode() const {
+    return m_fillMode;
+}
 
-    struct VertexPacket {
-        std::array<Vertex, 6> vertices;
-        int count = 0;
+//------------------------------------------------------------
+void
+RenderContext::setCullMode(CullMode mode) {
+    m_cullMode = mode;
+}
+
+//------------------------------------------------------------
+RenderContext::CullMode
+RenderContext::getCullMode() const {
+    return m_cullMode;
+}
+
+//------------------------------------------------------------
+void
+RenderContext::bindRenderTarget(RenderTarget & target) {
+    m_target = &target;
+    m_halfWidth  = target.getWidth() / 2.0f;
+    m_halfHeight = target.getHeight() / 2.0f;
+}
+
+//------------------------------------------------------------
+void
+RenderContext::bindDefaultRenderTarget() {
+    bindRenderTarget(m_defaultTarget);
+}
+
+//------------------------------------------------------------
+RenderTarget &
+RenderContext::getRenderTarget() {
+    return *m_target;
+}
+
+//------------------------------------------------------------
+void
+RenderContext::clearDepthBuffer() {
+    m_target->clearDepth();
+}
+
+//------------------------------------------------------------
+void
+RenderContext::updateContextSize(int width, int height) {
+    m_screenSpaceTransform = djc_math::createMat4ScreenSpaceTransform(width / 2.0f, height / 2.0f);
+    Bitmap::resize(width, height);
+
+    // resizing the target detaches its colour attachments
+    m_defaultTarget.resize(width, height);
+    m_defaultTarget.attachColour(*this, FragmentOutput::Colour);
+
+    if(m_target == &m_defaultTarget) {
+        m_halfWidth  = width / 2.0f;
+        m_halfHeight = height / 2.0f;
+    }
+}
+
+/* PRIVATE */
+
+//------------------------------------------------------------
+void
+RenderContext::drawTriangle(Vertex v1, Vertex v2, Vertex v3, Bitmap & bitmap) {
+    auto outcodeOf = [](Vertex const & v) {
+        return computeOutcode(v.position.x, v.position.y, v.position.z, v.position.w);
     };
 
-    VertexPacket packetOne;
-    packetOne.vertices[0] = v1;
-    packetOne.vertices[1] = v2;
-    packetOne.vertices[2] = v3;
-    packetOne.count = 3; // 3 vertices to start off
+    uint8_t outcode1 = outcodeOf(v1);
+    uint8_t outcode2 = outcodeOf(v2);
+    uint8_t outcode3 = outcodeOf(v3);
+
+    // all three vertices are outside the same plane
+    if(outcode1 & outcode2 & outcode3) {
+        return;
+    }
 
-    VertexPacket packetTwo;
+    if((outcode1 | outcode2 | outcode3) == 0) {
+        drawTriangleWithinScreenBounds(v1, v2, v3, bitmap);
+        return;
+    }
 
-    // positive x clip
-    //------------------------------------
-    Vertex last = packetOne.vertices[packetOne.count - 1];
-    bool lastInBounds = last.position.x <= last.position.w;
-    
-    for(int i = 0; i < packetOne.count; i++) {
+    drawClippedTriangle(v1, v2, v3, outcode1 | outcode2 | outcode3, bitmap);
+}
 
-        std::cout << "i: "  << i << std::endl;
+//------------------------------------------------------------
+void
+RenderContext::drawClippedTriangle(Vertex const & v1, Vertex const & v2, Vertex const & v3, uint8_t planes, Bitmap & bitmap) {
+    // sutherland-hodgman in homogeneous clip space, each plane is written as d = w +- component >= 0
+    // and every plane adds at most one vertex, so 6 planes take a triangle to 9 at most
+    std::array<Vertex, 9> polygons[2];
+    polygons[0][0] = v1;
+    polygons[0][1] = v2;
+    polygons[0][2] = v3;
+    int count = 3;
+    int current = 0;
+
+    auto distance = [](djc_math::Vec4f const & p, int plane) -> float {
+        switch(plane) {
+            case 0:  return p.w + p.x; // OUTCODE_LEFT
+            case 1:  return p.w - p.x; // OUTCODE_RIGHT
+            case 2:  return p.w + p.y; // OUTCODE_BOTTOM
+            case 3:  return p.w - p.y; // OUTCODE_TOP
+            case 4:  return p.w + p.z; // OUTCODE_NEAR
+            default: return p.w - p.z; // OUTCODE_FAR
+        }
+    };
 
-        Vertex current = packetOne.vertices[i];
-        bool currentInBounds = current.position.x <= current.position.w;
+    auto intersect = [](Vertex const & inside, Vertex const & outside, float dInside, float dOutside, int plane) -> Vertex {
+        Vertex vertex = lerp(inside, outside, dInside / (dInside - dOutside));
+
+        // put exactly on the plane, rounding would otherwise leave uncovered slivers along the screen edges
+        djc_math::Vec4f & p = vertex.position;
+        switch(plane) {
+            case 0:  p.x = -p.w; break;
+            case 1:  p.x =  p.w; break;
+            case 2:  p.y = -p.w; break;
+            case 3:  p.y =  p.w; break;
+            case 4:  p.z = -p.w; break;
+            default: p.z =  p.w; break;
+        }
+        return vertex;
+    };
 
-        std::cout << current.position.x << std::endl;
+    for(int plane = 0; plane < 6; plane++) {
+        if(!(planes & (1 << plane))) {
+            continue;
+        }
 
-        if(lastInBounds ^ currentInBounds) {
-            last.colour = djc_math::Vec3f(0,0,1);
-            last.position.x = 0;
-            packetTwo.vertices[packetTwo.count++] =  last;
+        auto const & in = polygons[current];
+        auto & out = polygons[current ^ 1];
+        int outCount = 0;
+
+        for(int i = 0; i < count; i++) {
+            Vertex const & a = in[i];
+            Vertex const & b = in[(i + 1) % count];
+            float da = distance(a.position, plane);
+            float db = distance(b.position, plane);
+
+            if(da >= 0.0f) {
+                out[outCount++] = a;
+            }
+
+            // the edge crosses the plane, attributes are linear in clip space so they are lerped with the position,
+            // always from the inside end so a neighbour sharing the edge gets the same vertex and no crack
+            if(da >= 0.0f && db < 0.0f) {
+                out[outCount++] = intersect(a, b, da, db, plane);
+            } else if(da < 0.0f && db >= 0.0f) {
+                out[outCount++] = intersect(b, a, db, da, plane);
+            }
         }
 
-        if(currentInBounds) {
-            packetTwo.vertices[packetTwo.count++] =  current;
+        count = outCount;
+        current ^= 1;
+
+        if(count < 3) {
+            return;
         }
+    }
 
-        last = current;
-        lastInBounds = currentInBounds;
+    auto const & polygon = polygons[current];
+
+    // near and far together keep w >= 0, only a polygon squashed onto the eye reaches 0
+    for(int i = 0; i < count; i++) {
+        if(polygon[i].position.w <= 0.0f) {
+            return;
+        }
     }
-    //------------------------------------
 
-    std::cout << "count: " << packetTwo.count << std::endl;
-    
-    for(int i = 1; i < packetTwo.count - 1; i++) {
-        drawTriangleWithinScreenBounds(packetTwo.vertices[0], packetTwo.vertices[i], packetTwo.vertices[i + 1], bitmap);
+    // the clipped polygon is convex and keeps the triangle's winding
+    for(int i = 1; i + 1 < count; i++) {
+        drawTriangleWithinScreenBounds(polygon[0], polygon[i], polygon[i + 1], bitmap);
     }
 }
 
@@ -157,24 +362,31 @@ RenderContext::drawTriangleWithinScreenBounds(Vertex v1, Vertex v2, Vertex v3, B
     fromClipToNDC(v2);
     fromClipToNDC(v3);
 
+    // clamped, a vertex clipped onto an edge can land a rounding error past it
     auto fromNDCToScreen = [this](Vertex & v) {
-        v.position.x = (v.position.x + 1) * m_halfWidth;
-        v.position.y = (v.position.y + 1) * m_halfHeight;
+        v.position.x = djc_math::clamp((v.position.x + 1) * m_halfWidth, 0.0f, 2.0f * m_halfWidth);
+        v.position.y = djc_math::clamp((v.position.y + 1) * m_halfHeight, 0.0f, 2.0f * m_halfHeight);
     };
 
     fromNDCToScreen(v1);
     fromNDCToScreen(v2);
     fromNDCToScreen(v3);
-   
-    if(v3.getY() < v2.getY()) {
+
+    drawScreenTriangle(v1, v2, v3, bitmap);
+}
+
+//------------------------------------------------------------
+void
+RenderContext::drawScreenTriangle(Vertex v1, Vertex v2, Vertex v3, Bitmap & bitmap) {
+    if(v3.position.y < v2.position.y) {
         std::swap(v3, v2);
     }
 
-    if(v2.getY() < v1.getY()) {
+    if(v2.position.y < v1.position.y) {
         std::swap(v2, v1);
     }
 
-    if(v3.getY() < v2.getY()) {
+    if(v3.position.y < v2.position.y) {
         std::swap(v3, v2);
     }
 
@@ -188,6 +400,156 @@ RenderContext::drawTriangleWithinScreenBounds(Vertex v1, Vertex v2, Vertex v3, B
     scanTriangle(v1, v2, v3, isleftHanded, bitmap);
 }
 
+//------------------------------------------------------------
+void
+RenderContext::drawTransformedTriangle(std::vector<Vertex> const & vertices, unsigned int const * vertexMap, size_t index1, size_t index2, size_t index3, Bitmap & bitmap) {
+    auto const & t = m_transformed;
+
+    uint8_t outcode1 = t.outcodes[index1];
+    uint8_t outcode2 = t.outcodes[index2];
+    uint8_t outcode3 = t.outcodes[index3];
+
+    // all three vertices are outside the same plane
+    if(outcode1 & outcode2 & outcode3) {
+        return;
+    }
+
+    if(m_cullMode == CullMode::Back) {
+        // winding in homogeneous clip space, the sign of the screen space area without the divide
+        // and still right when a vertex is behind the eye
+        float facing = t.clipX[index1] * (t.clipY[index2] * t.clipW[index3] - t.clipY[index3] * t.clipW[index2])
+                     - t.clipY[index1] * (t.clipX[index2] * t.clipW[index3] - t.clipX[index3] * t.clipW[index2])
+                     + t.clipW[index1] * (t.clipX[index2] * t.clipY[index3] - t.clipX[index3] * t.clipY[index2]);
+
+        if(facing <= 0.0f) {
+            return;
+        }
+    }
+
+    auto attributes = [&vertices, vertexMap](size_t i) -> Vertex const & {
+        return vertices[vertexMap ? vertexMap[i] : i];
+    };
+
+    if(m_fillMode == FillMode::Wireframe) {
+        drawTriangleEdges(clipVertex(attributes(index1), index1), clipVertex(attributes(index2), index2), clipVertex(attributes(index3), index3));
+        return;
+    }
+
+    // inside every plane, the divide and viewport mapping are already done
+    if((outcode1 | outcode2 | outcode3) == 0) {
+        auto screenVertex = [&t, &attributes](size_t i) -> Vertex {
+            Vertex const & vertex = attributes(i);
+            return Vertex(djc_math::Vec4f(t.screenX[i], t.screenY[i], t.screenZ[i], t.clipW[i]), vertex.texCoord, vertex.colour);
+        };
+
+        drawScreenTriangle(screenVertex(index1), screenVertex(index2), screenVertex(index3), bitmap);
+        return;
+    }
+
+    drawClippedTriangle(clipVertex(attributes(index1), index1), clipVertex(attributes(index2), index2), clipVertex(attributes(index3), index3),
+                        outcode1 | outcode2 | outcode3, bitmap);
+}
+
+//------------------------------------------------------------
+void
+RenderContext::drawMeshlets(Mesh const & mesh, djc_math::Mat4f const & transform, bool testFrustum, Bitmap & bitmap) {
+    Meshlets const & meshlets = mesh.meshlets;
+
+    djc_math::Vec3f eye(0.0f);
+    bool testCones = findConeEye(transform, eye);
+
+    for(auto const & meshlet : meshlets.clusters) {
+        if(cullMeshlet(meshlet, testFrustum, testCones, eye)) {
+            continue;
+        }
+
+        // only this meshlet's vertices are transformed, vertices shared with its neighbours are transformed again there
+        unsigned int const * vertexMap = meshlets.vertices.data() + meshlet.vertexOffset;
+        gatherPositions(mesh.vertices, vertexMap, meshlet.vertexCount, m_positions);
+        transformPositions(transform, m_positions, m_halfWidth, m_halfHeight, m_transformed);
+
+        uint8_t const * triangles = meshlets.triangles.data() + static_cast<size_t>(meshlet.triangleOffset) * 3;
+        for(uint32_t i = 0; i < meshlet.triangleCount; i++) {
+            drawTransformedTriangle(mesh.vertices, vertexMap, triangles[i * 3 + 0], triangles[i * 3 + 1], triangles[i * 3 + 2], bitmap);
+        }
+    }
+}
+
+//------------------------------------------------------------
+void
+RenderContext::drawMeshlets(PackedMesh const & mesh, djc_math::Mat4f const & transform, bool testFrustum, Bitmap & bitmap) {
+    Meshlets const & meshlets = mesh.meshlets;
+
+    djc_math::Vec3f eye(0.0f);
+    bool testCones = findConeEye(transform, eye);
+
+    for(auto const & meshlet : meshlets.clusters) {
+        if(cullMeshlet(meshlet, testFrustum, testCones, eye)) {
+            continue;
+        }
+
+        // decoded in meshlet order, so the triangles' local indices index the scratch directly
+        decodeVertices(mesh, meshlets.vertices.data() + meshlet.vertexOffset, meshlet.vertexCount, m_decoded);
+        gatherPositions(m_decoded, m_positions);
+        transformPositions(transform, m_positions, m_halfWidth, m_halfHeight, m_transformed);
+
+        uint8_t const * triangles = meshlets.triangles.data() + static_cast<size_t>(meshlet.triangleOffset) * 3;
+        for(uint32_t i = 0; i < meshlet.triangleCount; i++) {
+            drawTransformedTriangle(m_decoded, nullptr, triangles[i * 3 + 0], triangles[i * 3 + 1], triangles[i * 3 + 2], bitmap);
+        }
+    }
+}
+
+//------------------------------------------------------------
+bool
+RenderContext::findConeEye(djc_math::Mat4f const & transform, djc_math::Vec3f & eye) const {
+    if(m_cullMode != CullMode::Back) {
+        return false;
+    }
+
+    // the point the projection sends to w = 0 in the middle of the view
+    djc_math::Vec4f point = djc_math::inverse(transform) * djc_math::Vec4f(0.0f, 0.0f, 1.0f, 0.0f);
+
+    if(std::fabs(point.w) <= std::numeric_limits<float>::epsilon()) {
+        return false;
+    }
+
+    eye = djc_math::Vec3f(point.x / point.w, point.y / point.w, point.z / point.w);
+    return true;
+}
+
+//------------------------------------------------------------
+bool
+RenderContext::cullMeshlet(Meshlet const & meshlet, bool testFrustum, bool testCones, djc_math::Vec3f const & eye) {
+    m_cullStats.meshletsTested++;
+
+    if(testFrustum && m_frustum.classify(meshlet.sphere) == Frustum::Visibility::Outside) {
+        m_cullStats.meshletsCulled++;
+        return true;
+    }
+
+    if(testCones && meshlet.cone.isBackFacing(eye)) {
+        m_cullStats.meshletsBackFacing++;
+        return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------
+Vertex
+RenderContext::clipVertex(Vertex const & attributes, size_t index) const {
+    auto const & t = m_transformed;
+    return Vertex(djc_math::Vec4f(t.clipX[index], t.clipY[index], t.clipZ[index], t.clipW[index]), attributes.texCoord, attributes.colour);
+}
+
+//------------------------------------------------------------
+void
+RenderContext::transformVertices(std::vector<Vertex> const & vertices, djc_math::Mat4f const & transform) {
+    gatherPositions(vertices, m_positions);
+    transformPositions(transform, m_positions, m_halfWidth, m_halfHeight, m_transformed);
+}
+
 //------------------------------------------------------------
 void // @perf : everything beyond this point should be 3D not 4D - no need to send a vec4 only need a vec3 because z is not needed send (x, y, w)
 RenderContext::scanTriangle(Vertex const & minY, Vertex const & midY, Vertex const & maxY, bool isleftHanded, Bitmap & bitmap) {
@@ -246,28 +608,46 @@ RenderContext::drawScanLine(Edge const & left, Edge const & right, int y, Bitmap
     float depthStep = (right.depth - currDepth) / xDist;
 
     // perf todo : don't do perspective correction every pixel but every few pixels
-    
-    size_t row = m_width * y;
+
+    int const width = m_target->getWidth();
+    int const attachmentCount = m_target->getColourAttachmentCount();
+    bool const sampleTexture = m_target->needsTexture();
+
+    // start of this scan line in every attachment, attachments can have different pitches
+    std::array<unsigned char *, MAX_COLOUR_ATTACHMENTS> pixelRows;
+    for(int i = 0; i < attachmentCount; i++) {
+        Bitmap & attachment = m_target->getColourAttachment(i);
+        pixelRows[i] = attachment.getPixels() + (m_target->getHeight() - 1 - y) * attachment.getPitch();
+        attachment.markDirty(static_cast<int>(xMin), static_cast<int>(xMax), y);
+    }
+
+    float * depths = m_target->getDepthBuffer().data();
+
+    size_t row = width * y;
     for (float x = xMin; x < xMax; ++x) {
-        if (m_depthBuffer[row + x] <  currDepth) {
-            m_depthBuffer[row + x] = currDepth;
+        if (depths[row + static_cast<size_t>(x)] <  currDepth) {
+            depths[row + static_cast<size_t>(x)] = currDepth;
 
             float z = 1.0f / currW;
-            int srcX = (int)((currTexCoord.x * z) * (float)(bitmap.getWidthF() - 1.0f));
-            int srcY = (int)((currTexCoord.y * z) * (float)(bitmap.getHeightF() - 1.0f));
-            
-            auto correctedTexColour = bitmap.getPixel(srcX, srcY);
-
+            auto correctedTexCoord = djc_math::Vec2f(currTexCoord.x * z, currTexCoord.y * z);
             auto correctedColour = djc_math::Vec3f(currColour.x * z, currColour.y * z, currColour.z * z);                                    
-        
-            //auto finalColour = correctedColour * correctedTexColour; // colour and texture
-            //auto finalColour = correctedTexColour; // texture only
-            auto finalColour = correctedColour; // colour only
-
-            setPixel(x, y, static_cast<unsigned char>(finalColour.z * 255.99f),
-                           static_cast<unsigned char>(finalColour.y * 255.99f), 
-                           static_cast<unsigned char>(finalColour.x * 255.99f));
-        
+
+            djc_math::Vec3f correctedTexColour;
+            if(sampleTexture) {
+                int srcX = (int)(correctedTexCoord.x * (float)(bitmap.getWidthF() - 1.0f));
+                int srcY = (int)(correctedTexCoord.y * (float)(bitmap.getHeightF() - 1.0f));
+                correctedTexColour = bitmap.getPixel(srcX, srcY);
+            }
+
+            size_t pixelIndex = static_cast<size_t>(x) * 4;
+            for(int i = 0; i < attachmentCount; i++) {
+                auto finalColour = shadeFragment(m_target->getColourOutput(i), correctedColour, correctedTexColour, correctedTexCoord, currDepth);
+
+                pixelRows[i][pixelIndex + 0] = static_cast<unsigned char>(finalColour.z * 255.99f);
+                pixelRows[i][pixelIndex + 1] = static_cast<unsigned char>(finalColour.y * 255.99f);
+                pixelRows[i][pixelIndex + 2] = static_cast<unsigned char>(finalColour.x * 255.99f);
+                pixelRows[i][pixelIndex + 3] = 255;
+            }
         }
 
         // step all the things
@@ -279,8 +659,128 @@ RenderContext::drawScanLine(Edge const & left, Edge const & right, int y, Bitmap
 }
 
 //------------------------------------------------------------
-void // fix : call this function when screen size changes - need to account for scale
-RenderContext::updateContextSize(float width, float height) {
-    m_screenSpaceTransform = djc_math::createMat4ScreenSpaceTransform((float)width / 2.0f, (float)height / 2.0f);
-    Bitmap::resize(width, height);
+void // vertices must be clipped before using this function
+RenderContext::drawLineWithinScreenBounds(Vertex const & v1, Vertex const & v2, bool depthTest) {
+    float oneOverW1 = 1.0f / v1.position.w;
+    float oneOverW2 = 1.0f / v2.position.w;
+
+    int const width  = m_target->getWidth();
+    int const height = m_target->getHeight();
+
+    // clip space -> screen space, clamped because x == w lands one past the last pixel
+    int x1 = djc_math::clamp(static_cast<int>((v1.position.x * oneOverW1 + 1) * m_halfWidth),  0, width  - 1);
+    int y1 = djc_math::clamp(static_cast<int>((v1.position.y * oneOverW1 + 1) * m_halfHeight), 0, height - 1);
+    int x2 = djc_math::clamp(static_cast<int>((v2.position.x * oneOverW2 + 1) * m_halfWidth),  0, width  - 1);
+    int y2 = djc_math::clamp(static_cast<int>((v2.position.y * oneOverW2 + 1) * m_halfHeight), 0, height - 1);
+
+    int dx =  std::abs(x2 - x1);
+    int dy = -std::abs(y2 - y1);
+    int sx = x1 < x2 ? 1 : -1;
+    int sy = y1 < y2 ? 1 : -1;
+    int steps = std::max(dx, -dy);
+    float stepScale = steps > 0 ? 1.0f / static_cast<float>(steps) : 0.0f;
+
+    // perspective correct colour, same as the triangle edges
+    djc_math::Vec3f currColour = v1.colour * oneOverW1;
+    djc_math::Vec3f colourStep = (v2.colour * oneOverW2 - currColour) * stepScale;
+
+    float currW = oneOverW1;
+    float wStep = (oneOverW2 - oneOverW1) * stepScale;
+
+    float currDepth = v1.position.z * oneOverW1;
+    float depthStep = (v2.position.z * oneOverW2 - currDepth) * stepScale;
+
+    // step straight through the buffers instead of recomputing indices every pixel
+    // the colour buffer is stored bottom row last, the depth buffer bottom row first
+    int depthIndex = y1 * width + x1;
+    int const pixelStepX = sx * 4;
+    int const depthStepY = sy * width;
+
+    // current pixel in every attachment, attachments can have different pitches
+    int const attachmentCount = m_target->getColourAttachmentCount();
+    std::array<unsigned char *, MAX_COLOUR_ATTACHMENTS> pixels;
+    std::array<int, MAX_COLOUR_ATTACHMENTS> pixelStepY;
+    bool trackDirty = false;
+    for(int i = 0; i < attachmentCount; i++) {
+        Bitmap & attachment = m_target->getColourAttachment(i);
+        pixels[i] = attachment.getPixels() + (height - 1 - y1) * attachment.getPitch() + x1 * 4;
+        pixelStepY[i] = -sy * attachment.getPitch();
+        trackDirty |= attachment.isDirtyTracking();
+    }
+
+    int x = x1;
+    int y = y1;
+
+    float * depths = m_target->getDepthBuffer().data();
+
+    int error = dx + dy;
+    for(int i = 0; i <= steps; i++) {
+        if(!depthTest || depths[depthIndex] < currDepth) {
+            if(depthTest) {
+                depths[depthIndex] = currDepth;
+            }
+
+            float z = 1.0f / currW;
+            auto correctedColour = currColour * z;
+
+            // lines have no texture, texture outputs get the line colour
+            for(int a = 0; a < attachmentCount; a++) {
+                auto finalColour = shadeFragment(m_target->getColourOutput(a), correctedColour, correctedColour, djc_math::Vec2f(0.0f), currDepth);
+
+                pixels[a][0] = static_cast<unsigned char>(finalColour.z * 255.99f);
+                pixels[a][1] = static_cast<unsigned char>(finalColour.y * 255.99f);
+                pixels[a][2] = static_cast<unsigned char>(finalColour.x * 255.99f);
+                pixels[a][3] = 255;
+            }
+
+            if(trackDirty) {
+                for(int a = 0; a < attachmentCount; a++) {
+                    m_target->getColourAttachment(a).markDirty(x, x + 1, y);
+                }
+            }
+        }
+
+        int error2 = error * 2;
+        if(error2 >= dy) {
+            error      += dy;
+            x          += sx;
+            depthIndex += sx;
+            for(int a = 0; a < attachmentCount; a++) {
+                pixels[a] += pixelStepX;
+            }
+        }
+        if(error2 <= dx) {
+            error      += dx;
+            y          += sy;
+            depthIndex += depthStepY;
+            for(int a = 0; a < attachmentCount; a++) {
+                pixels[a] += pixelStepY[a];
+            }
+        }
+
+        currColour += colourStep;
+        currW      += wStep;
+        currDepth  += depthStep;
+    }
+}
+
+//------------------------------------------------------------
+void
+RenderContext::drawTriangleEdges(Vertex const & v1, Vertex const & v2, Vertex const & v3) {
+    drawLine(v1, v2);
+    drawLine(v2, v3);
+    drawLine(v3, v1);
+}
+
+//------------------------------------------------------------
+djc_math::Vec3f
+RenderContext::shadeFragment(FragmentOutput output, djc_math::Vec3f const & colour, djc_math::Vec3f const & texColour, djc_math::Vec2f const & texCoord, float depth) const {
+    switch(output) {
+        case FragmentOutput::Colour:             return colour;
+        case FragmentOutput::Texture:            return texColour;
+        case FragmentOutput::ColourTimesTexture: return colour * texColour;
+        case FragmentOutput::Depth:              return djc_math::Vec3f(djc_math::clamp((depth + 1.0f) * 0.5f, 0.0f, 1.0f));
+        case FragmentOutput::TexCoord:           return djc_math::Vec3f(djc_math::clamp(texCoord.x, 0.0f, 1.0f), djc_math::clamp(texCoord.y, 0.0f, 1.0f), 0.0f);
+    }
+    return colour;
 }
\ No newline at end of file
@@ -6,23 +6,52 @@
 
 // my
 #include "Bitmap.hpp" 
+#include "Frustum.hpp"
+#include "Mesh.hpp"
+#include "PackedMesh.hpp"
+#include "RenderTarget.hpp"
 #include "Vertex.hpp"
+#include "VertexTransform.hpp"
 #include "djc_math/Mat4.hpp"
 
 class Edge;
 
 class RenderContext : public Bitmap {
     friend class Window;
+public:
+    // how triangles submitted through drawMesh / drawIndexedMesh are rasterized
+    enum class FillMode {
+        Solid,
+        Wireframe
+    };
+
+    // which triangles are skipped for facing away from the eye, counter clockwise is front facing
+    enum class CullMode {
+        None,
+        Back
+    };
+
+    // meshes passed to drawIndexedMesh(Mesh const &, ...) since the last resetCullStats()
+    struct CullStats {
+        unsigned int meshesTested = 0;
+        unsigned int meshesCulled = 0;
+        unsigned int meshletsTested = 0;
+        unsigned int meshletsCulled = 0;     // outside the frustum
+        unsigned int meshletsBackFacing = 0; // rejected on their normal cone
+    };
+
 public:
     RenderContext(int width, int height);
+    RenderContext(RenderContext const &) = delete;
+    RenderContext & operator = (RenderContext const &) = delete;
     virtual ~RenderContext() = default;
 
    
     /*
         drawTriangle(...)
 
-        - vertices can be outside of the screen
-        - if vertices are outside of the screen they will be clipped
+        - vertices are in clip space and can be outside of the screen
+        - triangles crossing the view volume are clipped against the planes they cross, near and far included
     */
     void drawTriangle(Vertex v1, Vertex v2, Vertex v3, Bitmap & bitmap); 
 
@@ -31,32 +60,185 @@ public:
 
         - draw mesh takes a std::vector of vertices. all vertices bust be in order
         - if there is repeating vertex data it is preferable to use drawIndexMesh
+        - soups that are drawn more than once are worth welding into a Mesh with weldMesh(...),
+          see VertexWeld.hpp
         - all vertices that go outside of the screen bounds will be clipped
+        - positions are transformed in SIMD batches, see VertexTransform.hpp
     */
-    void drawMesh(std::vector<Vertex> vertices, djc_math::Mat4f & transform, Bitmap & bitmap); 
+    void drawMesh(std::vector<Vertex> const & vertices, djc_math::Mat4f const & transform, Bitmap & bitmap); 
 
     /*
         drawIndexedMes(...)
 
         - prefer this function over drawMesh(...) when there is repeating vertex data
         - all vertices that go outside of the screen bounds will be clipped
+        - each vertex is transformed once, in SIMD batches, see VertexTransform.hpp
+        - triangles entirely outside one clip plane are rejected before clipping
+    */
+    void drawIndexedMesh(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, djc_math::Mat4f const & transform, Bitmap & bitmap); 
+
+    /*
+        drawIndexedMesh(...)
+
+        - transform is the full model view projection
+        - the mesh's bounds are tested against the frustum planes of transform first,
+          a mesh entirely outside is skipped before any vertex is transformed
+        - meshes with meshlets are then drawn one meshlet at a time, each is frustum tested on its
+          sphere and, with CullMode::Back, back face tested on its cone before its vertices are transformed
+    */
+    void drawIndexedMesh(Mesh const & mesh, djc_math::Mat4f const & transform, Bitmap & bitmap);
+
+    /*
+        drawIndexedMesh(...)
+
+        - the same culling and drawing as the Mesh overload, for a mesh of PackedVertex
+        - each visible meshlet's vertices are decoded into scratch before they are transformed,
+          only the packed vertices are read from the mesh
+        - a packed mesh without meshlets is decoded whole on every draw, pack meshes with meshlets
+    */
+    void drawIndexedMesh(PackedMesh const & mesh, djc_math::Mat4f const & transform, Bitmap & bitmap);
+
+    CullStats const & getCullStats() const;
+    void resetCullStats();
+
+    /*
+        drawLine(...)
+
+        - vertices are in clip space, the line is clipped against the whole view volume
+        - colour is interpolated along the line, texture coordinates are ignored
+        - if depthTest is true the line is depth tested and writes to the depth buffer
+    */
+    void drawLine(Vertex v1, Vertex v2, bool depthTest = true);
+
+    /*
+        drawLines(...)
+
+        - every two indices make one line segment
+        - each vertex is transformed once no matter how many segments share it, in SIMD batches,
+          see VertexTransform.hpp
+        - segments with both ends outside the same clip plane are rejected before clipping
+        - prefer this over drawLine(...) for debug overlays with lots of segments
+    */
+    void drawLines(std::vector<Vertex> const & vertices, std::vector<unsigned int> const & indices, djc_math::Mat4f const & transform, bool depthTest = true);
+
+    /*
+        setFillMode(...)
+
+        - FillMode::Wireframe draws the edges of each triangle instead of filling it
+        - wireframe edges are depth tested
     */
-    void drawIndexedMesh(std::vector<Vertex> vertices, std::vector<unsigned int> const & indices, djc_math::Mat4f const & transform, Bitmap & bitmap); 
+    void setFillMode(FillMode mode);
+    FillMode getFillMode() const;
+
+    /*
+        setCullMode(...)
+
+        - CullMode::Back skips triangles facing away from the eye and lets whole meshlets be skipped
+        - only for closed meshes, anything seen from both sides needs CullMode::None, the default
+    */
+    void setCullMode(CullMode mode);
+    CullMode getCullMode() const;
     
+    /*
+        bindRenderTarget(...)
+
+        - all drawing goes to the bound target's colour attachments and depth buffer
+        - each colour attachment receives the FragmentOutput it was attached with
+        - the target must outlive the binding, rebind the default target when done
+    */
+    void bindRenderTarget(RenderTarget & target);
+
+    /*
+        bindDefaultRenderTarget()
+
+        - the default target draws vertex colour into the context itself
+    */
+    void bindDefaultRenderTarget();
+    RenderTarget & getRenderTarget();
+
     /* 
         clearDepthBuffer()
 
-        - clears the depth buffer if depth buffering is enabled -> todo
+        - clears the depth buffer of the bound render target
     */
     void clearDepthBuffer();
 
+    /*
+        updateContextSize(...)
+
+        - resizes the back buffer and the default render target's depth buffer
+        - handles updating the screen space transform
+        - contents are cleared, external memory is released and has to be bound again
+    */
+    void updateContextSize(int width, int height);
+
 private:
     /*
         drawTriangleWithinScreenBounds(...)
 
         - undefined behavior if a vertex is outside of the screen bounds
+        - screen positions are clamped to the edges, which only absorbs rounding left by clipping
     */
     void drawTriangleWithinScreenBounds(Vertex v1, Vertex v2, Vertex v3, Bitmap & bitmap);
+
+    /*
+        drawClippedTriangle(...)
+
+        - vertices are in clip space, planes holds the outcode bits of the planes to clip against
+        - sutherland-hodgman against each of them, the polygon left is drawn as a fan
+    */
+    void drawClippedTriangle(Vertex const & v1, Vertex const & v2, Vertex const & v3, uint8_t planes, Bitmap & bitmap);
+
+    /*
+        drawScreenTriangle(...)
+
+        - positions are already in screen space, w is still clip space w
+        - undefined behavior if a vertex is outside of the screen bounds
+    */
+    void drawScreenTriangle(Vertex v1, Vertex v2, Vertex v3, Bitmap & bitmap);
+
+    /*
+        drawTransformedTriangle(...)
+
+        - indices into the last transformPositions(...) output
+        - vertexMap takes them to indices into vertices for the attributes, nullptr when they are the same
+        - rejects on the outcodes and the cull mode, skips clipping when every vertex is inside
+    */
+    void drawTransformedTriangle(std::vector<Vertex> const & vertices, unsigned int const * vertexMap, size_t index1, size_t index2, size_t index3, Bitmap & bitmap);
+
+    /*
+        drawMeshlets(...)
+
+        - m_frustum must already hold the planes of transform
+        - testFrustum is false when the whole mesh is known to be inside
+    */
+    void drawMeshlets(Mesh const & mesh, djc_math::Mat4f const & transform, bool testFrustum, Bitmap & bitmap);
+    void drawMeshlets(PackedMesh const & mesh, djc_math::Mat4f const & transform, bool testFrustum, Bitmap & bitmap);
+
+    /*
+        findConeEye(...)
+
+        - the eye in model space for the meshlet cone tests, false when cones are not tested
+        - only CullMode::Back tests cones, and an orthographic projection has its eye at infinity
+    */
+    bool findConeEye(djc_math::Mat4f const & transform, djc_math::Vec3f & eye) const;
+
+    /*
+        cullMeshlet(...)
+
+        - true when the meshlet is outside the frustum or faces away from eye, counted in m_cullStats
+    */
+    bool cullMeshlet(Meshlet const & meshlet, bool testFrustum, bool testCones, djc_math::Vec3f const & eye);
+
+    /*
+        transformVertices(...)
+
+        - runs the batch transform into m_transformed
+    */
+    void transformVertices(std::vector<Vertex> const & vertices, djc_math::Mat4f const & transform);
+
+    // clip space position index of the last transform, with the texture coordinates and colour of attributes
+    Vertex clipVertex(Vertex const & attributes, size_t index) const;
    
     /*
         scanTriangle(...)
@@ -81,18 +263,45 @@ private:
     void drawScanLine(Edge const & left, Edge const & right, int y, Bitmap & bitmap);
 
     /*
-        updateContextSize(...)
+        drawLineWithinScreenBounds(...)
 
-        - handles updating the back buffer size
-        - handles updating the screen space transform
+        - vertices must already be clipped, positions are still in clip space
+        - bresenham stepping, colour is perspective corrected like the triangles
     */
-    void updateContextSize(float width, float height); // todo : call from window when it gets resized
+    void drawLineWithinScreenBounds(Vertex const & v1, Vertex const & v2, bool depthTest);
+
+    /*
+        drawTriangleEdges(...)
+
+        - used by FillMode::Wireframe, vertices are in clip space
+    */
+    void drawTriangleEdges(Vertex const & v1, Vertex const & v2, Vertex const & v3);
+
+    /*
+        shadeFragment(...)
+
+        - picks the value a colour attachment with the given output receives
+    */
+    djc_math::Vec3f shadeFragment(FragmentOutput output, djc_math::Vec3f const & colour, djc_math::Vec3f const & texColour, djc_math::Vec2f const & texCoord, float depth) const;
 
 private:
     djc_math::Mat4f m_screenSpaceTransform;
-    std::vector<float> m_depthBuffer;
+
+    RenderTarget   m_defaultTarget;
+    RenderTarget * m_target;
 
     float m_halfWidth;
     float m_halfHeight;
+
+    FillMode m_fillMode;
+    CullMode m_cullMode;
+
+    Frustum   m_frustum;
+    CullStats m_cullStats;
+
+    // scratch streams for the batch vertex transform, reused between draws
+    PositionStream    m_positions;
+    TransformedStream m_transformed;
+    std::vector<Vertex> m_decoded; // packed vertices of the meshlet being drawn
 };
 #endif /* RenderContext_hpp */
\ No newline at end of file
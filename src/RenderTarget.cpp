@@ -0,0 +1,116 @@
+// std
+#include <algorithm>
+#include <iostream>
+
+// my
+#include "RenderTarget.hpp"
+#include "Bitmap.hpp"
+
+//------------------------------------------------------------
+RenderTarget::RenderTarget(int width, int height) :
+    m_width(width)
+,   m_height(height)
+,   m_colourAttachmentCount(0)
+{
+    m_depthBuffer.resize(width * height);
+    clearDepth();
+}
+
+//------------------------------------------------------------
+bool
+RenderTarget::attachColour(Bitmap & bitmap, FragmentOutput output) {
+    if(m_colourAttachmentCount == MAX_COLOUR_ATTACHMENTS) {
+        std::cerr << "render target already has " << MAX_COLOUR_ATTACHMENTS << " colour attachments" << std::endl;
+        return false;
+    }
+
+    if(bitmap.getWidth() != m_width || bitmap.getHeight() != m_height) {
+        std::cerr << "colour attachment is " << bitmap.getWidth() << "x" << bitmap.getHeight()
+                  << " but the render target is " << m_width << "x" << m_height << std::endl;
+        return false;
+    }
+
+    m_colourAttachments[m_colourAttachmentCount].bitmap = &bitmap;
+    m_colourAttachments[m_colourAttachmentCount].output = output;
+    m_colourAttachmentCount++;
+    return true;
+}
+
+//------------------------------------------------------------
+void
+RenderTarget::detachColour() {
+    m_colourAttachments.fill(ColourAttachment());
+    m_colourAttachmentCount = 0;
+}
+
+//------------------------------------------------------------
+int
+RenderTarget::getWidth() const {
+    return m_width;
+}
+
+//------------------------------------------------------------
+int
+RenderTarget::getHeight() const {
+    return m_height;
+}
+
+//------------------------------------------------------------
+int
+RenderTarget::getColourAttachmentCount() const {
+    return m_colourAttachmentCount;
+}
+
+//------------------------------------------------------------
+Bitmap &
+RenderTarget::getColourAttachment(int index) {
+    return *m_colourAttachments[index].bitmap;
+}
+
+//------------------------------------------------------------
+FragmentOutput
+RenderTarget::getColourOutput(int index) const {
+    return m_colourAttachments[index].output;
+}
+
+//------------------------------------------------------------
+bool
+RenderTarget::needsTexture() const {
+    for(int i = 0; i < m_colourAttachmentCount; i++) {
+        if(m_colourAttachments[i].output == FragmentOutput::Texture ||
+           m_colourAttachments[i].output == FragmentOutput::ColourTimesTexture) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------
+std::vector<float> &
+RenderTarget::getDepthBuffer() {
+    return m_depthBuffer;
+}
+
+//------------------------------------------------------------
+void
+RenderTarget::clearColour() {
+    for(int i = 0; i < m_colourAttachmentCount; i++) {
+        m_colourAttachments[i].bitmap->clear();
+    }
+}
+
+//------------------------------------------------------------
+void
+RenderTarget::clearDepth() {
+    std::fill(std::begin(m_depthBuffer), std::end(m_depthBuffer), DEPTH_MAX);
+}
+
+//------------------------------------------------------------
+void
+RenderTarget::resize(int width, int height) {
+    m_width  = width;
+    m_height = height;
+    m_depthBuffer.resize(width * height);
+    clearDepth();
+    detachColour();
+}
@@ -0,0 +1,78 @@
+#ifndef RenderTarget_hpp
+#define RenderTarget_hpp
+
+// std
+#include <array>
+#include <vector>
+
+// my defines
+#define DEPTH_MAX -1000
+#define MAX_COLOUR_ATTACHMENTS 4
+
+class Bitmap;
+
+// what a colour attachment receives from each fragment
+enum class FragmentOutput {
+    Colour,             // interpolated vertex colour
+    Texture,            // texture sample
+    ColourTimesTexture, // vertex colour modulated by the texture sample
+    Depth,              // fragment depth written as greyscale
+    TexCoord            // texture coordinates written to red and green
+};
+
+class RenderTarget final {
+public:
+    RenderTarget(int width, int height);
+    ~RenderTarget() = default;
+
+    /*
+        attachColour(...)
+
+        - the bitmap must be the same size as the render target
+        - attachments are written in the order they are attached, up to MAX_COLOUR_ATTACHMENTS
+        - the render target does not own the bitmap, it must outlive the attachment
+    */
+    bool attachColour(Bitmap & bitmap, FragmentOutput output = FragmentOutput::Colour);
+
+    /*
+        detachColour()
+
+        - removes all colour attachments, the depth buffer is kept
+    */
+    void detachColour();
+
+    int getWidth() const;
+    int getHeight() const;
+
+    int getColourAttachmentCount() const;
+    Bitmap & getColourAttachment(int index);
+    FragmentOutput getColourOutput(int index) const;
+
+    // true if any colour attachment samples the texture passed to the draw call
+    bool needsTexture() const;
+
+    std::vector<float> & getDepthBuffer();
+
+    void clearColour();
+    void clearDepth();
+
+    /*
+        resize(...)
+
+        - resizes the depth buffer, colour attachments are detached because they no longer match
+    */
+    void resize(int width, int height);
+
+private:
+    struct ColourAttachment {
+        Bitmap *       bitmap = nullptr;
+        FragmentOutput output = FragmentOutput::Colour;
+    };
+
+    int m_width;
+    int m_height;
+    std::array<ColourAttachment, MAX_COLOUR_ATTACHMENTS> m_colourAttachments;
+    int m_colourAttachmentCount;
+    std::vector<float> m_depthBuffer;
+};
+#endif /* RenderTarget_hpp */
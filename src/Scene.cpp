@@ -0,0 +1,558 @@
+// std
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// my
+#include "Scene.hpp"
+#include "RenderContext.hpp"
+#include "djc_math/djc_math.hpp"
+
+namespace {
+    // world box of a model space box, the transformed extents are |M| * extents
+    AABB transformBox(AABB const & box, djc_math::Mat4x3f const & model) {
+        djc_math::Vec3f centre = model * box.getCentre();
+        djc_math::Vec3f extents = box.getExtents();
+
+        djc_math::Vec4f axisX = model * djc_math::Vec4f(extents.x, 0.0f, 0.0f, 0.0f);
+        djc_math::Vec4f axisY = model * djc_math::Vec4f(0.0f, extents.y, 0.0f, 0.0f);
+        djc_math::Vec4f axisZ = model * djc_math::Vec4f(0.0f, 0.0f, extents.z, 0.0f);
+
+        djc_math::Vec3f worldExtents(std::fabs(axisX.x) + std::fabs(axisY.x) + std::fabs(axisZ.x),
+                                     std::fabs(axisX.y) + std::fabs(axisY.y) + std::fabs(axisZ.y),
+                                     std::fabs(axisX.z) + std::fabs(axisY.z) + std::fabs(axisZ.z));
+
+        AABB result;
+        result.min = centre - worldExtents;
+        result.max = centre + worldExtents;
+        return result;
+    }
+
+    AABB mergeBoxes(AABB const & lhs, AABB const & rhs) {
+        AABB result;
+        result.min = djc_math::Vec3f(std::min(lhs.min.x, rhs.min.x), std::min(lhs.min.y, rhs.min.y), std::min(lhs.min.z, rhs.min.z));
+        result.max = djc_math::Vec3f(std::max(lhs.max.x, rhs.max.x), std::max(lhs.max.y, rhs.max.y), std::max(lhs.max.z, rhs.max.z));
+        return result;
+    }
+
+    bool sameBox(AABB const & lhs, AABB const & rhs) {
+        return lhs.min.x == rhs.min.x && lhs.min.y == rhs.min.y && lhs.min.z == rhs.min.z
+            && lhs.max.x == rhs.max.x && lhs.max.y == rhs.max.y && lhs.max.z == rhs.max.z;
+    }
+
+    // the largest factor the model scales any direction by
+    float maxScale(djc_math::Mat4x3f const & model) {
+        djc_math::Vec4f axisX = model * djc_math::Vec4f(1.0f, 0.0f, 0.0f, 0.0f);
+        djc_math::Vec4f axisY = model * djc_math::Vec4f(0.0f, 1.0f, 0.0f, 0.0f);
+        djc_math::Vec4f axisZ = model * djc_math::Vec4f(0.0f, 0.0f, 1.0f, 0.0f);
+
+        float scale2 = std::max(axisX.x * axisX.x + axisX.y * axisX.y + axisX.z * axisX.z,
+                       std::max(axisY.x * axisY.x + axisY.y * axisY.y + axisY.z * axisY.z,
+                                axisZ.x * axisZ.x + axisZ.y * axisZ.y + axisZ.z * axisZ.z));
+        return std::sqrt(scale2);
+    }
+
+    float surfaceArea(AABB const & box) {
+        djc_math::Vec3f size = box.max - box.min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+}
+
+//------------------------------------------------------------
+Scene::Scene()
+:   m_instanceCount(0)
+,   m_builtArea(0.0f)
+,   m_area(0.0f)
+,   m_needsRebuild(false)
+,   m_lodPixelError(LOD_PIXEL_ERROR)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+InstanceId
+Scene::addInstance(Mesh const & mesh, djc_math::Mat4x3f const & model) {
+    InstanceId instance;
+
+    if(!m_freeInstances.empty()) {
+        instance = m_freeInstances.back();
+        m_freeInstances.pop_back();
+    } else {
+        instance = static_cast<InstanceId>(m_instances.size());
+        m_instances.emplace_back();
+    }
+
+    Instance & slot = m_instances[instance];
+    slot.mesh     = &mesh;
+    slot.lods     = nullptr;
+    slot.model    = model;
+    slot.leaf     = 0;
+    slot.slot     = 0;
+    slot.lodLevel = 0;
+    slot.alive    = true;
+    slot.occluder = false;
+    slot.moved    = false;
+
+    m_instanceCount++;
+    m_needsRebuild = true;
+    return instance;
+}
+
+//------------------------------------------------------------
+InstanceId
+Scene::addInstance(LodChain const & lods, djc_math::Mat4x3f const & model) {
+    if(lods.levels.empty()) {
+        std::cerr << "Scene::addInstance - the lod chain has no levels" << std::endl;
+        return SCENE_INVALID_INSTANCE;
+    }
+
+    InstanceId instance = addInstance(lods.levels[0].mesh, model);
+    m_instances[instance].lods = &lods;
+    return instance;
+}
+
+//------------------------------------------------------------
+void
+Scene::removeInstance(InstanceId instance) {
+    if(!isLive(instance, "Scene::removeInstance")) {
+        return;
+    }
+
+    m_instances[instance].alive = false;
+    m_freeInstances.push_back(instance);
+
+    m_instanceCount--;
+    m_needsRebuild = true;
+}
+
+//------------------------------------------------------------
+void
+Scene::clear() {
+    m_instances.clear();
+    m_freeInstances.clear();
+    m_instanceCount = 0;
+
+    m_nodes.clear();
+    m_buildEntries.clear();
+    m_slotBoxes.clear();
+    m_slotItems.clear();
+    m_dirtyNodes.clear();
+    m_movedInstances.clear();
+    m_drawList.clear();
+
+    m_builtArea = 0.0f;
+    m_area = 0.0f;
+    m_needsRebuild = false;
+}
+
+//------------------------------------------------------------
+void
+Scene::setTransform(InstanceId instance, djc_math::Mat4x3f const & model) {
+    if(!isLive(instance, "Scene::setTransform")) {
+        return;
+    }
+
+    Instance & slot = m_instances[instance];
+    slot.model = model;
+
+    if(!slot.moved) {
+        slot.moved = true;
+        m_movedInstances.push_back(instance);
+    }
+}
+
+//------------------------------------------------------------
+void
+Scene::setMesh(InstanceId instance, Mesh const & mesh) {
+    if(!isLive(instance, "Scene::setMesh")) {
+        return;
+    }
+
+    Instance & slot = m_instances[instance];
+    slot.mesh     = &mesh;
+    slot.lods     = nullptr;
+    slot.lodLevel = 0;
+
+    if(!slot.moved) {
+        slot.moved = true;
+        m_movedInstances.push_back(instance);
+    }
+}
+
+//------------------------------------------------------------
+djc_math::Mat4x3f const &
+Scene::getTransform(InstanceId instance) const {
+    static djc_math::Mat4x3f const identity(djc_math::createMat4IdentityMatrix<float>());
+    if(!isLive(instance, "Scene::getTransform")) {
+        return identity;
+    }
+
+    return m_instances[instance].model;
+}
+
+//------------------------------------------------------------
+size_t
+Scene::getInstanceCount() const {
+    return m_instanceCount;
+}
+
+//------------------------------------------------------------
+size_t
+Scene::getLodLevel(InstanceId instance) const {
+    if(!isLive(instance, "Scene::getLodLevel")) {
+        return 0;
+    }
+
+    return m_instances[instance].lodLevel;
+}
+
+//------------------------------------------------------------
+void
+Scene::setLodPixelError(float pixels) {
+    m_lodPixelError = pixels;
+}
+
+//------------------------------------------------------------
+void
+Scene::setOccluder(InstanceId instance, bool occluder) {
+    if(!isLive(instance, "Scene::setOccluder")) {
+        return;
+    }
+
+    m_instances[instance].occluder = occluder;
+}
+
+//------------------------------------------------------------
+void
+Scene::setOcclusionCulling(bool enabled, int width, int height) {
+    if(enabled) {
+        m_occlusionBuffer.reset(new OcclusionBuffer(width, height));
+    } else {
+        m_occlusionBuffer.reset();
+    }
+}
+
+//------------------------------------------------------------
+OcclusionBuffer *
+Scene::getOcclusionBuffer() {
+    return m_occlusionBuffer.get();
+}
+
+//------------------------------------------------------------
+void
+Scene::update() {
+    if(m_needsRebuild) {
+        rebuild();
+        return;
+    }
+
+    if(!m_movedInstances.empty()) {
+        refit();
+
+        // refitting keeps the topology, so boxes loosen as instances drift apart from their neighbours
+        if(m_area > m_builtArea * SCENE_REBUILD_RATIO) {
+            rebuild();
+        }
+    }
+}
+
+//------------------------------------------------------------
+std::vector<DrawItem> const &
+Scene::buildDrawList(Frustum const & frustum) {
+    update();
+    m_drawList.clear();
+
+    if(m_nodes.empty()) {
+        return m_drawList;
+    }
+
+    m_stack.clear();
+    m_stack.emplace_back(0u, Frustum::ALL_PLANES);
+
+    while(!m_stack.empty()) {
+        uint32_t nodeIndex = m_stack.back().first;
+        unsigned int planeMask = m_stack.back().second;
+        m_stack.pop_back();
+
+        Node const & node = m_nodes[nodeIndex];
+        Frustum::Visibility visibility = frustum.classify(node.box, planeMask);
+
+        if(visibility == Frustum::Visibility::Outside) {
+            continue;
+        }
+
+        if(visibility == Frustum::Visibility::Inside) {
+            m_drawList.insert(m_drawList.end(), m_slotItems.begin() + node.begin, m_slotItems.begin() + node.begin + node.count);
+            continue;
+        }
+
+        if(node.left == 0) {
+            // a straddling leaf, its few instances are tested on their own
+            for(uint32_t i = node.begin; i < node.begin + node.count; i++) {
+                unsigned int instanceMask = planeMask;
+
+                if(frustum.classify(m_slotBoxes[i], instanceMask) != Frustum::Visibility::Outside) {
+                    m_drawList.push_back(m_slotItems[i]);
+                }
+            }
+            continue;
+        }
+
+        m_stack.emplace_back(node.left + 1, planeMask);
+        m_stack.emplace_back(node.left, planeMask);
+    }
+
+    return m_drawList;
+}
+
+//------------------------------------------------------------
+size_t
+Scene::draw(RenderContext & context, djc_math::Mat4f const & viewProjection, Bitmap & bitmap) {
+    m_frustum.update(viewProjection);
+
+    buildDrawList(m_frustum);
+
+    if(m_occlusionBuffer) {
+        cullOccluded(viewProjection);
+    }
+
+    selectLods(viewProjection, context.getRenderTarget().getHeight() * 0.5f);
+
+    for(auto const & item : m_drawList) {
+        context.drawIndexedMesh(*item.mesh, viewProjection * *item.model, bitmap);
+    }
+
+    return m_drawList.size();
+}
+
+/* PRIVATE */
+
+//------------------------------------------------------------
+void
+Scene::rebuild() {
+    m_buildEntries.clear();
+    m_buildEntries.reserve(m_instanceCount);
+
+    for(InstanceId i = 0; i < m_instances.size(); i++) {
+        Instance & instance = m_instances[i];
+        if(!instance.alive) {
+            continue;
+        }
+
+        instance.moved = false;
+
+        BuildEntry entry;
+        entry.box      = transformBox(instance.mesh->bounds.box, instance.model);
+        entry.centre   = entry.box.getCentre();
+        entry.instance = i;
+        m_buildEntries.push_back(entry);
+    }
+
+    m_movedInstances.clear();
+    m_needsRebuild = false;
+
+    m_nodes.clear();
+    m_slotBoxes.clear();
+    m_slotItems.clear();
+    m_area = 0.0f;
+
+    if(m_buildEntries.empty()) {
+        m_dirtyNodes.clear();
+        m_builtArea = 0.0f;
+        return;
+    }
+
+    // at most 2n - 1 nodes for n leaves
+    m_nodes.reserve(2 * (m_buildEntries.size() / SCENE_LEAF_SIZE + 1));
+    m_nodes.emplace_back();
+    m_nodes[0].parent = 0;
+    buildNode(0, 0, static_cast<uint32_t>(m_buildEntries.size()));
+
+    // the entries are now in leaf order, culling and refitting only touch these arrays
+    m_slotBoxes.reserve(m_buildEntries.size());
+    m_slotItems.reserve(m_buildEntries.size());
+
+    for(uint32_t slot = 0; slot < m_buildEntries.size(); slot++) {
+        Instance & instance = m_instances[m_buildEntries[slot].instance];
+        instance.slot = slot;
+
+        m_slotBoxes.push_back(m_buildEntries[slot].box);
+        m_slotItems.push_back(DrawItem{ instance.mesh, &instance.model, m_buildEntries[slot].instance });
+    }
+
+    m_dirtyNodes.assign(m_nodes.size(), 0);
+    m_builtArea = m_area;
+}
+
+//------------------------------------------------------------
+void
+Scene::buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t count) {
+    // nodeIndex was allocated by the caller, m_nodes may grow so it is indexed again after recursing
+    m_nodes[nodeIndex].left  = 0;
+    m_nodes[nodeIndex].begin = begin;
+    m_nodes[nodeIndex].count = count;
+
+    if(count <= SCENE_LEAF_SIZE) {
+        AABB box = m_buildEntries[begin].box;
+
+        for(uint32_t i = begin; i < begin + count; i++) {
+            box = mergeBoxes(box, m_buildEntries[i].box);
+            m_instances[m_buildEntries[i].instance].leaf = nodeIndex;
+        }
+
+        m_nodes[nodeIndex].box = box;
+        m_area += surfaceArea(box);
+        return;
+    }
+
+    // median split on the longest axis of the centres
+    djc_math::Vec3f centreMin = m_buildEntries[begin].centre;
+    djc_math::Vec3f centreMax = centreMin;
+
+    for(uint32_t i = begin + 1; i < begin + count; i++) {
+        djc_math::Vec3f const & centre = m_buildEntries[i].centre;
+        centreMin = djc_math::Vec3f(std::min(centreMin.x, centre.x), std::min(centreMin.y, centre.y), std::min(centreMin.z, centre.z));
+        centreMax = djc_math::Vec3f(std::max(centreMax.x, centre.x), std::max(centreMax.y, centre.y), std::max(centreMax.z, centre.z));
+    }
+
+    djc_math::Vec3f spread = centreMax - centreMin;
+    auto first = m_buildEntries.begin() + begin;
+    auto middle = first + count / 2;
+    auto last = first + count;
+
+    if(spread.x >= spread.y && spread.x >= spread.z) {
+        std::nth_element(first, middle, last, [](BuildEntry const & lhs, BuildEntry const & rhs) { return lhs.centre.x < rhs.centre.x; });
+    } else if(spread.y >= spread.z) {
+        std::nth_element(first, middle, last, [](BuildEntry const & lhs, BuildEntry const & rhs) { return lhs.centre.y < rhs.centre.y; });
+    } else {
+        std::nth_element(first, middle, last, [](BuildEntry const & lhs, BuildEntry const & rhs) { return lhs.centre.z < rhs.centre.z; });
+    }
+
+    uint32_t left = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.resize(left + 2);
+    m_nodes[left + 0].parent = nodeIndex;
+    m_nodes[left + 1].parent = nodeIndex;
+
+    uint32_t half = count / 2;
+    buildNode(left + 0, begin, half);
+    buildNode(left + 1, begin + half, count - half);
+
+    m_nodes[nodeIndex].left = left;
+    m_nodes[nodeIndex].box  = mergeBoxes(m_nodes[left].box, m_nodes[left + 1].box);
+    m_area += surfaceArea(m_nodes[nodeIndex].box);
+}
+
+//------------------------------------------------------------
+void
+Scene::refit() {
+    for(InstanceId id : m_movedInstances) {
+        Instance & instance = m_instances[id];
+        instance.moved = false;
+
+        if(!instance.alive) {
+            continue;
+        }
+
+        m_slotBoxes[instance.slot] = transformBox(instance.mesh->bounds.box, instance.model);
+        m_slotItems[instance.slot].mesh = instance.mesh;
+        m_dirtyNodes[instance.leaf] = 1;
+    }
+    m_movedInstances.clear();
+
+    // children always come after their parent, so one backwards sweep refits bottom up
+    for(size_t i = m_nodes.size(); i-- > 0;) {
+        if(!m_dirtyNodes[i]) {
+            continue;
+        }
+        m_dirtyNodes[i] = 0;
+
+        Node & node = m_nodes[i];
+        AABB box = node.left == 0 ? boundsOfRange(node.begin, node.count)
+                                  : mergeBoxes(m_nodes[node.left].box, m_nodes[node.left + 1].box);
+
+        if(sameBox(box, node.box)) {
+            continue; // nothing above this node changes
+        }
+
+        m_area += surfaceArea(box) - surfaceArea(node.box);
+        node.box = box;
+
+        if(i != 0) {
+            m_dirtyNodes[node.parent] = 1;
+        }
+    }
+}
+
+//------------------------------------------------------------
+void
+Scene::cullOccluded(djc_math::Mat4f const & viewProjection) {
+    m_occlusionBuffer->clear();
+
+    for(auto const & item : m_drawList) {
+        if(m_instances[item.instance].occluder) {
+            m_occlusionBuffer->drawOccluder(item.mesh->vertices, item.mesh->indices, viewProjection * *item.model);
+        }
+    }
+
+    // compacted in place so the draw order is kept
+    auto visible = std::remove_if(m_drawList.begin(), m_drawList.end(), [this, &viewProjection](DrawItem const & item) {
+        Instance const & instance = m_instances[item.instance];
+        return !instance.occluder && !m_occlusionBuffer->isVisible(m_slotBoxes[instance.slot], viewProjection);
+    });
+
+    m_drawList.erase(visible, m_drawList.end());
+}
+
+//------------------------------------------------------------
+void
+Scene::selectLods(djc_math::Mat4f const & viewProjection, float halfHeight) {
+    // clip y and w rows, the view is rigid so the y row's length is the projection's y scale
+    // and the w row gives the distance along the view direction
+    djc_math::Mat4f transposed = djc_math::transpose(viewProjection);
+    djc_math::Vec4f rowY = transposed * djc_math::Vec4f(0.0f, 1.0f, 0.0f, 0.0f);
+    djc_math::Vec4f rowW = transposed * djc_math::Vec4f(0.0f, 0.0f, 0.0f, 1.0f);
+
+    float const pixelsAtUnitDistance = halfHeight * djc_math::Vec3f(rowY.x, rowY.y, rowY.z).length();
+
+    for(auto & item : m_drawList) {
+        Instance & instance = m_instances[item.instance];
+        if(!instance.lods) {
+            continue;
+        }
+
+        // measured at the nearest point of the bounding sphere, so the whole mesh is within the error
+        BoundingSphere const & sphere = instance.mesh->bounds.sphere;
+        djc_math::Vec3f centre = instance.model * sphere.centre;
+        float scale = maxScale(instance.model);
+        float distance = rowW.x * centre.x + rowW.y * centre.y + rowW.z * centre.z + rowW.w - sphere.radius * scale;
+
+        // reaching into the near plane, only the finest level will do
+        float pixelsPerUnit = distance > 0.0f ? pixelsAtUnitDistance * scale / distance : FLT_MAX;
+
+        instance.lodLevel = static_cast<uint32_t>(selectLod(*instance.lods, pixelsPerUnit, instance.lodLevel, m_lodPixelError));
+        item.mesh = &instance.lods->levels[instance.lodLevel].mesh;
+    }
+}
+
+//------------------------------------------------------------
+AABB
+Scene::boundsOfRange(uint32_t begin, uint32_t count) const {
+    AABB box = m_slotBoxes[begin];
+
+    for(uint32_t i = begin + 1; i < begin + count; i++) {
+        box = mergeBoxes(box, m_slotBoxes[i]);
+    }
+
+    return box;
+}
+
+//------------------------------------------------------------
+bool
+Scene::isLive(InstanceId instance, char const * caller) const {
+    if(instance >= m_instances.size() || !m_instances[instance].alive) {
+        std::cerr << caller << " - " << instance << " is not a live instance" << std::endl;
+        return false;
+    }
+
+    return true;
+}
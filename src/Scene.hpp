@@ -0,0 +1,192 @@
+#ifndef Scene_hpp
+#define Scene_hpp
+
+// std
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// my
+#include "Bounds.hpp"
+#include "Frustum.hpp"
+#include "Lod.hpp"
+#include "Mesh.hpp"
+#include "OcclusionBuffer.hpp"
+#include "djc_math/Mat4x3.hpp"
+
+class Bitmap;
+class RenderContext;
+
+// my defines
+#define SCENE_LEAF_SIZE        4          // instances per BVH leaf
+#define SCENE_REBUILD_RATIO    1.5f       // rebuild once refitting has grown the tree's surface area by this much
+#define SCENE_INVALID_INSTANCE 0xFFFFFFFFu
+
+using InstanceId = uint32_t;
+
+// one visible instance, the pointers stay valid until the scene is next changed
+struct DrawItem {
+    Mesh const * mesh;
+    djc_math::Mat4x3f const * model;
+    InstanceId instance;
+};
+
+/*
+    Scene
+
+    - mesh instances kept in a bounding volume hierarchy of world space boxes
+    - meshes and lod chains are referenced, not copied, and must outlive the scene
+    - adding or removing instances rebuilds the tree on the next update(), moving
+      them only refits the boxes above them, with a rebuild once the tree has loosened
+*/
+class Scene final {
+public:
+    Scene();
+    Scene(Scene const &) = delete;
+    Scene & operator = (Scene const &) = delete;
+    ~Scene() = default;
+
+    InstanceId addInstance(Mesh const & mesh, djc_math::Mat4x3f const & model);
+
+    /*
+        addInstance(...)
+
+        - an instance drawn with the level of lods picked by its size on screen each draw(...)
+        - culled on the bounds of level 0, which contain every coarser level
+    */
+    InstanceId addInstance(LodChain const & lods, djc_math::Mat4x3f const & model);
+    void removeInstance(InstanceId instance);
+    void clear();
+
+    void setTransform(InstanceId instance, djc_math::Mat4x3f const & model);
+    djc_math::Mat4x3f const & getTransform(InstanceId instance) const;
+
+    /*
+        setMesh(...)
+
+        - swaps the mesh an instance draws, e.g. a placeholder for the asset once it has loaded
+        - the instance's box is refit like a move, a lod chain it had is dropped
+    */
+    void setMesh(InstanceId instance, Mesh const & mesh);
+
+    size_t getInstanceCount() const;
+    size_t getLodLevel(InstanceId instance) const; // the level last drawn, 0 for instances without a chain
+
+    // simplification error allowed on screen in pixels, see selectLod(...)
+    void setLodPixelError(float pixels);
+
+    /*
+        setOccluder(...)
+
+        - occluders are drawn into the occlusion buffer before anything is tested against it
+        - pick large solid meshes, walls and buildings rather than detail
+    */
+    void setOccluder(InstanceId instance, bool occluder);
+
+    /*
+        setOcclusionCulling(...)
+
+        - draw(...) rasterizes the occluders that survived frustum culling into a small depth
+          buffer and skips instances whose world box is hidden behind them, see OcclusionBuffer.hpp
+        - occluders themselves are always drawn
+    */
+    void setOcclusionCulling(bool enabled, int width = OCCLUSION_BUFFER_WIDTH, int height = OCCLUSION_BUFFER_HEIGHT);
+    OcclusionBuffer * getOcclusionBuffer(); // nullptr while occlusion culling is off
+
+    /*
+        update()
+
+        - brings the tree up to date, called by buildDrawList(...) so only needed to
+          control when the cost is paid
+        - rebuilds after adds and removes, otherwise refits the moved instances
+    */
+    void update();
+
+    /*
+        buildDrawList(...)
+
+        - frustum is in world space, built from projection * view
+        - whole subtrees are rejected or accepted at once, planes a parent is
+          entirely inside of are not tested again by its children
+        - the list is owned by the scene and reused, it is valid until the next call
+    */
+    std::vector<DrawItem> const & buildDrawList(Frustum const & frustum);
+
+    /*
+        draw(...)
+
+        - culls with the frustum of viewProjection, then the occlusion buffer when enabled,
+          and draws every visible instance, instances with a lod chain at the level their size calls for
+        - returns the number of instances that were submitted to the context
+        - each drawn instance is tested once more on its model space bounds by
+          RenderContext::drawIndexedMesh(Mesh const &, ...), which is tighter than the world box
+    */
+    size_t draw(RenderContext & context, djc_math::Mat4f const & viewProjection, Bitmap & bitmap);
+
+private:
+    struct Instance {
+        Mesh const *      mesh;  // level 0 of lods when there is a chain
+        LodChain const *  lods;  // nullptr for a single mesh
+        djc_math::Mat4x3f model;
+        uint32_t          leaf;  // node whose range holds this instance
+        uint32_t          slot;  // position in leaf order
+        uint32_t          lodLevel;
+        bool              alive;
+        bool              occluder;
+        bool              moved;
+    };
+
+    // children are always allocated in pairs, left is the first and right = left + 1
+    struct Node {
+        AABB     box;
+        uint32_t left;   // 0 for leaves, the root is never a child
+        uint32_t parent;
+        uint32_t begin;  // range of leaf order slots covered by this subtree
+        uint32_t count;
+    };
+
+    struct BuildEntry {
+        djc_math::Vec3f centre;
+        AABB            box;
+        InstanceId      instance;
+    };
+
+private:
+    void rebuild();
+    void buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t count);
+    void refit();
+    void cullOccluded(djc_math::Mat4f const & viewProjection);
+    void selectLods(djc_math::Mat4f const & viewProjection, float halfHeight);
+    AABB boundsOfRange(uint32_t begin, uint32_t count) const;
+    bool isLive(InstanceId instance, char const * caller) const; // reports ids out of range or already removed
+
+private:
+    std::vector<Instance>   m_instances;
+    std::vector<InstanceId> m_freeInstances;
+    size_t                  m_instanceCount;
+
+    std::vector<Node>       m_nodes;
+    std::vector<BuildEntry> m_buildEntries;
+    std::vector<uint8_t>    m_dirtyNodes;
+    std::vector<InstanceId> m_movedInstances;
+
+    // live instances in leaf order, every subtree is one contiguous range of these
+    std::vector<AABB>     m_slotBoxes; // world space
+    std::vector<DrawItem> m_slotItems;
+
+    float m_builtArea; // sum of the node surface areas after the last rebuild
+    float m_area;      // the same sum kept up to date by refitting
+
+    bool m_needsRebuild;
+
+    std::vector<DrawItem> m_drawList;
+    std::vector<std::pair<uint32_t, unsigned int>> m_stack; // node and the planes still to test
+    Frustum m_frustum;
+
+    std::unique_ptr<OcclusionBuffer> m_occlusionBuffer;
+
+    float m_lodPixelError;
+};
+
+#endif /* Scene_hpp */
@@ -0,0 +1,155 @@
+// std
+#include <algorithm>
+#include <chrono>
+
+// my
+#include "SwapChain.hpp"
+
+//------------------------------------------------------------
+SwapChain::SwapChain(int width, int height, int maxFramesInFlight) :
+    m_width(width)
+,   m_height(height)
+,   m_maxFramesInFlight(std::max(maxFramesInFlight, 1))
+,   m_back(-1)
+,   m_front(-1)
+,   m_closed(false)
+{
+    // frames in flight + the one being rendered
+    m_buffers.resize(m_maxFramesInFlight + 1);
+    m_frameSizes.resize(m_buffers.size(), FrameSize{ width, height });
+    for(size_t i = 0; i < m_buffers.size(); i++) {
+        m_buffers[i].resize(static_cast<size_t>(width) * height * 4);
+        m_free.push_back(static_cast<int>(i));
+    }
+}
+
+//------------------------------------------------------------
+unsigned char *
+SwapChain::acquireBackBuffer() {
+    using clock = std::chrono::high_resolution_clock;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if(m_free.empty() && !m_closed) {
+        auto begin = clock::now();
+        m_bufferFree.wait(lock, [this] { return !m_free.empty() || m_closed; });
+        m_stats.renderWaits++;
+        m_stats.renderWaitMs += std::chrono::duration<double, std::milli>(clock::now() - begin).count();
+    }
+
+    if(m_closed) {
+        return nullptr;
+    }
+
+    m_back = m_free.front();
+    m_free.pop_front();
+    return m_buffers[m_back].data();
+}
+
+//------------------------------------------------------------
+void
+SwapChain::submit() {
+    submit(m_width, m_height);
+}
+
+//------------------------------------------------------------
+void
+SwapChain::submit(int width, int height) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if(m_back == -1) {
+            return;
+        }
+
+        m_frameSizes[m_back] = FrameSize{ std::min(width, m_width), std::min(height, m_height) };
+        m_queued.push_back(m_back);
+        m_back = -1;
+        m_stats.submitted++;
+    }
+    m_frameQueued.notify_one();
+}
+
+//------------------------------------------------------------
+unsigned char const *
+SwapChain::acquireFrontBuffer() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_frameQueued.wait(lock, [this] { return !m_queued.empty() || m_closed; });
+
+    if(m_closed) {
+        return nullptr;
+    }
+
+    m_front = m_queued.front();
+    m_queued.pop_front();
+    return m_buffers[m_front].data();
+}
+
+//------------------------------------------------------------
+void
+SwapChain::releaseFrontBuffer() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if(m_front == -1) {
+            return;
+        }
+
+        m_free.push_back(m_front);
+        m_front = -1;
+        m_stats.presented++;
+    }
+    m_bufferFree.notify_one();
+}
+
+//------------------------------------------------------------
+void
+SwapChain::getFrontBufferSize(int & width, int & height) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    FrameSize size = m_front == -1 ? FrameSize{ m_width, m_height } : m_frameSizes[m_front];
+    width  = size.width;
+    height = size.height;
+}
+
+//------------------------------------------------------------
+void
+SwapChain::close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_bufferFree.notify_all();
+    m_frameQueued.notify_all();
+}
+
+//------------------------------------------------------------
+int
+SwapChain::getWidth() const {
+    return m_width;
+}
+
+//------------------------------------------------------------
+int
+SwapChain::getHeight() const {
+    return m_height;
+}
+
+//------------------------------------------------------------
+int
+SwapChain::getPitch() const {
+    return m_width * 4;
+}
+
+//------------------------------------------------------------
+int
+SwapChain::getMaxFramesInFlight() const {
+    return m_maxFramesInFlight;
+}
+
+//------------------------------------------------------------
+SwapChain::Stats
+SwapChain::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,104 @@
+#ifndef SwapChain_hpp
+#define SwapChain_hpp
+
+// std
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/*
+    SwapChain
+
+    - a set of colour buffers passed between one render thread and one present thread
+    - the render thread fills a back buffer while the present thread shows the oldest queued one
+    - maxFramesInFlight bounds how many finished frames can wait to be presented (latency)
+    - no SDL, the present side is whatever the owner does with the pixels
+*/
+class SwapChain final {
+public:
+    struct Stats {
+        uint64_t submitted      = 0;
+        uint64_t presented      = 0;
+        uint64_t renderWaits    = 0; // acquires that waited for the present thread
+        double   renderWaitMs   = 0.0;
+    };
+
+public:
+    SwapChain(int width, int height, int maxFramesInFlight);
+    SwapChain(SwapChain const &) = delete;
+    SwapChain & operator = (SwapChain const &) = delete;
+    ~SwapChain() = default;
+
+    /* render thread */
+
+    /*
+        acquireBackBuffer()
+
+        - blocks while maxFramesInFlight frames are already waiting to be presented
+        - returns nullptr once the swap chain is closed
+    */
+    unsigned char * acquireBackBuffer();
+
+    /*
+        submit()
+
+        - queues the acquired back buffer for presenting
+        - width and height are the part of the buffer that was rendered, from the top left
+        - a frame can be smaller than the swap chain, e.g. with dynamic resolution
+    */
+    void submit();
+    void submit(int width, int height);
+
+    /* present thread */
+
+    /*
+        acquireFrontBuffer()
+
+        - blocks until a frame is queued, returns nullptr once the swap chain is closed
+        - the buffer stays reserved until releaseFrontBuffer()
+    */
+    unsigned char const * acquireFrontBuffer();
+    void releaseFrontBuffer();
+
+    // the size the acquired front buffer was submitted with
+    void getFrontBufferSize(int & width, int & height) const;
+
+    /*
+        close()
+
+        - wakes both threads, every acquire returns nullptr from now on
+    */
+    void close();
+
+    int getWidth() const;
+    int getHeight() const;
+    int getPitch() const;
+    int getMaxFramesInFlight() const;
+    Stats getStats() const;
+
+private:
+    int m_width;
+    int m_height;
+    int m_maxFramesInFlight;
+
+    struct FrameSize {
+        int width;
+        int height;
+    };
+
+    std::vector<std::vector<unsigned char>> m_buffers;
+    std::vector<FrameSize> m_frameSizes;
+    std::deque<int> m_free;   // ready to be rendered to
+    std::deque<int> m_queued; // finished, waiting to be presented
+    int m_back;               // owned by the render thread, -1 if none
+    int m_front;              // owned by the present thread, -1 if none
+    bool m_closed;
+
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_bufferFree;
+    std::condition_variable m_frameQueued;
+    Stats                   m_stats;
+};
+#endif /* SwapChain_hpp */
@@ -0,0 +1,122 @@
+#ifndef TextParse_hpp
+#define TextParse_hpp
+
+// std
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// my defines
+#define TEXT_FAST_PATH_MAX_DIGITS   9         // still fits a uint32_t
+#define TEXT_FAST_PATH_MAX_MANTISSA (1u << 24) // integers up to here are exact in a float
+
+/*
+    text parsing helpers shared by the mesh importers
+
+    - work on [begin, end) ranges inside a read buffer, nothing is allocated or copied
+    - parseNumber(...) fails unless the whole token is the number
+*/
+
+inline bool
+isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// next whitespace separated token of a line, false when the line has none left
+inline bool
+nextToken(char const *& cursor, char const * end, char const *& tokenBegin, char const *& tokenEnd) {
+    while(cursor < end && isSpace(*cursor)) {
+        cursor++;
+    }
+
+    if(cursor == end) {
+        return false;
+    }
+
+    tokenBegin = cursor;
+    while(cursor < end && !isSpace(*cursor)) {
+        cursor++;
+    }
+    tokenEnd = cursor;
+    return true;
+}
+
+inline bool
+parseNumber(char const * begin, char const * end, float & value) {
+    static float const powersOfTen[TEXT_FAST_PATH_MAX_DIGITS + 1] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f };
+
+    // std::stof accepted a leading plus, from_chars does not
+    if(begin < end && *begin == '+') {
+        begin++;
+    }
+
+    // exporters write fixed point like -0.123456, while the digits stay under TEXT_FAST_PATH_MAX_MANTISSA
+    // they and the power of ten are both exact in a float, so one divide rounds the same as from_chars
+    char const * cursor = begin;
+    bool negative = cursor < end && *cursor == '-';
+    cursor += negative;
+
+    uint32_t mantissa = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+
+    while(cursor < end && *cursor >= '0' && *cursor <= '9' && digits < TEXT_FAST_PATH_MAX_DIGITS) {
+        mantissa = mantissa * 10 + static_cast<uint32_t>(*cursor++ - '0');
+        digits++;
+    }
+
+    if(cursor < end && *cursor == '.') {
+        cursor++;
+        while(cursor < end && *cursor >= '0' && *cursor <= '9' && digits < TEXT_FAST_PATH_MAX_DIGITS) {
+            mantissa = mantissa * 10 + static_cast<uint32_t>(*cursor++ - '0');
+            digits++;
+            fractionDigits++;
+        }
+    }
+
+    if(cursor == end && digits > 0 && mantissa <= TEXT_FAST_PATH_MAX_MANTISSA) {
+        float magnitude = static_cast<float>(mantissa) / powersOfTen[fractionDigits];
+        value = negative ? -magnitude : magnitude;
+        return true;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+#else
+    // from_chars without floating point support, the token is copied so strtof stops at its end
+    char token[64];
+    size_t length = static_cast<size_t>(end - begin);
+    if(length == 0 || length >= sizeof(token)) {
+        return false;
+    }
+    std::memcpy(token, begin, length);
+    token[length] = 0;
+
+    char * parsed = nullptr;
+    value = std::strtof(token, &parsed);
+    return parsed == token + length;
+#endif
+}
+
+inline bool
+parseNumber(char const * begin, char const * end, size_t & value) {
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+inline bool
+parseNumber(char const * begin, char const * end, int64_t & value) {
+    std::from_chars_result result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// file names are told apart by their extension
+inline bool
+endsWith(std::string const & text, std::string const & suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+#endif /* TextParse_hpp */
@@ -0,0 +1,86 @@
+// std
+#include <algorithm>
+
+// my
+#include "ThreadPool.hpp"
+
+//------------------------------------------------------------
+ThreadPool::ThreadPool(size_t threadCount)
+:   m_running(0)
+,   m_quit(false)
+{
+    if(threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    m_threads.reserve(threadCount);
+    for(size_t i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+//------------------------------------------------------------
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_jobReady.notify_all();
+
+    for(auto & thread : m_threads) {
+        thread.join();
+    }
+}
+
+//------------------------------------------------------------
+void
+ThreadPool::submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_jobReady.notify_one();
+}
+
+//------------------------------------------------------------
+void
+ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_jobs.empty() && m_running == 0; });
+}
+
+//------------------------------------------------------------
+size_t
+ThreadPool::getThreadCount() const {
+    return m_threads.size();
+}
+
+/* PRIVATE */
+
+//------------------------------------------------------------
+void
+ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while(true) {
+        m_jobReady.wait(lock, [this] { return m_quit || !m_jobs.empty(); });
+
+        // the queue is drained before quitting so no submitted job is lost
+        if(m_jobs.empty()) {
+            return;
+        }
+
+        std::function<void()> job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_running++;
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        m_running--;
+        if(m_jobs.empty() && m_running == 0) {
+            m_idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+// std
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+    ThreadPool
+
+    - a fixed set of worker threads taking jobs from one queue in the order they were submitted
+    - jobs must not throw, report failures through whatever they return
+    - the destructor finishes every queued job before joining the workers
+*/
+class ThreadPool final {
+public:
+    // 0 uses one thread per hardware thread
+    explicit ThreadPool(size_t threadCount = 0);
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool & operator = (ThreadPool const &) = delete;
+    ~ThreadPool();
+
+    void submit(std::function<void()> job);
+
+    // blocks until the queue is empty and no job is running
+    void wait();
+
+    size_t getThreadCount() const;
+
+private:
+    void workerLoop();
+
+private:
+    std::vector<std::thread>          m_threads;
+    std::deque<std::function<void()>> m_jobs;
+    size_t                            m_running; // jobs taken from the queue and not finished
+    bool                              m_quit;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_jobReady;
+    std::condition_variable m_idle;
+};
+
+#endif /* ThreadPool_hpp */
@@ -0,0 +1,179 @@
+// std
+#include <cstdint>
+
+// my
+#include "VertexCache.hpp"
+
+namespace {
+    const unsigned int NO_VERTEX = UINT32_MAX;
+}
+
+//------------------------------------------------------------
+float
+computeAcmr(std::vector<unsigned int> const & indices, size_t vertexCount, size_t cacheSize) {
+    size_t const triangleCount = indices.size() / 3;
+    if(triangleCount == 0) {
+        return 0.0f;
+    }
+
+    // a FIFO only moves on a miss, so a vertex is cached while fewer than cacheSize misses followed its own
+    std::vector<size_t> missedAt(vertexCount, 0);
+    size_t misses = 0;
+
+    for(size_t i = 0; i < triangleCount * 3; i++) {
+        unsigned int vertex = indices[i];
+        if(missedAt[vertex] == 0 || misses - missedAt[vertex] >= cacheSize) {
+            misses++;
+            missedAt[vertex] = misses;
+        }
+    }
+
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+//------------------------------------------------------------
+std::vector<unsigned int>
+optimizeVertexCache(std::vector<unsigned int> const & indices, size_t vertexCount, size_t cacheSize) {
+    size_t const triangleCount = indices.size() / 3;
+
+    std::vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+
+    if(triangleCount == 0) {
+        return result;
+    }
+
+    // triangles around each vertex, one flat array with an offset per vertex
+    std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+    for(size_t i = 0; i < triangleCount * 3; i++) {
+        adjacencyOffsets[indices[i] + 1]++;
+    }
+    for(size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for(size_t i = 0; i < triangleCount * 3; i++) {
+        adjacency[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+
+    // triangles not emitted yet around each vertex
+    std::vector<unsigned int> liveTriangles(vertexCount);
+    for(size_t v = 0; v < vertexCount; v++) {
+        liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+    }
+
+    // time stamps start past cacheSize so every vertex starts out of the cache
+    std::vector<size_t> cacheTime(vertexCount, 0);
+    size_t time = cacheSize + 1;
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<unsigned int> deadEnd;   // vertices of emitted triangles, most recent last
+    std::vector<unsigned int> candidates; // vertices of the current fan
+    deadEnd.reserve(triangleCount * 3);
+
+    size_t cursor = 0; // vertices before this have no triangles left
+    unsigned int fanning = indices[0];
+
+    while(fanning != NO_VERTEX) {
+        candidates.clear();
+
+        for(unsigned int a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; a++) {
+            unsigned int triangle = adjacency[a];
+            if(emitted[triangle]) {
+                continue;
+            }
+
+            for(int corner = 0; corner < 3; corner++) {
+                unsigned int vertex = indices[triangle * 3 + corner];
+                result.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+
+                if(time - cacheTime[vertex] > cacheSize) {
+                    cacheTime[vertex] = time++;
+                }
+            }
+
+            emitted[triangle] = 1;
+        }
+
+        // the candidate that stays in the cache the longest while its remaining triangles are emitted
+        fanning = NO_VERTEX;
+        int bestPriority = -1;
+
+        for(unsigned int vertex : candidates) {
+            if(liveTriangles[vertex] == 0) {
+                continue;
+            }
+
+            int priority = 0;
+            if(time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = static_cast<int>(time - cacheTime[vertex]);
+            }
+
+            if(priority > bestPriority) {
+                bestPriority = priority;
+                fanning = vertex;
+            }
+        }
+
+        // dead end, go back through recently used vertices and then on through the rest in order
+        while(fanning == NO_VERTEX && !deadEnd.empty()) {
+            unsigned int vertex = deadEnd.back();
+            deadEnd.pop_back();
+
+            if(liveTriangles[vertex] > 0) {
+                fanning = vertex;
+            }
+        }
+
+        while(fanning == NO_VERTEX && cursor < vertexCount) {
+            if(liveTriangles[cursor] > 0) {
+                fanning = static_cast<unsigned int>(cursor);
+            }
+            cursor++;
+        }
+    }
+
+    return result;
+}
+
+//------------------------------------------------------------
+void
+optimizeVertexFetch(std::vector<Vertex> & vertices, std::vector<unsigned int> & indices) {
+    std::vector<unsigned int> remap(vertices.size(), NO_VERTEX);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for(unsigned int & index : indices) {
+        if(remap[index] == NO_VERTEX) {
+            remap[index] = static_cast<unsigned int>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    for(size_t v = 0; v < vertices.size(); v++) {
+        if(remap[v] == NO_VERTEX) {
+            reordered.push_back(vertices[v]);
+        }
+    }
+
+    vertices.swap(reordered);
+}
+
+//------------------------------------------------------------
+VertexCacheStats
+optimizeMesh(std::vector<Vertex> & vertices, std::vector<unsigned int> & indices) {
+    VertexCacheStats stats;
+    stats.acmrBefore = computeAcmr(indices, vertices.size());
+
+    indices = optimizeVertexCache(indices, vertices.size());
+    optimizeVertexFetch(vertices, indices);
+
+    stats.acmrAfter = computeAcmr(indices, vertices.size());
+    return stats;
+}
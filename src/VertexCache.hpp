@@ -0,0 +1,54 @@
+#ifndef VertexCache_hpp
+#define VertexCache_hpp
+
+// std
+#include <vector>
+
+// my
+#include "Vertex.hpp"
+
+// my defines
+#define VERTEX_CACHE_SIZE 16 // entries of the FIFO post transform cache meshes are ordered for
+
+// average cache miss ratio, transformed vertices per triangle, of a mesh before and after optimizeMesh(...)
+struct VertexCacheStats {
+    float acmrBefore;
+    float acmrAfter;
+};
+
+/*
+    computeAcmr(...)
+
+    - simulates a FIFO post transform cache of cacheSize entries over the triangles of indices
+    - returns misses per triangle, 3 is no reuse at all, about 0.5 is the best a regular grid can do
+*/
+float computeAcmr(std::vector<unsigned int> const & indices, size_t vertexCount, size_t cacheSize = VERTEX_CACHE_SIZE);
+
+/*
+    optimizeVertexCache(...)
+
+    - reorders triangles so vertices are reused while still in the cache, tipsify by Sander et al.
+    - fans out around one vertex at a time, moving on to a vertex still in the cache that has
+      triangles left, or back to a recently used one when the fan ends in a dead end
+    - linear in the number of triangles, triangles keep their winding
+*/
+std::vector<unsigned int> optimizeVertexCache(std::vector<unsigned int> const & indices, size_t vertexCount, size_t cacheSize = VERTEX_CACHE_SIZE);
+
+/*
+    optimizeVertexFetch(...)
+
+    - reorders vertices into the order indices first use them, so fetches walk memory forwards
+    - vertices no index uses are kept, after all the used ones
+    - indices are rewritten to match, run after optimizeVertexCache(...)
+*/
+void optimizeVertexFetch(std::vector<Vertex> & vertices, std::vector<unsigned int> & indices);
+
+/*
+    optimizeMesh(...)
+
+    - optimizeVertexCache(...) then optimizeVertexFetch(...)
+    - call once when a mesh is loaded, before building anything that stores indices such as meshlets
+*/
+VertexCacheStats optimizeMesh(std::vector<Vertex> & vertices, std::vector<unsigned int> & indices);
+
+#endif /* VertexCache_hpp */
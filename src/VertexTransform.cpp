@@ -0,0 +1,336 @@
+// std
+#include <array>
+#include <cstring>
+
+// my
+#include "VertexTransform.hpp"
+
+// dependancies
+#if defined(__AVX__)
+    #define VERTEX_TRANSFORM_AVX
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #define VERTEX_TRANSFORM_SSE
+    #include <immintrin.h>
+#endif
+
+namespace {
+    //------------------------------------------------------------
+    size_t
+    paddedCount(size_t count) {
+        return (count + VERTEX_BATCH_WIDTH - 1) / VERTEX_BATCH_WIDTH * VERTEX_BATCH_WIDTH;
+    }
+
+    // row major coefficients, pulled out through the public api by transforming the basis vectors
+    struct MatrixRows {
+        std::array<float, 16> m;
+    };
+
+    //------------------------------------------------------------
+    MatrixRows
+    extractRows(djc_math::Mat4f const & matrix) {
+        MatrixRows rows;
+
+        for(int column = 0; column < 4; column++) {
+            djc_math::Vec4f basis(0.0f);
+            switch(column) {
+                case 0: basis.x = 1.0f; break;
+                case 1: basis.y = 1.0f; break;
+                case 2: basis.z = 1.0f; break;
+                case 3: basis.w = 1.0f; break;
+            }
+
+            djc_math::Vec4f c = matrix * basis;
+            rows.m[ 0 + column] = c.x;
+            rows.m[ 4 + column] = c.y;
+            rows.m[ 8 + column] = c.z;
+            rows.m[12 + column] = c.w;
+        }
+
+        return rows;
+    }
+
+#if !defined(VERTEX_TRANSFORM_AVX) && !defined(VERTEX_TRANSFORM_SSE)
+    //------------------------------------------------------------
+    void
+    transformScalar(MatrixRows const & r, PositionStream const & in, float halfWidth, float halfHeight, TransformedStream & out, size_t count) {
+        auto const & m = r.m;
+
+        for(size_t i = 0; i < count; i++) {
+            float x = in.x[i], y = in.y[i], z = in.z[i], w = in.w[i];
+
+            float cx = m[ 0] * x + m[ 1] * y + m[ 2] * z + m[ 3] * w;
+            float cy = m[ 4] * x + m[ 5] * y + m[ 6] * z + m[ 7] * w;
+            float cz = m[ 8] * x + m[ 9] * y + m[10] * z + m[11] * w;
+            float cw = m[12] * x + m[13] * y + m[14] * z + m[15] * w;
+
+            out.clipX[i] = cx;
+            out.clipY[i] = cy;
+            out.clipZ[i] = cz;
+            out.clipW[i] = cw;
+
+            float oneOverW = cw != 0.0f ? 1.0f / cw : 0.0f;
+            out.screenX[i] = (cx * oneOverW + 1.0f) * halfWidth;
+            out.screenY[i] = (cy * oneOverW + 1.0f) * halfHeight;
+            out.screenZ[i] = cz * oneOverW;
+
+            out.outcodes[i] = computeOutcode(cx, cy, cz, cw);
+        }
+    }
+#endif
+
+#if defined(VERTEX_TRANSFORM_AVX)
+    //------------------------------------------------------------
+    void
+    transformAVX(MatrixRows const & r, PositionStream const & in, float halfWidth, float halfHeight, TransformedStream & out, size_t count) {
+        // raw pointers, the byte stores to the outcodes would otherwise force every vector's data pointer to be reloaded
+        float const * inX = in.x.data();
+        float const * inY = in.y.data();
+        float const * inZ = in.z.data();
+        float const * inW = in.w.data();
+
+        float * clipX   = out.clipX.data();
+        float * clipY   = out.clipY.data();
+        float * clipZ   = out.clipZ.data();
+        float * clipW   = out.clipW.data();
+        float * screenX = out.screenX.data();
+        float * screenY = out.screenY.data();
+        float * screenZ = out.screenZ.data();
+        uint8_t * outcodes = out.outcodes.data();
+
+        __m256 m[16];
+        for(int i = 0; i < 16; i++) {
+            m[i] = _mm256_set1_ps(r.m[i]);
+        }
+
+        __m256 const one   = _mm256_set1_ps(1.0f);
+        __m256 const zero  = _mm256_setzero_ps();
+        __m256 const halfW = _mm256_set1_ps(halfWidth);
+        __m256 const halfH = _mm256_set1_ps(halfHeight);
+
+        // outcode bits as float bit patterns, so the compare masks can be and-ed / or-ed without AVX2
+        auto bit = [](int value) -> __m256 { return _mm256_castsi256_ps(_mm256_set1_epi32(value)); };
+        __m256 const bitLeft   = bit(OUTCODE_LEFT);
+        __m256 const bitRight  = bit(OUTCODE_RIGHT);
+        __m256 const bitBottom = bit(OUTCODE_BOTTOM);
+        __m256 const bitTop    = bit(OUTCODE_TOP);
+        __m256 const bitNear   = bit(OUTCODE_NEAR);
+        __m256 const bitFar    = bit(OUTCODE_FAR);
+
+        // count is padded to VERTEX_BATCH_WIDTH
+        for(size_t i = 0; i < count; i += 8) {
+            __m256 x = _mm256_loadu_ps(inX + i);
+            __m256 y = _mm256_loadu_ps(inY + i);
+            __m256 z = _mm256_loadu_ps(inZ + i);
+            __m256 w = _mm256_loadu_ps(inW + i);
+
+            // (a * x + b * y) + (c * z + d * w), two independent chains per output
+            __m256 cx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[ 0], x), _mm256_mul_ps(m[ 1], y)), _mm256_add_ps(_mm256_mul_ps(m[ 2], z), _mm256_mul_ps(m[ 3], w)));
+            __m256 cy = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[ 4], x), _mm256_mul_ps(m[ 5], y)), _mm256_add_ps(_mm256_mul_ps(m[ 6], z), _mm256_mul_ps(m[ 7], w)));
+            __m256 cz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[ 8], x), _mm256_mul_ps(m[ 9], y)), _mm256_add_ps(_mm256_mul_ps(m[10], z), _mm256_mul_ps(m[11], w)));
+            __m256 cw = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m[12], x), _mm256_mul_ps(m[13], y)), _mm256_add_ps(_mm256_mul_ps(m[14], z), _mm256_mul_ps(m[15], w)));
+
+            _mm256_storeu_ps(clipX + i, cx);
+            _mm256_storeu_ps(clipY + i, cy);
+            _mm256_storeu_ps(clipZ + i, cz);
+            _mm256_storeu_ps(clipW + i, cw);
+
+            // w == 0 divides to 0 rather than inf, the outcode rejects those vertices anyway
+            __m256 wIsZero  = _mm256_cmp_ps(cw, zero, _CMP_EQ_OQ);
+            __m256 oneOverW = _mm256_andnot_ps(wIsZero, _mm256_div_ps(one, cw));
+
+            _mm256_storeu_ps(screenX + i, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cx, oneOverW), one), halfW));
+            _mm256_storeu_ps(screenY + i, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cy, oneOverW), one), halfH));
+            _mm256_storeu_ps(screenZ + i, _mm256_mul_ps(cz, oneOverW));
+
+            __m256 negW = _mm256_sub_ps(zero, cw);
+            __m256 code = _mm256_and_ps(_mm256_cmp_ps(cx, negW, _CMP_LT_OQ), bitLeft);
+            code = _mm256_or_ps(code, _mm256_and_ps(_mm256_cmp_ps(cx, cw,   _CMP_GT_OQ), bitRight));
+            code = _mm256_or_ps(code, _mm256_and_ps(_mm256_cmp_ps(cy, negW, _CMP_LT_OQ), bitBottom));
+            code = _mm256_or_ps(code, _mm256_and_ps(_mm256_cmp_ps(cy, cw,   _CMP_GT_OQ), bitTop));
+            code = _mm256_or_ps(code, _mm256_and_ps(_mm256_or_ps(_mm256_cmp_ps(cz, negW, _CMP_LT_OQ), _mm256_cmp_ps(cw, zero, _CMP_LE_OQ)), bitNear));
+            code = _mm256_or_ps(code, _mm256_and_ps(_mm256_cmp_ps(cz, cw,   _CMP_GT_OQ), bitFar));
+
+            // 8 x int32 -> 8 x uint8
+            __m256i codes = _mm256_castps_si256(code);
+            __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(codes), _mm256_extractf128_si256(codes, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(outcodes + i), _mm_packus_epi16(packed, packed));
+        }
+    }
+#elif defined(VERTEX_TRANSFORM_SSE)
+    //------------------------------------------------------------
+    void
+    transformSSE(MatrixRows const & r, PositionStream const & in, float halfWidth, float halfHeight, TransformedStream & out, size_t count) {
+        // raw pointers, the byte stores to the outcodes would otherwise force every vector's data pointer to be reloaded
+        float const * inX = in.x.data();
+        float const * inY = in.y.data();
+        float const * inZ = in.z.data();
+        float const * inW = in.w.data();
+
+        float * clipX   = out.clipX.data();
+        float * clipY   = out.clipY.data();
+        float * clipZ   = out.clipZ.data();
+        float * clipW   = out.clipW.data();
+        float * screenX = out.screenX.data();
+        float * screenY = out.screenY.data();
+        float * screenZ = out.screenZ.data();
+        uint8_t * outcodes = out.outcodes.data();
+
+        __m128 m[16];
+        for(int i = 0; i < 16; i++) {
+            m[i] = _mm_set1_ps(r.m[i]);
+        }
+
+        __m128 const one   = _mm_set1_ps(1.0f);
+        __m128 const zero  = _mm_setzero_ps();
+        __m128 const halfW = _mm_set1_ps(halfWidth);
+        __m128 const halfH = _mm_set1_ps(halfHeight);
+
+        auto bit = [](int value) -> __m128 { return _mm_castsi128_ps(_mm_set1_epi32(value)); };
+        __m128 const bitLeft   = bit(OUTCODE_LEFT);
+        __m128 const bitRight  = bit(OUTCODE_RIGHT);
+        __m128 const bitBottom = bit(OUTCODE_BOTTOM);
+        __m128 const bitTop    = bit(OUTCODE_TOP);
+        __m128 const bitNear   = bit(OUTCODE_NEAR);
+        __m128 const bitFar    = bit(OUTCODE_FAR);
+
+        // count is padded to VERTEX_BATCH_WIDTH, a multiple of 4
+        for(size_t i = 0; i < count; i += 4) {
+            __m128 x = _mm_loadu_ps(inX + i);
+            __m128 y = _mm_loadu_ps(inY + i);
+            __m128 z = _mm_loadu_ps(inZ + i);
+            __m128 w = _mm_loadu_ps(inW + i);
+
+            __m128 cx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[ 0], x), _mm_mul_ps(m[ 1], y)), _mm_add_ps(_mm_mul_ps(m[ 2], z), _mm_mul_ps(m[ 3], w)));
+            __m128 cy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[ 4], x), _mm_mul_ps(m[ 5], y)), _mm_add_ps(_mm_mul_ps(m[ 6], z), _mm_mul_ps(m[ 7], w)));
+            __m128 cz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[ 8], x), _mm_mul_ps(m[ 9], y)), _mm_add_ps(_mm_mul_ps(m[10], z), _mm_mul_ps(m[11], w)));
+            __m128 cw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[12], x), _mm_mul_ps(m[13], y)), _mm_add_ps(_mm_mul_ps(m[14], z), _mm_mul_ps(m[15], w)));
+
+            _mm_storeu_ps(clipX + i, cx);
+            _mm_storeu_ps(clipY + i, cy);
+            _mm_storeu_ps(clipZ + i, cz);
+            _mm_storeu_ps(clipW + i, cw);
+
+            __m128 wIsZero  = _mm_cmpeq_ps(cw, zero);
+            __m128 oneOverW = _mm_andnot_ps(wIsZero, _mm_div_ps(one, cw));
+
+            _mm_storeu_ps(screenX + i, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(cx, oneOverW), one), halfW));
+            _mm_storeu_ps(screenY + i, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(cy, oneOverW), one), halfH));
+            _mm_storeu_ps(screenZ + i, _mm_mul_ps(cz, oneOverW));
+
+            __m128 negW = _mm_sub_ps(zero, cw);
+            __m128 code = _mm_and_ps(_mm_cmplt_ps(cx, negW), bitLeft);
+            code = _mm_or_ps(code, _mm_and_ps(_mm_cmpgt_ps(cx, cw),   bitRight));
+            code = _mm_or_ps(code, _mm_and_ps(_mm_cmplt_ps(cy, negW), bitBottom));
+            code = _mm_or_ps(code, _mm_and_ps(_mm_cmpgt_ps(cy, cw),   bitTop));
+            code = _mm_or_ps(code, _mm_and_ps(_mm_or_ps(_mm_cmplt_ps(cz, negW), _mm_cmple_ps(cw, zero)), bitNear));
+            code = _mm_or_ps(code, _mm_and_ps(_mm_cmpgt_ps(cz, cw),   bitFar));
+
+            // 4 x int32 -> 4 x uint8
+            __m128i codes  = _mm_castps_si128(code);
+            __m128i packed = _mm_packs_epi32(codes, codes);
+            int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+            std::memcpy(outcodes + i, &bytes, 4);
+        }
+    }
+#endif
+}
+
+//------------------------------------------------------------
+void
+PositionStream::resize(size_t count) {
+    size_t padded = paddedCount(count);
+    x.assign(padded, 0.0f);
+    y.assign(padded, 0.0f);
+    z.assign(padded, 0.0f);
+    w.assign(padded, 0.0f);
+    m_count = count;
+}
+
+//------------------------------------------------------------
+size_t
+PositionStream::size() const {
+    return m_count;
+}
+
+//------------------------------------------------------------
+void
+TransformedStream::resize(size_t count) {
+    // every element is written by the kernels, so only grow
+    size_t padded = paddedCount(count);
+    clipX.resize(padded);
+    clipY.resize(padded);
+    clipZ.resize(padded);
+    clipW.resize(padded);
+    screenX.resize(padded);
+    screenY.resize(padded);
+    screenZ.resize(padded);
+    outcodes.resize(padded);
+    m_count = count;
+}
+
+//------------------------------------------------------------
+size_t
+TransformedStream::size() const {
+    return m_count;
+}
+
+//------------------------------------------------------------
+void
+gatherPositions(std::vector<Vertex> const & vertices, PositionStream & positions) {
+    if(positions.size() != vertices.size()) {
+        positions.resize(vertices.size());
+    }
+
+    for(size_t i = 0; i < vertices.size(); i++) {
+        positions.x[i] = vertices[i].position.x;
+        positions.y[i] = vertices[i].position.y;
+        positions.z[i] = vertices[i].position.z;
+        positions.w[i] = vertices[i].position.w;
+    }
+}
+
+//------------------------------------------------------------
+void
+gatherPositions(std::vector<Vertex> const & vertices, unsigned int const * vertexIndices, size_t count, PositionStream & positions) {
+    if(positions.size() != count) {
+        positions.resize(count);
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        Vertex const & vertex = vertices[vertexIndices[i]];
+        positions.x[i] = vertex.position.x;
+        positions.y[i] = vertex.position.y;
+        positions.z[i] = vertex.position.z;
+        positions.w[i] = vertex.position.w;
+    }
+}
+
+//------------------------------------------------------------
+void
+transformPositions(djc_math::Mat4f const & matrix, PositionStream const & positions, float halfWidth, float halfHeight, TransformedStream & transformed) {
+    MatrixRows rows = extractRows(matrix);
+    size_t padded = paddedCount(positions.size());
+
+    transformed.resize(positions.size());
+
+#if defined(VERTEX_TRANSFORM_AVX)
+    transformAVX(rows, positions, halfWidth, halfHeight, transformed, padded);
+#elif defined(VERTEX_TRANSFORM_SSE)
+    transformSSE(rows, positions, halfWidth, halfHeight, transformed, padded);
+#else
+    transformScalar(rows, positions, halfWidth, halfHeight, transformed, padded);
+#endif
+}
+
+//------------------------------------------------------------
+char const *
+getVertexTransformPath() {
+#if defined(VERTEX_TRANSFORM_AVX)
+    return "AVX";
+#elif defined(VERTEX_TRANSFORM_SSE)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
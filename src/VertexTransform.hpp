@@ -0,0 +1,111 @@
+#ifndef VertexTransform_hpp
+#define VertexTransform_hpp
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// my
+#include "Vertex.hpp"
+#include "djc_math/Mat4.hpp"
+
+// vertices handled per step by the widest kernel, streams are padded to a multiple of this
+#define VERTEX_BATCH_WIDTH 8
+
+// one bit per clip plane a clip space position is outside of
+enum Outcode : uint8_t {
+    OUTCODE_LEFT   = 1 << 0, // x < -w
+    OUTCODE_RIGHT  = 1 << 1, // x >  w
+    OUTCODE_BOTTOM = 1 << 2, // y < -w
+    OUTCODE_TOP    = 1 << 3, // y >  w
+    OUTCODE_NEAR   = 1 << 4, // z < -w, or w <= 0
+    OUTCODE_FAR    = 1 << 5  // z >  w
+};
+
+// the outcode of one clip space position, the batch kernels give the same for every vertex
+inline uint8_t
+computeOutcode(float x, float y, float z, float w) {
+    uint8_t outcode = 0;
+    if(x < -w)              outcode |= OUTCODE_LEFT;
+    if(x >  w)              outcode |= OUTCODE_RIGHT;
+    if(y < -w)              outcode |= OUTCODE_BOTTOM;
+    if(y >  w)              outcode |= OUTCODE_TOP;
+    if(z < -w || w <= 0.0f) outcode |= OUTCODE_NEAR;
+    if(z >  w)              outcode |= OUTCODE_FAR;
+    return outcode;
+}
+
+/*
+    PositionStream
+
+    - vertex positions stored SoA, one array per component
+    - padding past size() is zeroed so kernels can always run whole batches
+*/
+struct PositionStream {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> w;
+
+    void resize(size_t count);
+    size_t size() const;
+
+private:
+    size_t m_count = 0;
+};
+
+/*
+    TransformedStream
+
+    - output of transformPositions(...), SoA like PositionStream
+    - clip space is kept for clipping, screen space is only valid where the outcode is 0
+    - screenW is clip space w, the rasterizer uses it for perspective correction
+*/
+struct TransformedStream {
+    std::vector<float> clipX;
+    std::vector<float> clipY;
+    std::vector<float> clipZ;
+    std::vector<float> clipW;
+
+    std::vector<float> screenX;
+    std::vector<float> screenY;
+    std::vector<float> screenZ;
+
+    std::vector<uint8_t> outcodes;
+
+    void resize(size_t count);
+    size_t size() const;
+
+private:
+    size_t m_count = 0;
+};
+
+/*
+    gatherPositions(...)
+
+    - copies the positions out of an AoS vertex array into a PositionStream
+*/
+void gatherPositions(std::vector<Vertex> const & vertices, PositionStream & positions);
+
+/*
+    gatherPositions(...)
+
+    - copies the positions of count vertices picked by vertexIndices, in that order
+    - stream element i is vertices[vertexIndices[i]], used to transform one meshlet at a time
+*/
+void gatherPositions(std::vector<Vertex> const & vertices, unsigned int const * vertexIndices, size_t count, PositionStream & positions);
+
+/*
+    transformPositions(...)
+
+    - clip = matrix * position, then the perspective divide and viewport mapping
+    - screen x / y = (ndc + 1) * half size, the same mapping the rasterizer uses
+    - 8 vertices per step with AVX, 4 with SSE, scalar everywhere else
+*/
+void transformPositions(djc_math::Mat4f const & matrix, PositionStream const & positions, float halfWidth, float halfHeight, TransformedStream & transformed);
+
+// the instruction set transformPositions(...) was compiled for: "AVX", "SSE" or "scalar"
+char const * getVertexTransformPath();
+
+#endif /* VertexTransform_hpp */
@@ -0,0 +1,352 @@
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+// my
+#include "VertexWeld.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+    const uint32_t EMPTY_SLOT      = UINT32_MAX;
+    const size_t   MIN_TABLE_SIZE  = 16;
+    const size_t   JOBS_PER_THREAD = 4;               // partitions and ranges per worker, evens out uneven ones
+    const double   MAX_CELL        = 1099511627776.0; // 2^40, cells further out are clamped and share a cell
+
+    // a power of two at least twice count, tables are kept under half full so probe runs stay short
+    size_t tableSizeFor(size_t count) {
+        size_t size = MIN_TABLE_SIZE;
+        while(size < count * 2) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    uint32_t mixBits(uint64_t hash) {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        return static_cast<uint32_t>(hash);
+    }
+
+    uint32_t hashOf(Vertex const & vertex) {
+        float values[8] = { vertex.position.x, vertex.position.y, vertex.position.z,
+                            vertex.texCoord.x, vertex.texCoord.y,
+                            vertex.colour.x, vertex.colour.y, vertex.colour.z };
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for(float value : values) {
+            // adding 0 turns -0 into 0, they compare equal so they have to hash the same
+            value += 0.0f;
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            hash = (hash ^ bits) * 0x100000001b3ull;
+        }
+        return mixBits(hash);
+    }
+
+    bool equal(Vertex const & lhs, Vertex const & rhs) {
+        return lhs.position.x == rhs.position.x && lhs.position.y == rhs.position.y && lhs.position.z == rhs.position.z
+            && lhs.texCoord.x == rhs.texCoord.x && lhs.texCoord.y == rhs.texCoord.y
+            && lhs.colour.x == rhs.colour.x && lhs.colour.y == rhs.colour.y && lhs.colour.z == rhs.colour.z;
+    }
+
+    bool within(Vertex const & lhs, Vertex const & rhs, float epsilon) {
+        return std::fabs(lhs.position.x - rhs.position.x) <= epsilon
+            && std::fabs(lhs.position.y - rhs.position.y) <= epsilon
+            && std::fabs(lhs.position.z - rhs.position.z) <= epsilon
+            && std::fabs(lhs.texCoord.x - rhs.texCoord.x) <= epsilon
+            && std::fabs(lhs.texCoord.y - rhs.texCoord.y) <= epsilon
+            && std::fabs(lhs.colour.x - rhs.colour.x) <= epsilon
+            && std::fabs(lhs.colour.y - rhs.colour.y) <= epsilon
+            && std::fabs(lhs.colour.z - rhs.colour.z) <= epsilon;
+    }
+
+    // job(0) to job(count - 1), spread over the pool when there is one
+    template <typename Job>
+    void forEachJob(ThreadPool * pool, size_t count, Job const & job) {
+        if(!pool) {
+            for(size_t i = 0; i < count; i++) {
+                job(i);
+            }
+            return;
+        }
+
+        for(size_t i = 0; i < count; i++) {
+            pool->submit([&job, i] { job(i); });
+        }
+        pool->wait();
+    }
+
+    /*
+        weldExact(...)
+
+        - every vertex is hashed, and the hash picks one of partitionCount partitions
+        - vertices are sorted into their partitions keeping soup order, then each partition is
+          welded on its own, equal vertices always share a partition so none has to look at another
+        - the first vertex of a group is found as in a serial weld, whatever the partition count
+    */
+    std::vector<unsigned int> weldExact(std::vector<Vertex> const & soup, std::vector<Vertex> & vertices, ThreadPool * pool, size_t jobCount) {
+        size_t const count = soup.size();
+        size_t const partitionCount = jobCount;
+        size_t const rangeCount = jobCount;
+        size_t const rangeSize = (count + rangeCount - 1) / rangeCount;
+
+        auto rangeBegin = [&](size_t range) { return std::min(count, range * rangeSize); };
+        auto partitionOf = [&](uint32_t hash) { return static_cast<size_t>((static_cast<uint64_t>(hash) * partitionCount) >> 32); };
+
+        std::vector<uint32_t> hashes(count);
+        std::vector<uint32_t> offsets(rangeCount * partitionCount, 0); // per range, where its vertices of each partition go
+
+        forEachJob(pool, rangeCount, [&](size_t range) {
+            uint32_t * rangeCounts = offsets.data() + range * partitionCount;
+            for(size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                hashes[i] = hashOf(soup[i]);
+                rangeCounts[partitionOf(hashes[i])]++;
+            }
+        });
+
+        // partitions one after another, within each the ranges in soup order
+        std::vector<uint32_t> partitionBegins(partitionCount + 1, 0);
+        uint32_t running = 0;
+        for(size_t partition = 0; partition < partitionCount; partition++) {
+            partitionBegins[partition] = running;
+            for(size_t range = 0; range < rangeCount; range++) {
+                uint32_t size = offsets[range * partitionCount + partition];
+                offsets[range * partitionCount + partition] = running;
+                running += size;
+            }
+        }
+        partitionBegins[partitionCount] = running;
+
+        std::vector<uint32_t> order(count);
+        forEachJob(pool, rangeCount, [&](size_t range) {
+            uint32_t * fill = offsets.data() + range * partitionCount;
+            for(size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                order[fill[partitionOf(hashes[i])]++] = static_cast<uint32_t>(i);
+            }
+        });
+
+        // soup index of the first vertex equal to each one
+        std::vector<uint32_t> firsts(count);
+        forEachJob(pool, partitionCount, [&](size_t partition) {
+            uint32_t const * members = order.data() + partitionBegins[partition];
+            size_t const memberCount = partitionBegins[partition + 1] - partitionBegins[partition];
+
+            std::vector<uint32_t> slots(tableSizeFor(memberCount), EMPTY_SLOT);
+            size_t const mask = slots.size() - 1;
+
+            for(size_t m = 0; m < memberCount; m++) {
+                uint32_t const i = members[m];
+                uint32_t const hash = hashes[i];
+
+                for(size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+                    uint32_t first = slots[slot];
+
+                    if(first == EMPTY_SLOT) {
+                        slots[slot] = i;
+                        firsts[i] = i;
+                        break;
+                    }
+
+                    if(hashes[first] == hash && equal(soup[first], soup[i])) {
+                        firsts[i] = first;
+                        break;
+                    }
+                }
+            }
+        });
+
+        hashes  = std::vector<uint32_t>();
+        order   = std::vector<uint32_t>();
+        offsets = std::vector<uint32_t>();
+
+        // kept vertices are numbered in soup order, each range counts its own and then writes them
+        std::vector<uint32_t> keptBegins(rangeCount + 1, 0);
+        forEachJob(pool, rangeCount, [&](size_t range) {
+            uint32_t kept = 0;
+            for(size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                kept += firsts[i] == i;
+            }
+            keptBegins[range + 1] = kept;
+        });
+
+        for(size_t range = 0; range < rangeCount; range++) {
+            keptBegins[range + 1] += keptBegins[range];
+        }
+
+        std::vector<unsigned int> indices(count);
+        vertices.resize(keptBegins[rangeCount]);
+
+        forEachJob(pool, rangeCount, [&](size_t range) {
+            uint32_t next = keptBegins[range];
+            for(size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                if(firsts[i] == i) {
+                    indices[i] = next;
+                    vertices[next++] = soup[i];
+                }
+            }
+        });
+
+        // a group's first vertex can be in an earlier range, so this waits for every range to be numbered
+        forEachJob(pool, rangeCount, [&](size_t range) {
+            for(size_t i = rangeBegin(range); i < rangeBegin(range + 1); i++) {
+                if(firsts[i] != i) {
+                    indices[i] = indices[firsts[i]];
+                }
+            }
+        });
+
+        return indices;
+    }
+
+    struct Cell {
+        int64_t x;
+        int64_t y;
+        int64_t z;
+
+        bool operator == (Cell const & rhs) const {
+            return x == rhs.x && y == rhs.y && z == rhs.z;
+        }
+    };
+
+    uint32_t hashOf(Cell const & cell) {
+        uint64_t hash = static_cast<uint64_t>(cell.x) * 0x9e3779b97f4a7c15ull;
+        hash ^= static_cast<uint64_t>(cell.y) * 0xc2b2ae3d27d4eb4full;
+        hash ^= static_cast<uint64_t>(cell.z) * 0x165667b19e3779f9ull;
+        return mixBits(hash);
+    }
+
+    /*
+        weldEpsilon(...)
+
+        - a kept vertex goes into the grid cell its position falls in, cells are 2 * epsilon wide
+        - a match is at most epsilon away on each axis, so it is in the vertex's cell or the
+          neighbour on whichever side the vertex is nearer, 8 cells in all
+        - every kept vertex in a cell is chained from the cell's slot, newest first
+    */
+    std::vector<unsigned int> weldEpsilon(std::vector<Vertex> const & soup, std::vector<Vertex> & vertices, float epsilon) {
+        double const cellSize = 2.0 * static_cast<double>(epsilon);
+
+        std::vector<unsigned int> indices(soup.size());
+        std::vector<uint32_t> slots(tableSizeFor(soup.size()), EMPTY_SLOT); // newest kept vertex of each cell
+        std::vector<Cell> cells; // cell of each kept vertex
+        std::vector<uint32_t> next; // previous kept vertex in the same cell
+        size_t const mask = slots.size() - 1;
+
+        auto findSlot = [&](Cell const & cell) {
+            size_t slot = hashOf(cell) & mask;
+            while(slots[slot] != EMPTY_SLOT && !(cells[slots[slot]] == cell)) {
+                slot = (slot + 1) & mask;
+            }
+            return slot;
+        };
+
+        for(size_t i = 0; i < soup.size(); i++) {
+            Vertex const & vertex = soup[i];
+            float const position[3] = { vertex.position.x, vertex.position.y, vertex.position.z };
+
+            // NaNs and infinities are never within epsilon of anything, they are kept without a cell
+            if(!std::isfinite(position[0]) || !std::isfinite(position[1]) || !std::isfinite(position[2])) {
+                indices[i] = static_cast<unsigned int>(vertices.size());
+                vertices.push_back(vertex);
+                cells.push_back(Cell{ 0, 0, 0 });
+                next.push_back(EMPTY_SLOT);
+                continue;
+            }
+
+            int64_t home[3];
+            int64_t side[3];
+            for(int axis = 0; axis < 3; axis++) {
+                double scaled = std::max(-MAX_CELL, std::min(MAX_CELL, position[axis] / cellSize));
+                double floored = std::floor(scaled);
+                home[axis] = static_cast<int64_t>(floored);
+                side[axis] = scaled - floored < 0.5 ? -1 : 1;
+            }
+
+            uint32_t match = EMPTY_SLOT;
+            for(int neighbour = 0; neighbour < 8; neighbour++) {
+                Cell cell = { home[0] + ((neighbour & 1) ? side[0] : 0),
+                              home[1] + ((neighbour & 2) ? side[1] : 0),
+                              home[2] + ((neighbour & 4) ? side[2] : 0) };
+
+                // the earliest kept vertex wins, whichever cell it is in
+                for(uint32_t kept = slots[findSlot(cell)]; kept != EMPTY_SLOT; kept = next[kept]) {
+                    if(kept < match && within(vertices[kept], vertex, epsilon)) {
+                        match = kept;
+                    }
+                }
+            }
+
+            if(match != EMPTY_SLOT) {
+                indices[i] = match;
+                continue;
+            }
+
+            Cell cell = { home[0], home[1], home[2] };
+            uint32_t const kept = static_cast<uint32_t>(vertices.size());
+            size_t const slot = findSlot(cell);
+
+            vertices.push_back(vertex);
+            cells.push_back(cell);
+            next.push_back(slots[slot]);
+            slots[slot] = kept;
+            indices[i] = kept;
+        }
+
+        return indices;
+    }
+}
+
+//------------------------------------------------------------
+std::vector<unsigned int>
+weldVertices(std::vector<Vertex> const & soup, std::vector<Vertex> & vertices, float epsilon, size_t threadCount) {
+    vertices.clear();
+
+    // EMPTY_SLOT has to stay free
+    if(soup.size() >= EMPTY_SLOT) {
+        std::cerr << "cannot weld " << soup.size() << " vertices, indices are 32 bit" << std::endl;
+        return std::vector<unsigned int>();
+    }
+
+    if(epsilon > 0.0f) {
+        return weldEpsilon(soup, vertices, epsilon);
+    }
+
+    std::unique_ptr<ThreadPool> pool;
+    if(threadCount != 1 && soup.size() >= WELD_PARALLEL_MIN_VERTICES) {
+        pool.reset(new ThreadPool(threadCount));
+    }
+
+    size_t const jobCount = pool ? pool->getThreadCount() * JOBS_PER_THREAD : 1;
+    return weldExact(soup, vertices, pool.get(), jobCount);
+}
+
+//------------------------------------------------------------
+Mesh
+weldMesh(std::vector<Vertex> const & soup, float epsilon, size_t threadCount) {
+    Mesh mesh;
+
+    std::vector<unsigned int> welded = weldVertices(soup, mesh.vertices, epsilon, threadCount);
+    if(welded.size() != soup.size()) {
+        return mesh;
+    }
+
+    mesh.indices.reserve(welded.size());
+    for(size_t i = 0; i + 3 <= welded.size(); i += 3) {
+        unsigned int a = welded[i];
+        unsigned int b = welded[i + 1];
+        unsigned int c = welded[i + 2];
+
+        if(a != b && b != c && c != a) {
+            mesh.indices.insert(mesh.indices.end(), { a, b, c });
+        }
+    }
+
+    optimizeMesh(mesh.vertices, mesh.indices);
+    mesh.bounds = computeBounds(mesh.vertices);
+    mesh.meshlets = buildMeshlets(mesh.vertices, mesh.indices);
+    return mesh;
+}
@@ -0,0 +1,44 @@
+#ifndef VertexWeld_hpp
+#define VertexWeld_hpp
+
+// std
+#include <vector>
+
+// my
+#include "Mesh.hpp"
+#include "Vertex.hpp"
+
+// my defines
+#define WELD_PARALLEL_MIN_VERTICES 65536 // smaller soups are welded on the calling thread, threads cost more than they save
+
+/*
+    weldVertices(...)
+
+    - turns a triangle soup, 3 vertices per triangle, into vertices and one index per soup vertex
+    - with epsilon 0 vertices are welded when position, texture coordinate and colour are exactly
+      equal, -0 and 0 count as equal, NaNs are never welded
+    - with epsilon above 0 a vertex is welded onto the earliest kept vertex whose every component
+      is within epsilon of its own, so texture and colour seams stay split. each vertex is compared
+      against kept ones only, a run of vertices each epsilon apart does not collapse into one
+    - kept vertices stay in soup order, each is the first vertex of its group
+    - exact welding hashes into an open addressing table per partition of the hash, partitions are
+      welded on threadCount workers (0 is one per hardware thread) once the soup has
+      WELD_PARALLEL_MIN_VERTICES. the result is the same for every thread count
+    - epsilon welding looks vertices up in a hashed grid of 2 * epsilon cells, only the 8 cells
+      around a vertex can hold a match. keep epsilon well under the triangle size, every kept vertex
+      in those cells is compared. lookups depend on what was kept before, they run in soup order on
+      the calling thread
+    - returns an empty vector if the soup has more vertices than an unsigned int can index
+*/
+std::vector<unsigned int> weldVertices(std::vector<Vertex> const & soup, std::vector<Vertex> & vertices, float epsilon = 0.0f, size_t threadCount = 0);
+
+/*
+    weldMesh(...)
+
+    - weldVertices(...) then drops triangles that welding left with a repeated corner
+    - the mesh comes out as a loader gives it: cache ordered, with bounds and meshlets, ready for
+      RenderContext::drawIndexedMesh(Mesh const &, ...)
+*/
+Mesh weldMesh(std::vector<Vertex> const & soup, float epsilon = 0.0f, size_t threadCount = 0);
+
+#endif /* VertexWeld_hpp */
@@ -1,12 +1,14 @@
 // std
+#include <future>
 #include <iostream>
+#include <utility>
 
 // my
 #include "Window.hpp"
 #include "SDL2/SDL.h"
 
 //------------------------------------------------------------
-Window::Window(std::string const & title, int x, int y, int width, int height, bool vSync, bool fullscreen) :
+Window::Window(std::string const & title, int x, int y, int width, int height, bool vSync, bool fullscreen, PresentMode presentMode, int maxFramesInFlight) :
     m_title(title)
 ,   m_width(width)
 ,   m_height(height) 
@@ -14,6 +16,9 @@ Window::Window(std::string const & title, int x, int y, int width, int height, b
 ,   m_window(nullptr)
 ,   m_renderer(nullptr)
 ,   m_renderTexture(nullptr)
+,   m_presentMode(presentMode)
+,   m_locked(false)
+,   m_frameStart(std::chrono::high_resolution_clock::now())
 {
     // if x or y == -1 set the respected axis to centre
     if(x == -1) {
@@ -46,7 +51,201 @@ Window::Window(std::string const & title, int x, int y, int width, int height, b
     }
     //..
 
-    // create renderer
+#if defined(__APPLE__)
+    // SDL on macOS only renders and presents from the main thread
+    if(m_presentMode == PresentMode::Threaded) {
+        std::cerr << "PresentMode::Threaded is not supported on macOS, falling back to PresentMode::Copy" << std::endl;
+        m_presentMode = PresentMode::Copy;
+    }
+#endif
+
+    if(m_presentMode == PresentMode::Threaded) {
+        // the renderer belongs to the thread that creates it, so the present thread creates it
+        m_swapChain.reset(new SwapChain(width, height, maxFramesInFlight));
+
+        std::promise<bool> rendererCreated;
+        std::future<bool> rendererResult = rendererCreated.get_future();
+        m_presentThread = std::thread(&Window::presentLoop, this, vSync, std::move(rendererCreated));
+
+        if(!rendererResult.get()) {
+            m_presentThread.join();
+            SDL_DestroyWindow(m_window);
+            SDL_Quit();
+            exit(-1);
+        }
+
+        acquireBackBuffer();
+        return;
+    }
+
+    if(!createRenderer(vSync)) {
+        SDL_DestroyWindow(m_window);
+        SDL_Quit();
+        exit(-1);
+    }
+
+    // the first frame renders into the texture straight away
+    if(m_presentMode == PresentMode::ZeroCopy && !lockBackBuffer()) {
+        std::cerr << "falling back to PresentMode::Copy" << std::endl;
+        m_presentMode = PresentMode::Copy;
+    }
+}
+
+//------------------------------------------------------------
+Window::~Window() {
+    if(m_presentMode == PresentMode::Threaded) {
+        // the present thread destroys the renderer it created
+        m_rContext.releaseExternalMemory();
+        m_swapChain->close();
+        m_presentThread.join();
+    } else {
+        unlockBackBuffer();
+        SDL_DestroyTexture(m_renderTexture);
+        SDL_DestroyRenderer(m_renderer);
+    }
+    SDL_DestroyWindow(m_window);    
+    SDL_Quit();
+    std::cout << "Window dtor" << std::endl;    
+}
+
+//------------------------------------------------------------
+RenderContext &
+Window::getRenderContext() {
+    return m_rContext;
+}
+
+//------------------------------------------------------------
+void 
+Window::clear() { 
+    m_rContext.clear();
+}
+
+//------------------------------------------------------------
+void 
+Window::swapBackBuffer() { 
+    using clock = std::chrono::high_resolution_clock;
+
+    float renderMs = std::chrono::duration<float, std::milli>(clock::now() - m_frameStart).count();
+
+    // the texture is window sized, the frame only covers the top left when rendering at a lower resolution
+    SDL_Rect renderRect = { 0, 0, m_rContext.getWidth(), m_rContext.getHeight() };
+
+    if(m_presentMode == PresentMode::Threaded) {
+        // hand the frame to the present thread and start the next one straight away
+        m_rContext.releaseExternalMemory();
+        m_swapChain->submit(renderRect.w, renderRect.h);
+        updateDynamicResolution(renderMs);
+        acquireBackBuffer();
+        m_frameStart = clock::now();
+        return;
+    }
+
+    uint64_t bytesUploaded = 0;
+    uint64_t rectsUploaded = 0;
+
+    if(m_presentMode == PresentMode::ZeroCopy) {
+        unlockBackBuffer();
+    } else if(m_rContext.isDirtyTracking()) {
+        uploadDirtyRects(bytesUploaded, rectsUploaded);
+    } else {
+        SDL_UpdateTexture(m_renderTexture, &renderRect, m_rContext.getPixels(), m_rContext.getPitch());
+        bytesUploaded = static_cast<uint64_t>(renderRect.w) * renderRect.h * 4;
+        rectsUploaded = 1;
+    }
+    countPresent(bytesUploaded, rectsUploaded);
+
+    SDL_RenderCopy(m_renderer, m_renderTexture, &renderRect, NULL);
+    SDL_RenderPresent(m_renderer);
+
+    // resize while the context is not bound to the texture
+    updateDynamicResolution(renderMs);
+
+    if(m_presentMode == PresentMode::ZeroCopy && !lockBackBuffer()) {
+        std::cerr << "falling back to PresentMode::Copy" << std::endl;
+        m_presentMode = PresentMode::Copy;
+    }
+
+    m_frameStart = clock::now();
+}
+
+//------------------------------------------------------------
+Window::PresentMode
+Window::getPresentMode() const {
+    return m_presentMode;
+}
+
+//------------------------------------------------------------
+void
+Window::setDirtyRectUpload(bool enable) {
+    if(enable && m_presentMode != PresentMode::Copy) {
+        std::cerr << "dirty rect upload needs PresentMode::Copy" << std::endl;
+        return;
+    }
+
+    m_rContext.enableDirtyTracking(enable);
+}
+
+//------------------------------------------------------------
+Window::PresentStats
+Window::getPresentStats() const {
+    std::lock_guard<std::mutex> lock(m_presentStatsMutex);
+    return m_presentStats;
+}
+
+//------------------------------------------------------------
+SwapChain *
+Window::getSwapChain() {
+    return m_swapChain.get();
+}
+
+//------------------------------------------------------------
+void
+Window::setRenderResolution(int width, int height) {
+    width  = djc_math::clamp(width,  1, m_width);
+    height = djc_math::clamp(height, 1, m_height);
+
+    if(width == m_rContext.getWidth() && height == m_rContext.getHeight()) {
+        return;
+    }
+
+    // the locked texture / swap chain buffer is window sized, so it still fits after resizing
+    unsigned char * externalPixels = m_rContext.hasExternalMemory() ? m_rContext.getPixels() : nullptr;
+    int pitch = m_rContext.getPitch();
+
+    m_rContext.updateContextSize(width, height);
+
+    if(externalPixels != nullptr) {
+        m_rContext.bindExternalMemory(externalPixels, pitch);
+        m_rContext.clear();
+    }
+}
+
+//------------------------------------------------------------
+void
+Window::enableDynamicResolution(float targetFrameMs, float minScale) {
+    m_dynamicResolution.reset(new DynamicResolution(m_width, m_height, targetFrameMs));
+    m_dynamicResolution->setScaleRange(minScale, 1.0f);
+    m_frameStart = std::chrono::high_resolution_clock::now();
+}
+
+//------------------------------------------------------------
+void
+Window::disableDynamicResolution() {
+    m_dynamicResolution.reset();
+    setRenderResolution(m_width, m_height);
+}
+
+//------------------------------------------------------------
+DynamicResolution const *
+Window::getDynamicResolution() const {
+    return m_dynamicResolution.get();
+}
+
+/* PRIVATE */
+
+//------------------------------------------------------------
+bool
+Window::createRenderer(bool vSync) {
     int rendererFlags = SDL_RENDERER_ACCELERATED;
 
     // todo : somehow let v-sync be a runtime option 
@@ -57,22 +256,22 @@ Window::Window(std::string const & title, int x, int y, int width, int height, b
     m_renderer = SDL_CreateRenderer(m_window, -1, rendererFlags);
 
     if (m_renderer == nullptr) {
-        SDL_DestroyWindow(m_window);
         std::cerr << "SDL_CreateRenderer Error: " << SDL_GetError() << std::endl;
-        SDL_Quit();
-        exit(-1);
+        return false;
     }
     //..
 
+    // linear filtering when a lower render resolution is stretched over the window
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+
     // create render buffer
     m_renderTexture = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, m_width, m_height);
 
     if(m_renderTexture == nullptr) {
         SDL_DestroyRenderer(m_renderer);
-        SDL_DestroyWindow(m_window);
+        m_renderer = nullptr;
         std::cerr << "Render Buffer Could not be created" << std::endl;
-        SDL_Quit();
-        exit(-1);
+        return false;
     }
     //..
 
@@ -82,33 +281,107 @@ Window::Window(std::string const & title, int x, int y, int width, int height, b
     SDL_RenderPresent(m_renderer);
     SDL_GL_SetSwapInterval(static_cast<int>(vSync));
     //..
+
+    return true;
 }
 
 //------------------------------------------------------------
-Window::~Window() {
+void
+Window::presentLoop(bool vSync, std::promise<bool> rendererCreated) {
+    bool created = createRenderer(vSync);
+    rendererCreated.set_value(created);
+
+    if(!created) {
+        return;
+    }
+
+    // present frame N while the render thread fills N + 1, vsync only blocks this thread
+    while(unsigned char const * pixels = m_swapChain->acquireFrontBuffer()) {
+        SDL_Rect renderRect = { 0, 0, 0, 0 };
+        m_swapChain->getFrontBufferSize(renderRect.w, renderRect.h);
+
+        SDL_UpdateTexture(m_renderTexture, &renderRect, pixels, m_swapChain->getPitch());
+        m_swapChain->releaseFrontBuffer();
+        countPresent(static_cast<uint64_t>(renderRect.w) * renderRect.h * 4, 1);
+
+        SDL_RenderCopy(m_renderer, m_renderTexture, &renderRect, NULL);
+        SDL_RenderPresent(m_renderer);
+    }
+
     SDL_DestroyTexture(m_renderTexture);
     SDL_DestroyRenderer(m_renderer);
-    SDL_DestroyWindow(m_window);    
-    SDL_Quit();
-    std::cout << "Window dtor" << std::endl;    
 }
 
 //------------------------------------------------------------
-RenderContext &
-Window::getRenderContext() {
-    return m_rContext;
+void
+Window::updateDynamicResolution(float renderMs) {
+    if(m_dynamicResolution && m_dynamicResolution->update(renderMs)) {
+        setRenderResolution(m_dynamicResolution->getWidth(), m_dynamicResolution->getHeight());
+    }
 }
 
 //------------------------------------------------------------
-void 
-Window::clear() { 
-    m_rContext.clear();
+void
+Window::uploadDirtyRects(uint64_t & bytesUploaded, uint64_t & rectsUploaded) {
+    DirtyRegion & dirtyRegion = m_rContext.getDirtyRegion();
+    dirtyRegion.buildUploadRects(m_dirtyRects);
+
+    unsigned char const * pixels = m_rContext.getPixels();
+    int pitch = m_rContext.getPitch();
+
+    for(auto const & rect : m_dirtyRects) {
+        SDL_Rect sdlRect = { rect.x, rect.y, rect.width, rect.height };
+        SDL_UpdateTexture(m_renderTexture, &sdlRect, pixels + rect.y * pitch + rect.x * 4, pitch);
+        bytesUploaded += static_cast<uint64_t>(rect.width) * rect.height * 4;
+    }
+
+    rectsUploaded += m_dirtyRects.size();
+    dirtyRegion.resetUpload();
 }
 
 //------------------------------------------------------------
-void 
-Window::swapBackBuffer() { 
-    SDL_UpdateTexture(m_renderTexture, NULL, &m_rContext[0], m_width * 4);
-    SDL_RenderCopy(m_renderer, m_renderTexture, NULL, NULL);
-    SDL_RenderPresent(m_renderer);
+void
+Window::countPresent(uint64_t bytesUploaded, uint64_t rectsUploaded) {
+    std::lock_guard<std::mutex> lock(m_presentStatsMutex);
+    m_presentStats.frames++;
+    m_presentStats.bytesUploaded += bytesUploaded;
+    m_presentStats.rectsUploaded += rectsUploaded;
+}
+
+//------------------------------------------------------------
+void
+Window::acquireBackBuffer() {
+    unsigned char * pixels = m_swapChain->acquireBackBuffer();
+
+    if(pixels != nullptr) {
+        m_rContext.bindExternalMemory(pixels, m_swapChain->getPitch());
+    }
+}
+
+//------------------------------------------------------------
+bool
+Window::lockBackBuffer() {
+    void * pixels = nullptr;
+    int pitch = 0;
+
+    if(SDL_LockTexture(m_renderTexture, NULL, &pixels, &pitch) != 0) {
+        std::cerr << "SDL_LockTexture Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    m_rContext.bindExternalMemory(static_cast<unsigned char *>(pixels), pitch);
+    m_locked = true;
+    return true;
+}
+
+//------------------------------------------------------------
+void
+Window::unlockBackBuffer() {
+    if(!m_locked) {
+        return;
+    }
+
+    m_rContext.releaseExternalMemory();
+    SDL_UnlockTexture(m_renderTexture);
+    m_locked = false;
 }
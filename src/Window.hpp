@@ -2,27 +2,148 @@
 #define Window_hpp
 
 // std
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 // my
+#include "DynamicResolution.hpp"
 #include "RenderContext.hpp"
+#include "SwapChain.hpp"
 
 struct SDL_Window;
 struct SDL_Renderer;
 struct SDL_Texture;
 
 class Window final {
+public:
+    enum class PresentMode {
+        Copy,    // render into the context's own buffer, copied to the texture with SDL_UpdateTexture
+        ZeroCopy, // render straight into the locked streaming texture, no full frame copy
+        Threaded  // a present thread uploads and presents frame N while frame N + 1 is rendered,
+                  // not on macOS where SDL only renders from the main thread, Copy is used there
+    };
+
 public:
     // set x && y to -1 if you want window centred
-    Window(std::string const & title, int x, int y, int width, int height, bool vSync, bool fullscreen);
+    // maxFramesInFlight is only used by PresentMode::Threaded, it bounds the latency in frames
+    Window(std::string const & title, int x, int y, int width, int height, bool vSync, bool fullscreen, PresentMode presentMode = PresentMode::Copy, int maxFramesInFlight = 2);
     ~Window();
 
     RenderContext & getRenderContext();
 
+    /*
+        clear()
+
+        - with PresentMode::ZeroCopy the texture memory is undefined after every present
+        - so clear() (or drawing over every pixel) is required each frame
+    */
     void clear();
     void swapBackBuffer();
 
+    PresentMode getPresentMode() const;
+
+    /*
+        setDirtyRectUpload(...)
+
+        - PresentMode::Copy only, uploads just the tiles that changed since the last present
+        - worth it when most of the frame is static between presents
+    */
+    void setDirtyRectUpload(bool enable);
+
+    struct PresentStats {
+        uint64_t frames        = 0;
+        uint64_t bytesUploaded = 0;
+        uint64_t rectsUploaded = 0;
+    };
+
+    // counted on the present thread with PresentMode::Threaded, safe to read from any thread
+    PresentStats getPresentStats() const;
+
+    // nullptr unless PresentMode::Threaded, check getPresentMode() as macOS falls back to Copy
+    SwapChain * getSwapChain();
+
+    /*
+        setRenderResolution(...)
+
+        - the render context is resized, the window size does not change
+        - the frame is stretched over the whole window at present
+        - clamped to the window size, the context is cleared
+    */
+    void setRenderResolution(int width, int height);
+
+    /*
+        enableDynamicResolution(...)
+
+        - the render resolution follows the time spent rendering each frame
+        - time blocked in swapBackBuffer() (vsync, waiting on the present thread) is not counted
+        - render to getRenderContext().getWidth() / getHeight(), they change between frames
+    */
+    void enableDynamicResolution(float targetFrameMs, float minScale = 0.5f);
+    void disableDynamicResolution();
+
+    // nullptr unless dynamic resolution is enabled
+    DynamicResolution const * getDynamicResolution() const;
+
+private:
+    /*
+        createRenderer(...)
+
+        - creates the SDL renderer and streaming texture on the calling thread
+    */
+    bool createRenderer(bool vSync);
+
+    /*
+        presentLoop(...)
+
+        - PresentMode::Threaded only, runs on m_presentThread and owns the renderer
+    */
+    void presentLoop(bool vSync, std::promise<bool> rendererCreated);
+
+    /*
+        acquireBackBuffer()
+
+        - PresentMode::Threaded only, points the render context at the next free swap chain buffer
+        - blocks if maxFramesInFlight frames are waiting to be presented
+    */
+    void acquireBackBuffer();
+
+    /*
+        updateDynamicResolution(...)
+
+        - feeds the controller and resizes the render context when it asks for a new size
+        - only call while the context is not bound to the texture / swap chain
+    */
+    void updateDynamicResolution(float renderMs);
+
+    /*
+        uploadDirtyRects()
+
+        - PresentMode::Copy with dirty tracking, uploads the changed tiles and resets them
+        - adds what was uploaded to bytesUploaded and rectsUploaded
+    */
+    void uploadDirtyRects(uint64_t & bytesUploaded, uint64_t & rectsUploaded);
+
+    /*
+        countPresent(...)
+
+        - adds one presented frame and its uploads to m_presentStats, called from the thread that presents
+    */
+    void countPresent(uint64_t bytesUploaded, uint64_t rectsUploaded);
+
+    /*
+        lockBackBuffer()
+
+        - PresentMode::ZeroCopy only, locks the texture and points the render context at it
+    */
+    bool lockBackBuffer();
+    void unlockBackBuffer();
+
 private:
     std::string m_title;
     int m_width;
@@ -31,5 +152,18 @@ private:
     SDL_Window * m_window;
     SDL_Renderer * m_renderer;
     SDL_Texture * m_renderTexture;    
+
+    PresentMode m_presentMode;
+    bool m_locked;
+
+    std::unique_ptr<SwapChain> m_swapChain;
+    std::thread m_presentThread;
+
+    std::vector<DirtyRect> m_dirtyRects;
+    PresentStats m_presentStats;
+    mutable std::mutex m_presentStatsMutex; // the present thread counts while the render thread reads
+
+    std::unique_ptr<DynamicResolution> m_dynamicResolution;
+    std::chrono::high_resolution_clock::time_point m_frameStart;
 };
 #endif /* Window_hpp */
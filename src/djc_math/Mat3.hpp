@@ -26,6 +26,9 @@ public: // friends
     template<typename U> 
     friend class Mat4;
 
+    template<typename U>
+    friend class Mat4x3;
+
 public: // RAII
     Mat3();
     explicit Mat3(std::array<T, 9> matrix);
@@ -41,8 +44,8 @@ public: // friend operators - defined in Mat3.inl
     friend std::ostream & operator <<<> (std::ostream & lhs, Mat3<T> const & rhs); // std::cout << Mat3 
 
 private: // private operators
-    float & operator [] (std::size_t index);
-    float const & operator [] (std::size_t index) const;
+    T & operator [] (std::size_t index);
+    T const & operator [] (std::size_t index) const;
 
 private: // private data
     std::array<T, 9> m_matrix;
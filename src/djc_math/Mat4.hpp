@@ -8,6 +8,7 @@
 #include <type_traits>
 
 // my
+#include "SIMD.hpp"
 #include "Vec4.hpp"
 #include "Mat3.hpp"
 
@@ -18,11 +19,20 @@ template<typename T> class Mat4;
 template<typename T> Mat4<T> operator * (Mat4<T> const & lhs, Mat4<T> const & rhs);
 template<typename T> Vec4<T> operator * (Mat4<T> const & lhs, Vec4<T> const & rhs);
 template<typename T> std::ostream & operator << (std::ostream & lhs, Mat4<T> const & rhs);
+template<typename T> Mat4<T> transpose(Mat4<T> const & matrix);
+template<typename T> Mat4<T> inverse(Mat4<T> const & matrix);
+template<typename T> class Mat4x3;
+template<typename T> Mat4<T> operator * (Mat4<T> const & lhs, Mat4x3<T> const & rhs);
+template<typename T> Mat4<T> operator * (Mat4x3<T> const & lhs, Mat4<T> const & rhs);
 
 template<typename T = float>
 class Mat4 final {
     static_assert(std::is_integral<T>::value || std::is_floating_point<T>::value, "T must be intergral or floating point");
     static_assert(std::is_nothrow_move_constructible<T>::value, "T must be no throw move constructable");
+public: // friends
+    template<typename U>
+    friend class Mat4x3;
+
 public: // RAII
     Mat4();
     explicit Mat4(std::array<T, 16> const & matrix);
@@ -41,12 +51,27 @@ public: // friend free operators - defined in Mat4.inl
     friend Vec4<T> operator *<> (Mat4<T> const & lhs, Vec4<T> const & rhs);
     friend std::ostream & operator <<<> (std::ostream & lhs, Mat4<T> const & rhs);  
 
+public: // friend free operators - defined in Mat4x3.inl
+    friend Mat4<T> operator *<> (Mat4<T> const & lhs, Mat4x3<T> const & rhs);
+    friend Mat4<T> operator *<> (Mat4x3<T> const & lhs, Mat4<T> const & rhs);
+
+public: // friend free functions - defined in Mat4.inl
+    friend Mat4<T> transpose<> (Mat4<T> const & matrix);
+
+    /*
+        inverse(...)
+
+        - floating point only, a singular matrix returns the zero matrix
+        - prefer a dedicated inverse when the matrix is known to be affine
+    */
+    friend Mat4<T> inverse<> (Mat4<T> const & matrix);
+
 private: // private operators
-    float & operator [] (std::size_t index);
-    float const & operator [] (std::size_t index) const;
+    T & operator [] (std::size_t index);
+    T const & operator [] (std::size_t index) const;
 
 private: // private data
-    std::array<T, 16> m_matrix;
+    alignas(16) std::array<T, 16> m_matrix; // row major, aligned so Mat4f rows load straight into SSE registers
 };
 
 // for ease of use in C++ 14 - in C++ 17 class templates can be deduced
@@ -56,4 +81,5 @@ using Mat4d = Mat4<double>;
 
 } /* namespace djc_math */
 #include "inline/Mat4.inl"
+#include "inline/Mat4SIMD.inl"
 #endif /* Mat4_hpp */
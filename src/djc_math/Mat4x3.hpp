@@ -0,0 +1,86 @@
+#ifndef Mat4x3_hpp
+#define Mat4x3_hpp
+
+// std
+#include <array>
+#include <iostream>
+#include <cstddef> // for std::size_t
+#include <type_traits>
+
+// my
+#include "Vec3.hpp"
+#include "Vec4.hpp"
+#include "Mat3.hpp"
+#include "Mat4.hpp"
+
+namespace djc_math {
+
+// template forward declarations
+template<typename T> class Mat4x3;
+template<typename T> Mat4x3<T> operator * (Mat4x3<T> const & lhs, Mat4x3<T> const & rhs);
+template<typename T> Mat4<T> operator * (Mat4<T> const & lhs, Mat4x3<T> const & rhs);
+template<typename T> Mat4<T> operator * (Mat4x3<T> const & lhs, Mat4<T> const & rhs);
+template<typename T> Vec4<T> operator * (Mat4x3<T> const & lhs, Vec4<T> const & rhs);
+template<typename T> Vec3<T> operator * (Mat4x3<T> const & lhs, Vec3<T> const & rhs);
+template<typename T> std::ostream & operator << (std::ostream & lhs, Mat4x3<T> const & rhs);
+template<typename T> Mat4x3<T> inverse(Mat4x3<T> const & matrix);
+
+/*
+    Mat4x3
+
+    - an affine Mat4, only the top three rows are stored, the last row is always [0, 0, 0, 1]
+    - Mat4x3 * Mat4x3 is 36 multiplies, Mat4 * Mat4x3 48 and Mat4x3 * Vec4 12, against 64 / 64 / 16 for Mat4
+    - converts to Mat4 implicitly, so it can be passed anywhere a Mat4 is taken
+*/
+template<typename T = float>
+class Mat4x3 final {
+    static_assert(std::is_integral<T>::value || std::is_floating_point<T>::value, "T must be intergral or floating point");
+    static_assert(std::is_nothrow_move_constructible<T>::value, "T must be no throw move constructable");
+public: // RAII
+    Mat4x3();
+    explicit Mat4x3(std::array<T, 12> const & matrix);
+    explicit Mat4x3(Mat3<T> const & linear, Vec3<T> const & translation);
+    explicit Mat4x3(Mat4<T> const & matrix); // drops the last row, only valid when it is [0, 0, 0, 1]
+    ~Mat4x3() = default;
+
+public: // member - functions
+    Mat3<T> toMat3() const;
+    Mat4<T> toMat4() const;
+    Vec3<T> getTranslation() const;
+
+public: // conversion
+    operator Mat4<T>() const;
+
+public: // friend free operators - defined in Mat4x3.inl
+    friend Mat4x3<T> operator *<> (Mat4x3<T> const & lhs, Mat4x3<T> const & rhs);
+    friend Mat4<T> operator *<> (Mat4<T> const & lhs, Mat4x3<T> const & rhs);
+    friend Mat4<T> operator *<> (Mat4x3<T> const & lhs, Mat4<T> const & rhs);
+    friend Vec4<T> operator *<> (Mat4x3<T> const & lhs, Vec4<T> const & rhs); // w is passed through
+    friend Vec3<T> operator *<> (Mat4x3<T> const & lhs, Vec3<T> const & rhs); // transformed as a point, w = 1
+    friend std::ostream & operator <<<> (std::ostream & lhs, Mat4x3<T> const & rhs);
+
+public: // friend free functions - defined in Mat4x3.inl
+    /*
+        inverse(...)
+
+        - floating point only, a singular matrix returns the zero matrix
+        - inverts the 3x3 block and maps the translation back through it, no 4x4 cofactors
+    */
+    friend Mat4x3<T> inverse<> (Mat4x3<T> const & matrix);
+
+private: // private operators
+    T & operator [] (std::size_t index);
+    T const & operator [] (std::size_t index) const;
+
+private: // private data
+    alignas(16) std::array<T, 12> m_matrix; // row major, same layout as the first three rows of a Mat4
+};
+
+// for ease of use in C++ 14 - in C++ 17 class templates can be deduced
+using Mat4x3i = Mat4x3<int>;
+using Mat4x3f = Mat4x3<float>;
+using Mat4x3d = Mat4x3<double>;
+
+} /* namespace djc_math */
+#include "inline/Mat4x3.inl"
+#endif /* Mat4x3_hpp */
@@ -0,0 +1,22 @@
+#ifndef SIMD_hpp
+#define SIMD_hpp
+
+/*
+    SIMD
+
+    - Vec4f and Mat4f pick up SSE specialisations when the target has SSE2 (every x86-64 build)
+    - Mat4f * Mat4f uses AVX when the target has it (-mavx / -march=native)
+    - define DJC_MATH_NO_SIMD before including djc_math to keep the plain templates
+    - other element types (Vec4i, Mat4d, ...) always use the plain templates
+*/
+#if !defined(DJC_MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define DJC_MATH_SSE
+    #include <emmintrin.h>
+
+    #if defined(__AVX__)
+        #define DJC_MATH_AVX
+        #include <immintrin.h>
+    #endif
+#endif
+
+#endif /* SIMD_hpp */
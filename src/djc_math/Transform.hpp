@@ -9,6 +9,7 @@
 #include "Vec3.hpp"
 #include "Mat3.hpp"
 #include "Mat4.hpp"
+#include "Mat4x3.hpp"
 
 namespace djc_math {
 
@@ -29,20 +30,21 @@ createMat3RotationMatrix(Vec3<T> const & vec);
 //-------------------//
 
 // create new //
+// the affine transforms return Mat4x3, which converts to Mat4 where one is needed
 
 template<typename T> inline Mat4<T> 
 createMat4IdentityMatrix();
 
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4TranslationMatrix(Vec3<T> const & vec);
 
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4RotationMatrix(Vec3<T> const & vec);
 
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4ScaleMatrix(Vec3<T> const & vec);
 
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4ModelMatrix(Vec3<T> const & position, Vec3<T> const & rotation, Vec3<T> const & scale);
 
 template<typename T> inline Mat4<T>
@@ -54,10 +56,10 @@ createMat4ProjectionMatrix(T fov, T aspect, T zNear, T zFar);
 template<typename T, typename U> inline Mat4<T>
 createMat4ProjectionMatrix(T fov, U width, U height, T zNear, T zFar);
 
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4ViewMatrix(Vec3<T> const & eye, Vec3<T> const & centre, Vec3<T> const & up);
 
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4BirdsEyeViewMatrix();
 
 template<typename T> inline Mat4<T>
@@ -70,10 +72,13 @@ createMat4ScreenSpaceTransform(T halfWifth, T halfHeight);
 template<typename T> inline void
 transform(Vec4<T> & vec, Mat4<T> const & transformation);
 
+template<typename T> inline void
+transform(Vec4<T> & vec, Mat4x3<T> const & transformation);
+
 template<typename T> inline Mat3<T>
 rotate(T angle, Vec3<T> const & axis);
 
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 rotate(T angle, Vec4<T> const & axis);
 
 } /* namespace djc_math */
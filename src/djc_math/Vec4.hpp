@@ -7,6 +7,7 @@
 #include <type_traits>
 
 // my
+#include "SIMD.hpp"
 #include "Vec2.hpp"
 #include "Vec3.hpp"
 
@@ -99,4 +100,5 @@ using Vec4d = Vec4<double>;
 
 } /* namespace djc_math */
 #include "inline/Vec4.inl"
+#include "inline/Vec4SIMD.inl"
 #endif /* Vec4_hpp */
@@ -7,6 +7,7 @@
 
 #include "Mat3.hpp"
 #include "Mat4.hpp"
+#include "Mat4x3.hpp"
 
 #include "Transform.hpp"
 #include "Utils.hpp"
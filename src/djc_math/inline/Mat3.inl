@@ -77,13 +77,13 @@ operator << (std::ostream & lhs, Mat3<T> const & rhs) {
 }
 
 //------------------------------------------------------------
-template<typename T> float & 
+template<typename T> T & 
 Mat3<T>::operator [] (std::size_t index) {
     return m_matrix[index];
 }
 
 //------------------------------------------------------------
-template<typename T> float const & 
+template<typename T> T const & 
 Mat3<T>::operator [] (std::size_t index) const {
     return m_matrix[index];
 }
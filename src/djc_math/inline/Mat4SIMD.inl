@@ -0,0 +1,192 @@
+#if defined(DJC_MATH_SSE)
+namespace djc_math {
+
+// Mat4f specialisations - every other Mat4<T> uses the templates in Mat4.inl
+// products are summed in the same order as the templates so results match them bit for bit
+
+//------------------------------------------------------------
+template<> inline /* friend */ Mat4<float>
+operator * (Mat4<float> const & lhs, Mat4<float> const & rhs) {
+    float const * l = lhs.m_matrix.data();
+    float const * r = rhs.m_matrix.data();
+
+    Mat4<float> result;
+    float * out = result.m_matrix.data();
+
+#if defined(DJC_MATH_AVX)
+    // two result rows per register, the lhs rows are splatted within each 128 bit lane
+    __m256 r0 = _mm256_broadcast_ps(reinterpret_cast<__m128 const *>(r +  0));
+    __m256 r1 = _mm256_broadcast_ps(reinterpret_cast<__m128 const *>(r +  4));
+    __m256 r2 = _mm256_broadcast_ps(reinterpret_cast<__m128 const *>(r +  8));
+    __m256 r3 = _mm256_broadcast_ps(reinterpret_cast<__m128 const *>(r + 12));
+
+    auto rows = [&](int row) {
+        __m256 a = _mm256_loadu_ps(l + row * 4);
+
+        __m256 sum = _mm256_mul_ps(_mm256_permute_ps(a, 0x00), r0);
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(a, 0x55), r1));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(a, 0xAA), r2));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_permute_ps(a, 0xFF), r3));
+
+        _mm256_storeu_ps(out + row * 4, sum); // rows are only 16 byte aligned
+    };
+
+    rows(0);
+    rows(2);
+#else
+    __m128 r0 = _mm_load_ps(r +  0);
+    __m128 r1 = _mm_load_ps(r +  4);
+    __m128 r2 = _mm_load_ps(r +  8);
+    __m128 r3 = _mm_load_ps(r + 12);
+
+    auto row = [&](int row) {
+        __m128 a = _mm_load_ps(l + row * 4);
+
+        __m128 sum = _mm_mul_ps(_mm_shuffle_ps(a, a, 0x00), r0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(a, a, 0x55), r1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xAA), r2));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(a, a, 0xFF), r3));
+
+        _mm_store_ps(out + row * 4, sum);
+    };
+
+    row(0);
+    row(1);
+    row(2);
+    row(3);
+#endif
+
+    return result;
+}
+
+//------------------------------------------------------------
+template<> inline /* friend */ Vec4<float>
+operator * (Mat4<float> const & lhs, Vec4<float> const & rhs) {
+    float const * l = lhs.m_matrix.data();
+
+    // columns, so each lane accumulates one row's dot product
+    __m128 c0 = _mm_load_ps(l +  0);
+    __m128 c1 = _mm_load_ps(l +  4);
+    __m128 c2 = _mm_load_ps(l +  8);
+    __m128 c3 = _mm_load_ps(l + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    __m128 sum = _mm_mul_ps(c0, _mm_set1_ps(rhs.x));
+    sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(rhs.y)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(rhs.z)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(rhs.w)));
+
+    Vec4<float> result;
+    _mm_storeu_ps(&result.x, sum);
+    return result;
+}
+
+//------------------------------------------------------------
+template<> inline /* friend */ Mat4<float>
+transpose(Mat4<float> const & matrix) {
+    float const * m = matrix.m_matrix.data();
+
+    __m128 row0 = _mm_load_ps(m +  0);
+    __m128 row1 = _mm_load_ps(m +  4);
+    __m128 row2 = _mm_load_ps(m +  8);
+    __m128 row3 = _mm_load_ps(m + 12);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    Mat4<float> result;
+    float * out = result.m_matrix.data();
+    _mm_store_ps(out +  0, row0);
+    _mm_store_ps(out +  4, row1);
+    _mm_store_ps(out +  8, row2);
+    _mm_store_ps(out + 12, row3);
+    return result;
+}
+
+//------------------------------------------------------------
+template<> inline /* friend */ Mat4<float>
+inverse(Mat4<float> const & matrix) {
+    // block inverse, the matrix is split into the 2x2 blocks | A B |
+    //                                                       | C D |
+    // each 2x2 block is stored row major in one register: (m00, m01, m10, m11)
+    float const * m = matrix.m_matrix.data();
+
+    #define DJC_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+    #define DJC_SWIZZLE(a, x, y, z, w)    _mm_shuffle_ps(a, a, _MM_SHUFFLE(w, z, y, x))
+
+    // 2x2 A * B
+    auto mat2Mul = [](__m128 a, __m128 b) -> __m128 {
+        return _mm_add_ps(_mm_mul_ps(a, DJC_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(DJC_SWIZZLE(a, 1, 0, 3, 2), DJC_SWIZZLE(b, 2, 1, 2, 1)));
+    };
+
+    // 2x2 adjugate(A) * B
+    auto mat2AdjMul = [](__m128 a, __m128 b) -> __m128 {
+        return _mm_sub_ps(_mm_mul_ps(DJC_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(DJC_SWIZZLE(a, 1, 1, 2, 2), DJC_SWIZZLE(b, 2, 3, 0, 1)));
+    };
+
+    // 2x2 A * adjugate(B)
+    auto mat2MulAdj = [](__m128 a, __m128 b) -> __m128 {
+        return _mm_sub_ps(_mm_mul_ps(a, DJC_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(DJC_SWIZZLE(a, 1, 0, 3, 2), DJC_SWIZZLE(b, 2, 1, 2, 1)));
+    };
+
+    __m128 row0 = _mm_load_ps(m +  0);
+    __m128 row1 = _mm_load_ps(m +  4);
+    __m128 row2 = _mm_load_ps(m +  8);
+    __m128 row3 = _mm_load_ps(m + 12);
+
+    __m128 A = _mm_movelh_ps(row0, row1);
+    __m128 B = _mm_movehl_ps(row1, row0);
+    __m128 C = _mm_movelh_ps(row2, row3);
+    __m128 D = _mm_movehl_ps(row3, row2);
+
+    // (|A|, |B|, |C|, |D|)
+    __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(DJC_SHUFFLE(row0, row2, 0, 2, 0, 2), DJC_SHUFFLE(row1, row3, 1, 3, 1, 3)),
+        _mm_mul_ps(DJC_SHUFFLE(row0, row2, 1, 3, 1, 3), DJC_SHUFFLE(row1, row3, 0, 2, 0, 2)));
+
+    __m128 detA = DJC_SWIZZLE(detSub, 0, 0, 0, 0);
+    __m128 detB = DJC_SWIZZLE(detSub, 1, 1, 1, 1);
+    __m128 detC = DJC_SWIZZLE(detSub, 2, 2, 2, 2);
+    __m128 detD = DJC_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    __m128 adjDC = mat2AdjMul(D, C);
+    __m128 adjAB = mat2AdjMul(A, B);
+
+    // adjugates of the inverse's blocks | X Y |
+    //                                   | Z W |
+    __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), mat2Mul(B, adjDC));
+    __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), mat2Mul(C, adjAB));
+    __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), mat2MulAdj(D, adjAB));
+    __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), mat2MulAdj(A, adjDC));
+
+    // |M| = |A||D| + |B||C| - tr(adjugate(A)B adjugate(D)C)
+    __m128 trace = _mm_mul_ps(adjAB, DJC_SWIZZLE(adjDC, 0, 2, 1, 3));
+    trace = _mm_add_ps(trace, DJC_SWIZZLE(trace, 2, 3, 0, 1));
+    trace = _mm_add_ps(trace, DJC_SWIZZLE(trace, 1, 0, 3, 2));
+
+    __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+    if(_mm_cvtss_f32(detM) == 0.0f) {
+        return Mat4<float>();
+    }
+
+    __m128 rcpDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+
+    X = _mm_mul_ps(X, rcpDet);
+    Y = _mm_mul_ps(Y, rcpDet);
+    Z = _mm_mul_ps(Z, rcpDet);
+    W = _mm_mul_ps(W, rcpDet);
+
+    // undo the adjugate and put the blocks back into rows in one shuffle each
+    Mat4<float> result;
+    float * out = result.m_matrix.data();
+    _mm_store_ps(out +  0, DJC_SHUFFLE(X, Y, 3, 1, 3, 1));
+    _mm_store_ps(out +  4, DJC_SHUFFLE(X, Y, 2, 0, 2, 0));
+    _mm_store_ps(out +  8, DJC_SHUFFLE(Z, W, 3, 1, 3, 1));
+    _mm_store_ps(out + 12, DJC_SHUFFLE(Z, W, 2, 0, 2, 0));
+
+    #undef DJC_SHUFFLE
+    #undef DJC_SWIZZLE
+    return result;
+}
+
+} /* namespace djc_math */
+#endif /* DJC_MATH_SSE */
@@ -0,0 +1,246 @@
+namespace djc_math {
+
+//------------------------------------------------------------
+template<typename T>
+Mat4x3<T>::Mat4x3() {
+    m_matrix.fill(T());
+}
+
+//------------------------------------------------------------
+template<typename T>
+Mat4x3<T>::Mat4x3(std::array<T, 12> const & matrix)
+: m_matrix(matrix)
+{
+    // empty
+}
+
+//------------------------------------------------------------
+template<typename T>
+Mat4x3<T>::Mat4x3(Mat3<T> const & linear, Vec3<T> const & translation)
+:   m_matrix(std::array<T, 12>{{
+        linear[0], linear[1], linear[2], translation.x,
+        linear[3], linear[4], linear[5], translation.y,
+        linear[6], linear[7], linear[8], translation.z}})
+{
+    // empty
+}
+
+//------------------------------------------------------------
+template<typename T>
+Mat4x3<T>::Mat4x3(Mat4<T> const & matrix)
+:   m_matrix(std::array<T, 12>{{
+        matrix[0], matrix[1], matrix[ 2], matrix[ 3],
+        matrix[4], matrix[5], matrix[ 6], matrix[ 7],
+        matrix[8], matrix[9], matrix[10], matrix[11]}})
+{
+    // empty
+}
+
+//------------------------------------------------------------
+template<typename T> Mat3<T>
+Mat4x3<T>::toMat3() const {
+    return Mat3<T>(std::array<T, 9> {{
+        m_matrix[0], m_matrix[1], m_matrix[2],
+        m_matrix[4], m_matrix[5], m_matrix[6],
+        m_matrix[8], m_matrix[9], m_matrix[10]
+    }});
+}
+
+//------------------------------------------------------------
+template<typename T> Mat4<T>
+Mat4x3<T>::toMat4() const {
+    return Mat4<T>(std::array<T, 16> {{
+        m_matrix[0], m_matrix[1], m_matrix[ 2], m_matrix[ 3],
+        m_matrix[4], m_matrix[5], m_matrix[ 6], m_matrix[ 7],
+        m_matrix[8], m_matrix[9], m_matrix[10], m_matrix[11],
+        0,           0,           0,            1
+    }});
+}
+
+//------------------------------------------------------------
+template<typename T> Vec3<T>
+Mat4x3<T>::getTranslation() const {
+    return Vec3<T>(m_matrix[3], m_matrix[7], m_matrix[11]);
+}
+
+//------------------------------------------------------------
+template<typename T>
+Mat4x3<T>::operator Mat4<T>() const {
+    return toMat4();
+}
+
+//------------------------------------------------------------
+template<typename T> /* friend */ Mat4x3<T>
+operator * (Mat4x3<T> const & lhs, Mat4x3<T> const & rhs) {
+    //----------------------
+    // [0 ]  [1 ]  [2 ] [3 ]
+    // [4 ]  [5 ]  [6 ] [7 ]
+    // [8 ]  [9 ]  [10] [11]
+    //  0     0     0    1     <- implicit
+    //----------------------
+
+    return Mat4x3<T>(std::array<T, 12>{{
+      ///////
+      /*[ 0]*/ (lhs[ 0] * rhs[ 0]) + (lhs[ 1] * rhs[ 4]) + (lhs[ 2] * rhs[ 8]),
+      /*[ 1]*/ (lhs[ 0] * rhs[ 1]) + (lhs[ 1] * rhs[ 5]) + (lhs[ 2] * rhs[ 9]),
+      /*[ 2]*/ (lhs[ 0] * rhs[ 2]) + (lhs[ 1] * rhs[ 6]) + (lhs[ 2] * rhs[10]),
+      /*[ 3]*/ (lhs[ 0] * rhs[ 3]) + (lhs[ 1] * rhs[ 7]) + (lhs[ 2] * rhs[11]) + lhs[ 3],
+      ///////
+      /*[ 4]*/ (lhs[ 4] * rhs[ 0]) + (lhs[ 5] * rhs[ 4]) + (lhs[ 6] * rhs[ 8]),
+      /*[ 5]*/ (lhs[ 4] * rhs[ 1]) + (lhs[ 5] * rhs[ 5]) + (lhs[ 6] * rhs[ 9]),
+      /*[ 6]*/ (lhs[ 4] * rhs[ 2]) + (lhs[ 5] * rhs[ 6]) + (lhs[ 6] * rhs[10]),
+      /*[ 7]*/ (lhs[ 4] * rhs[ 3]) + (lhs[ 5] * rhs[ 7]) + (lhs[ 6] * rhs[11]) + lhs[ 7],
+      ///////
+      /*[ 8]*/ (lhs[ 8] * rhs[ 0]) + (lhs[ 9] * rhs[ 4]) + (lhs[10] * rhs[ 8]),
+      /*[ 9]*/ (lhs[ 8] * rhs[ 1]) + (lhs[ 9] * rhs[ 5]) + (lhs[10] * rhs[ 9]),
+      /*[10]*/ (lhs[ 8] * rhs[ 2]) + (lhs[ 9] * rhs[ 6]) + (lhs[10] * rhs[10]),
+      /*[11]*/ (lhs[ 8] * rhs[ 3]) + (lhs[ 9] * rhs[ 7]) + (lhs[10] * rhs[11]) + lhs[11],
+      ///////
+    }});
+}
+
+//------------------------------------------------------------
+template<typename T> /* friend */ Mat4<T>
+operator * (Mat4<T> const & lhs, Mat4x3<T> const & rhs) {
+    // rhs row 3 is [0, 0, 0, 1], so lhs column 3 only reaches the translation column
+    return Mat4<T>(std::array<T, 16>{{
+      ///////
+      /*[ 0]*/ (lhs[ 0] * rhs[ 0]) + (lhs[ 1] * rhs[ 4]) + (lhs[ 2] * rhs[ 8]),
+      /*[ 1]*/ (lhs[ 0] * rhs[ 1]) + (lhs[ 1] * rhs[ 5]) + (lhs[ 2] * rhs[ 9]),
+      /*[ 2]*/ (lhs[ 0] * rhs[ 2]) + (lhs[ 1] * rhs[ 6]) + (lhs[ 2] * rhs[10]),
+      /*[ 3]*/ (lhs[ 0] * rhs[ 3]) + (lhs[ 1] * rhs[ 7]) + (lhs[ 2] * rhs[11]) + lhs[ 3],
+      ///////
+      /*[ 4]*/ (lhs[ 4] * rhs[ 0]) + (lhs[ 5] * rhs[ 4]) + (lhs[ 6] * rhs[ 8]),
+      /*[ 5]*/ (lhs[ 4] * rhs[ 1]) + (lhs[ 5] * rhs[ 5]) + (lhs[ 6] * rhs[ 9]),
+      /*[ 6]*/ (lhs[ 4] * rhs[ 2]) + (lhs[ 5] * rhs[ 6]) + (lhs[ 6] * rhs[10]),
+      /*[ 7]*/ (lhs[ 4] * rhs[ 3]) + (lhs[ 5] * rhs[ 7]) + (lhs[ 6] * rhs[11]) + lhs[ 7],
+      ///////
+      /*[ 8]*/ (lhs[ 8] * rhs[ 0]) + (lhs[ 9] * rhs[ 4]) + (lhs[10] * rhs[ 8]),
+      /*[ 9]*/ (lhs[ 8] * rhs[ 1]) + (lhs[ 9] * rhs[ 5]) + (lhs[10] * rhs[ 9]),
+      /*[10]*/ (lhs[ 8] * rhs[ 2]) + (lhs[ 9] * rhs[ 6]) + (lhs[10] * rhs[10]),
+      /*[11]*/ (lhs[ 8] * rhs[ 3]) + (lhs[ 9] * rhs[ 7]) + (lhs[10] * rhs[11]) + lhs[11],
+      ///////
+      /*[12]*/ (lhs[12] * rhs[ 0]) + (lhs[13] * rhs[ 4]) + (lhs[14] * rhs[ 8]),
+      /*[13]*/ (lhs[12] * rhs[ 1]) + (lhs[13] * rhs[ 5]) + (lhs[14] * rhs[ 9]),
+      /*[14]*/ (lhs[12] * rhs[ 2]) + (lhs[13] * rhs[ 6]) + (lhs[14] * rhs[10]),
+      /*[15]*/ (lhs[12] * rhs[ 3]) + (lhs[13] * rhs[ 7]) + (lhs[14] * rhs[11]) + lhs[15],
+      ///////
+    }});
+}
+
+//------------------------------------------------------------
+template<typename T> /* friend */ Mat4<T>
+operator * (Mat4x3<T> const & lhs, Mat4<T> const & rhs) {
+    // lhs row 3 is [0, 0, 0, 1], so the last row is rhs row 3 as it is
+    return Mat4<T>(std::array<T, 16>{{
+      ///////
+      /*[ 0]*/ (lhs[ 0] * rhs[ 0]) + (lhs[ 1] * rhs[ 4]) + (lhs[ 2] * rhs[ 8]) + (lhs[ 3] * rhs[12]),
+      /*[ 1]*/ (lhs[ 0] * rhs[ 1]) + (lhs[ 1] * rhs[ 5]) + (lhs[ 2] * rhs[ 9]) + (lhs[ 3] * rhs[13]),
+      /*[ 2]*/ (lhs[ 0] * rhs[ 2]) + (lhs[ 1] * rhs[ 6]) + (lhs[ 2] * rhs[10]) + (lhs[ 3] * rhs[14]),
+      /*[ 3]*/ (lhs[ 0] * rhs[ 3]) + (lhs[ 1] * rhs[ 7]) + (lhs[ 2] * rhs[11]) + (lhs[ 3] * rhs[15]),
+      ///////
+      /*[ 4]*/ (lhs[ 4] * rhs[ 0]) + (lhs[ 5] * rhs[ 4]) + (lhs[ 6] * rhs[ 8]) + (lhs[ 7] * rhs[12]),
+      /*[ 5]*/ (lhs[ 4] * rhs[ 1]) + (lhs[ 5] * rhs[ 5]) + (lhs[ 6] * rhs[ 9]) + (lhs[ 7] * rhs[13]),
+      /*[ 6]*/ (lhs[ 4] * rhs[ 2]) + (lhs[ 5] * rhs[ 6]) + (lhs[ 6] * rhs[10]) + (lhs[ 7] * rhs[14]),
+      /*[ 7]*/ (lhs[ 4] * rhs[ 3]) + (lhs[ 5] * rhs[ 7]) + (lhs[ 6] * rhs[11]) + (lhs[ 7] * rhs[15]),
+      ///////
+      /*[ 8]*/ (lhs[ 8] * rhs[ 0]) + (lhs[ 9] * rhs[ 4]) + (lhs[10] * rhs[ 8]) + (lhs[11] * rhs[12]),
+      /*[ 9]*/ (lhs[ 8] * rhs[ 1]) + (lhs[ 9] * rhs[ 5]) + (lhs[10] * rhs[ 9]) + (lhs[11] * rhs[13]),
+      /*[10]*/ (lhs[ 8] * rhs[ 2]) + (lhs[ 9] * rhs[ 6]) + (lhs[10] * rhs[10]) + (lhs[11] * rhs[14]),
+      /*[11]*/ (lhs[ 8] * rhs[ 3]) + (lhs[ 9] * rhs[ 7]) + (lhs[10] * rhs[11]) + (lhs[11] * rhs[15]),
+      ///////
+      /*[12]*/ rhs[12],
+      /*[13]*/ rhs[13],
+      /*[14]*/ rhs[14],
+      /*[15]*/ rhs[15]
+      ///////
+    }});
+}
+
+//------------------------------------------------------------
+template<typename T> /* friend */ Vec4<T>
+operator * (Mat4x3<T> const & lhs, Vec4<T> const & rhs) {
+    return Vec4<T>(
+        /*[x]*/ (lhs[ 0] * rhs.x) + (lhs[ 1] * rhs.y) + (lhs[ 2] * rhs.z) + (lhs[ 3] * rhs.w),
+        /*[y]*/ (lhs[ 4] * rhs.x) + (lhs[ 5] * rhs.y) + (lhs[ 6] * rhs.z) + (lhs[ 7] * rhs.w),
+        /*[z]*/ (lhs[ 8] * rhs.x) + (lhs[ 9] * rhs.y) + (lhs[10] * rhs.z) + (lhs[11] * rhs.w),
+        /*[w]*/ rhs.w
+    );
+}
+
+//------------------------------------------------------------
+template<typename T> /* friend */ Vec3<T>
+operator * (Mat4x3<T> const & lhs, Vec3<T> const & rhs) {
+    return Vec3<T>(
+        /*[x]*/ (lhs[ 0] * rhs.x) + (lhs[ 1] * rhs.y) + (lhs[ 2] * rhs.z) + lhs[ 3],
+        /*[y]*/ (lhs[ 4] * rhs.x) + (lhs[ 5] * rhs.y) + (lhs[ 6] * rhs.z) + lhs[ 7],
+        /*[z]*/ (lhs[ 8] * rhs.x) + (lhs[ 9] * rhs.y) + (lhs[10] * rhs.z) + lhs[11]
+    );
+}
+
+//------------------------------------------------------------
+template<typename T> /* friend */ std::ostream &
+operator << (std::ostream & lhs, Mat4x3<T> const & rhs) {
+    lhs << "Mat4x3\n-----------------\n";
+    for (int x = 0; x < 3; x++) {
+        for (int y = 0; y < 4; y++) {
+                lhs << "[" << rhs.m_matrix[4 * x + y] << "] ";
+        }
+          lhs << "\n";
+    }
+    lhs << "-----------------";
+    return lhs;
+}
+
+//------------------------------------------------------------
+template<typename T> /* friend */ Mat4x3<T>
+inverse(Mat4x3<T> const & matrix) {
+    static_assert(std::is_floating_point<T>::value, "inverse only accepts floating point matrices");
+
+    // | L t |^-1   | L^-1  -L^-1 t |
+    // | 0 1 |    = | 0      1      |
+    auto const & m = matrix.m_matrix;
+
+    // adjugate of L
+    T a00 = m[5] * m[10] - m[6] * m[9];
+    T a01 = m[2] * m[ 9] - m[1] * m[10];
+    T a02 = m[1] * m[ 6] - m[2] * m[5];
+    T a10 = m[6] * m[ 8] - m[4] * m[10];
+    T a11 = m[0] * m[10] - m[2] * m[8];
+    T a12 = m[2] * m[ 4] - m[0] * m[6];
+    T a20 = m[4] * m[ 9] - m[5] * m[8];
+    T a21 = m[1] * m[ 8] - m[0] * m[9];
+    T a22 = m[0] * m[ 5] - m[1] * m[4];
+
+    T det = m[0] * a00 + m[1] * a10 + m[2] * a20;
+
+    if(det == T(0)) {
+        return Mat4x3<T>();
+    }
+
+    T oneOverDet = T(1) / det;
+
+    a00 *= oneOverDet; a01 *= oneOverDet; a02 *= oneOverDet;
+    a10 *= oneOverDet; a11 *= oneOverDet; a12 *= oneOverDet;
+    a20 *= oneOverDet; a21 *= oneOverDet; a22 *= oneOverDet;
+
+    return Mat4x3<T>(std::array<T, 12>{{
+        a00, a01, a02, -((a00 * m[3]) + (a01 * m[7]) + (a02 * m[11])),
+        a10, a11, a12, -((a10 * m[3]) + (a11 * m[7]) + (a12 * m[11])),
+        a20, a21, a22, -((a20 * m[3]) + (a21 * m[7]) + (a22 * m[11]))
+    }});
+}
+
+//------------------------------------------------------------
+template<typename T> T &
+Mat4x3<T>::operator [] (std::size_t index) {
+    return m_matrix[index];
+}
+
+//------------------------------------------------------------
+template<typename T> T const &
+Mat4x3<T>::operator [] (std::size_t index) const {
+    return m_matrix[index];
+}
+
+} /* namespace djc_math */
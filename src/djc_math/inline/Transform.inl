@@ -74,21 +74,20 @@ createMat4IdentityMatrix() {
 }
 
 //------------------------------------------------------------
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4TranslationMatrix(Vec3<T> const & vec) {
     static_assert(std::is_floating_point<T>::value || std::is_integral<T>::value, 
                   "createMat4TranslationMatrix() only accepts floating point, and integral values");    
 
-    return Mat4<T>(std::array<T, 16>{{
+    return Mat4x3<T>(std::array<T, 12>{{
         1,    0,    0,    vec.x,
         0,    1,    0,    vec.y,
-        0,    0,    1,    vec.z,
-        0,    0,    0,    1
+        0,    0,    1,    vec.z
     }});
 }
 
 //------------------------------------------------------------
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4RotationMatrix(Vec3<T> const & rotation) {
      static_assert(std::is_floating_point<T>::value,
                   "createMat4RotationMatrix() only accepts floating point values"); 
@@ -120,29 +119,28 @@ createMat4RotationMatrix(Vec3<T> const & rotation) {
         0,       0,      1
     }});
 
-    return Mat4<T>((rotX * rotY * rotZ), static_cast<T>(1));
+    return Mat4x3<T>((rotX * rotY * rotZ), Vec3<T>(0));
 }
 
 //------------------------------------------------------------
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4ScaleMatrix(Vec3<T> const & vec) {
     static_assert(std::is_floating_point<T>::value || std::is_integral<T>::value, 
                 "createMat4ScaleMatrix() only accepts floating point, and integral values"); 
 
-     return Mat4<T>(std::array<T, 16>{{
+     return Mat4x3<T>(std::array<T, 12>{{
         vec.x,    0,        0,        0,
         0,        vec.y,    0,        0,
-        0,        0,        vec.z,    0,
-        0,        0,        0,        1
+        0,        0,        vec.z,    0
     }});
 }
 
 //------------------------------------------------------------
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4ModelMatrix(Vec3<T> const & position, Vec3<T> const & rotation, Vec3<T> const & scale) {
-    Mat4<T> _translation = createMat4TranslationMatrix<T>(position);
-    Mat4<T> _rotation    = createMat4RotationMatrix<T>(rotation);
-    Mat4<T> _scale       = createMat4ScaleMatrix<T>(scale);
+    Mat4x3<T> _translation = createMat4TranslationMatrix<T>(position);
+    Mat4x3<T> _rotation    = createMat4RotationMatrix<T>(rotation);
+    Mat4x3<T> _scale       = createMat4ScaleMatrix<T>(scale);
     return _translation * _rotation * _scale;
 }
 
@@ -195,29 +193,27 @@ createMat4ProjectionMatrix(T fov, T aspect, T near, T far) {
 }
 
 //------------------------------------------------------------
-template<typename T> inline Mat4<T> 
+template<typename T> inline Mat4x3<T> 
 createMat4ViewMatrix(Vec3<T> const & eye, Vec3<T> const & centre, Vec3<T> const & up) {
 
     Vec3<T> forward(0, 0,-1);
     Vec3<T> right(1, 0, 0);
 
-    return Mat4<T>(std::array<T, 16>{{
+    return Mat4x3<T>(std::array<T, 12>{{
            right.x,       right.y,       right.z,    -eye.x,
            up.x,          up.y,          up.z,       -eye.y,
-           -forward.x,    -forward.y,    -forward.z, -eye.z,
-           0,             0,              0,          1
+           -forward.x,    -forward.y,    -forward.z, -eye.z
     }});
 
 }
 
 //----------------------w--------------------------------------
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 createMat4BirdsEyeViewMatrix() {
-    return Mat4<T>(std::array<T, 16> {{
+    return Mat4x3<T>(std::array<T, 12> {{
         1,    0,    0,     0,
         0,    0,    -1,    0,
-        0,    1,    0,     0,
-        0,    0,    0,     1
+        0,    1,    0,     0
     }});
 }
 
@@ -253,6 +249,12 @@ transform(Vec4<T> & vec, Mat4<T> const & transformation) {
     vec = transformation * vec;
 }
 
+//------------------------------------------------------------
+template<typename T> inline void
+transform(Vec4<T> & vec, Mat4x3<T> const & transformation) {
+    vec = transformation * vec;
+}
+
 //------------------------------------------------------------
 template<typename T> inline Mat3<T>
 rotate(T angle, Vec3<T> const & axis) {
@@ -260,7 +262,7 @@ rotate(T angle, Vec3<T> const & axis) {
 }
 
 //------------------------------------------------------------
-template<typename T> inline Mat4<T>
+template<typename T> inline Mat4x3<T>
 rotate(T angle, Vec4<T> const & axis) {
     return createMat4RotationMatrix<T>(axis * angle);
 }
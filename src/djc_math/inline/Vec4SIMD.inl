@@ -0,0 +1,99 @@
+#if defined(DJC_MATH_SSE)
+namespace djc_math {
+
+// Vec4f specialisations - every other Vec4<T> uses the templates in Vec4.inl
+// x, y, z, w are contiguous so a Vec4f loads straight into one SSE register
+static_assert(sizeof(Vec4<float>) == 4 * sizeof(float), "Vec4f must be four packed floats");
+
+namespace simd {
+    inline __m128 load(Vec4<float> const & vec) {
+        return _mm_loadu_ps(&vec.x);
+    }
+
+    inline Vec4<float> store(__m128 value) {
+        Vec4<float> vec;
+        _mm_storeu_ps(&vec.x, value);
+        return vec;
+    }
+} /* namespace simd */
+
+// member - operator overloads
+
+//------------------------------------------------------------
+template<> inline Vec4<float> &
+Vec4<float>::operator += (Vec4<float> const & rhs) {
+    _mm_storeu_ps(&x, _mm_add_ps(simd::load(*this), simd::load(rhs)));
+    return *this;
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float> &
+Vec4<float>::operator -= (Vec4<float> const & rhs) {
+    _mm_storeu_ps(&x, _mm_sub_ps(simd::load(*this), simd::load(rhs)));
+    return *this;
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float> &
+Vec4<float>::operator *= (Vec4<float> const & rhs) {
+    _mm_storeu_ps(&x, _mm_mul_ps(simd::load(*this), simd::load(rhs)));
+    return *this;
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float> &
+Vec4<float>::operator /= (Vec4<float> const & rhs) {
+    _mm_storeu_ps(&x, _mm_div_ps(simd::load(*this), simd::load(rhs)));
+    return *this;
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float> &
+Vec4<float>::operator *= (float rhs) {
+    _mm_storeu_ps(&x, _mm_mul_ps(simd::load(*this), _mm_set1_ps(rhs)));
+    return *this;
+}
+
+// free function operator overloads
+
+//------------------------------------------------------------
+template<> inline Vec4<float>
+operator + (Vec4<float> const & lhs, Vec4<float> const & rhs) {
+    return simd::store(_mm_add_ps(simd::load(lhs), simd::load(rhs)));
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float>
+operator - (Vec4<float> const & lhs, Vec4<float> const & rhs) {
+    return simd::store(_mm_sub_ps(simd::load(lhs), simd::load(rhs)));
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float>
+operator * (Vec4<float> const & lhs, Vec4<float> const & rhs) {
+    return simd::store(_mm_mul_ps(simd::load(lhs), simd::load(rhs)));
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float>
+operator / (Vec4<float> const & lhs, Vec4<float> const & rhs) {
+    return simd::store(_mm_div_ps(simd::load(lhs), simd::load(rhs)));
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float>
+operator * (float lhs, Vec4<float> const & rhs) {
+    return simd::store(_mm_mul_ps(_mm_set1_ps(lhs), simd::load(rhs)));
+}
+
+//------------------------------------------------------------
+template<> inline Vec4<float>
+operator * (Vec4<float> const & lhs, float rhs) {
+    return simd::store(_mm_mul_ps(simd::load(lhs), _mm_set1_ps(rhs)));
+}
+
+// dot(), length() and normalise() stay scalar, a horizontal add sums in a different order
+// than the templates and the results would no longer match them bit for bit
+
+} /* namespace djc_math */
+#endif /* DJC_MATH_SSE */
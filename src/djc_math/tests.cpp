@@ -182,6 +182,44 @@ void Mat4_tests() {
     auto mult_vec4 = mat_one * Vec4f(1.0f);
     std::cout << mat_one << std::endl;
 
+    // friend free functions
+    auto transposed = transpose(mat_one);
+    auto inverted = inverse(createMat4IdentityMatrix<float>());
+
+    // non float matrices use the plain templates
+    Mat4d mat_double;
+    auto mult_double = mat_double * inverse(mat_double);
+    Mat4i mat_int;
+    auto transposed_int = transpose(mat_int * mat_int);
+
+    // private operators - cant test
+    // ...
+}
+
+void Mat4x3_tests() {
+    // construction
+    Mat4x3f mat_one;
+    Mat4x3f mat_two(createMat3IdentityMatrix<float>(), Vec3f(1.0f));
+    Mat4x3f from_mat4(createMat4IdentityMatrix<float>());
+
+    // member functions
+    auto to_mat3 = mat_one.toMat3();
+    auto to_mat4 = mat_one.toMat4();
+    auto translation = mat_two.getTranslation();
+    Mat4f converted = mat_two;
+
+    // friend free operators
+    auto mult = mat_one * mat_two;
+    auto mult_mat4 = Mat4f() * mat_two;
+    auto mult_mat4_rhs = mat_two * Mat4f();
+    auto mult_vec4 = mat_one * Vec4f(1.0f);
+    auto mult_point = mat_one * Vec3f(1.0f);
+    std::cout << mat_one << std::endl;
+
+    // friend free functions
+    auto inverted = inverse(mat_two);
+    auto inverted_double = inverse(Mat4x3d());
+
     // private operators - cant test
     // ...
 }
@@ -18,121 +18,11 @@
 #include "Vertex.hpp"
 #include "Camera.hpp"
 #include "StarField.hpp"
+#include "Scene.hpp"
+#include "Mesh.hpp"
+#include "AssetLoader.hpp"
 
 
-//------------------------------------------------------------
-struct Mesh {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-};
-
-//------------------------------------------------------------
-std::vector<Mesh> 
-loadDannyFile(std::string const & filePath) {
-    std::vector<Mesh> meshes;
-
-    std::ifstream file(filePath);
-
-    auto stringToVec = [](std::string const & string) -> std::vector<std::string> {
-        std::stringstream ss(string);
-        std::istream_iterator<std::string> begin(ss);
-        std::istream_iterator<std::string> end;
-        std::vector<std::string> vstrings(begin, end);
-        return vstrings;
-    };
-
-    if(file.is_open()) {
-        std::string line; 
-        std::vector<std::string> splitLine;
-
-        std::getline(file, line); // get the first line containing the mesh count
-
-        splitLine = stringToVec(line); // will only contain two entries "meshCount: " + numberOfMeshes
-        
-        const int meshCount = std::stoi(splitLine[1]);
-
-        int currentLineNumber = 1 + meshCount;
-
-        struct MeshSize {
-            int numVertices;
-            int numIndices;
-        };
-
-        std::vector<MeshSize> meshSizes; 
-        meshSizes.resize(meshCount);
-
-        for(int currMesh = 0; currMesh < meshCount; currMesh++) {
-            std::getline(file, line);
-            splitLine = stringToVec(line);
-
-            int numVertices = std::stoi(splitLine[1]);
-            int numIndices  = std::stoi(splitLine[2]);
-
-            meshSizes[currMesh].numVertices = numVertices;
-            meshSizes[currMesh].numIndices = numIndices;
-            
-            std::cout << numVertices << " " << numIndices << std::endl;
-
-        }
-       
-        std::cout << meshCount << std::endl;
-
-       // int meshOneEndLine = currentLineNumber
-       for(int i = 0; i < meshSizes.size(); i++) {
-            Mesh mesh;
-            
-            int loopEnd = currentLineNumber + meshSizes[i].numVertices;
-
-            // extract vertices
-            for(int j = currentLineNumber; j < loopEnd; j++) {
-                std::getline(file, line);
-                splitLine = stringToVec(line);
-                
-                // extract position
-                djc_math::Vec3f position;
-                position.x = std::stof(splitLine[0]);
-                position.y = std::stof(splitLine[1]);
-                position.z = std::stof(splitLine[2]);
-
-                // extract texture coordinates
-                djc_math::Vec2f texcoord;
-                texcoord.x = std::stof(splitLine[3]);
-                texcoord.y = std::stof(splitLine[4]);
-
-                // extract colours
-                djc_math::Vec3f colour;
-                colour.x = std::stof(splitLine[5]);
-                colour.y = std::stof(splitLine[6]);
-                colour.z = std::stof(splitLine[7]);
-
-                Vertex v(position, texcoord, colour);
-
-                mesh.vertices.push_back(v);
-            }
-
-            currentLineNumber = loopEnd;
-            loopEnd += meshSizes[i].numIndices;
-
-            // extract indices
-            for(int j = currentLineNumber; j < loopEnd; j++) {
-                std::getline(file, line);
-                splitLine = stringToVec(line);
-                mesh.indices.push_back(std::stoi(splitLine[0]));
-            }
-            currentLineNumber = loopEnd;
-
-            meshes.push_back(mesh);
-          
-       }
-
-        return meshes;
-
-    } else {
-        std::cerr << "file was not opened" << std::endl;
-        return meshes;
-    }
-}
-
 void mathTest() {
     // mat4 * mat4
     #if 0
@@ -297,7 +187,8 @@ int main(int argc, char* argv[]) {
     int   height = 576;
     float aspect = static_cast<float>(width) / static_cast<float>(height);
     std::cout << "aspect " << aspect << std::endl;
-    Window window("SoftRender", -1, -1, width, height, vSync, fullScreen);
+    Window window("SoftRender", -1, -1, width, height, vSync, fullScreen, Window::PresentMode::ZeroCopy);
+    window.enableDynamicResolution(1000.0f / 60.0f); // trade resolution for frame rate when rendering falls behind
     //..
 
     Input input; // subject
@@ -307,8 +198,10 @@ int main(int argc, char* argv[]) {
     Bitmap randomBitmap = createRandomBitmap(100, 100);
 
 
-    // test models
-    std::vector<Mesh> tree = loadDannyFile("res/box.danny");
+    // test models, loaded on worker threads while a placeholder is drawn
+    AssetLoader assets;
+    AssetHandle<std::vector<Mesh>> tree = assets.loadMeshes("res/box.danny");
+    bool treeLoaded = false;
     
     std::vector<Vertex> triangleVerts;
     triangleVerts.push_back(Vertex(djc_math::Vec3f(-1.0f, -1.0f, 0.0f))); // bottom left
@@ -345,6 +238,12 @@ int main(int argc, char* argv[]) {
     float rot = 0.0f;
     //..
 
+    // scene
+    Scene scene;
+    std::vector<InstanceId> treeInstances;
+    treeInstances.push_back(scene.addInstance(getPlaceholderMesh(), translation));
+    //..
+
     StarField stars(rContext, 0.001f, 0.1);
 
     while(true) {
@@ -359,7 +258,20 @@ int main(int argc, char* argv[]) {
              x += movementSpeed * delta;
          }
          
+         // the first mesh takes over the placeholder's instance, the rest join it
+         if(!treeLoaded && tree->isReady()) {
+             std::vector<Mesh> const & meshes = tree->get();
+             scene.setMesh(treeInstances[0], meshes[0]);
+             for(size_t i = 1; i < meshes.size(); i++) {
+                 treeInstances.push_back(scene.addInstance(meshes[i], translation));
+             }
+             treeLoaded = true;
+         }
+
          translation = djc_math::createMat4TranslationMatrix(djc_math::Vec3f(x, y, z)); 
+         for(auto instance : treeInstances) {
+             scene.setTransform(instance, translation);
+         }
 
         auto viewProjection = proj * view;
         auto modelMatrix = viewProjection * translation; // * rotation * scale;
@@ -382,9 +294,7 @@ int main(int argc, char* argv[]) {
             stars.update();
             stars.render();
 
-            // for(auto i = 0; i < tree.size(); i++) {
-            //     rContext.drawIndexedMesh(tree[i].vertices, tree[i].indices, modelMatrix, randomBitmap);
-            // }
+            scene.draw(rContext, viewProjection, randomBitmap);
 
             
             rContext.drawIndexedMesh(triangleVerts, triangleIndices, modelMatrix, randomBitmap);
@@ -0,0 +1,118 @@
+// std
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// my
+#include "Headless.hpp"
+#include "FrameWriter.hpp"
+#include "RenderContext.hpp"
+#include "Mesh.hpp"
+#include "Scene.hpp"
+#include "djc_math/djc_math.hpp"
+
+/*
+    SoftRenderHeadless
+
+    - renders the test scene with no display and writes the frames to disk
+    - usage: SoftRenderHeadless [output] [frameCount] [ppm|png|y4m|raw] [width] [height]
+    - ppm, y4m and raw are written by a FrameWriter on a background thread, png on the render thread
+    - output is a path prefix for ppm and png, a file for y4m and raw ("-" is stdout)
+*/
+
+//------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    using clock = std::chrono::high_resolution_clock;
+    using FpMilliseconds = std::chrono::duration<float, std::milli>;
+
+    std::string output = argc > 1 ? argv[1] : "frame_";
+    int frameCount     = argc > 2 ? std::atoi(argv[2]) : 10;
+    std::string format = argc > 3 ? argv[3] : "ppm";
+    int width          = argc > 4 ? std::atoi(argv[4]) : 1024;
+    int height         = argc > 5 ? std::atoi(argv[5]) : 576;
+    float aspect       = static_cast<float>(width) / static_cast<float>(height);
+
+    Headless headless(width, height);
+    std::unique_ptr<FrameWriter> writer;
+
+    if(format == "png") {
+        headless.writeImageSequence(output, ImageFormat::PNG);
+    } else {
+        FrameWriter::Format writerFormat = FrameWriter::Format::PPMSequence;
+        if(format == "y4m") {
+            writerFormat = FrameWriter::Format::Y4M;
+        } else if(format == "raw") {
+            writerFormat = FrameWriter::Format::RawRGBA;
+        }
+
+        writer.reset(new FrameWriter(output, writerFormat, width, height));
+        headless.setFrameCallback([&writer](unsigned char const * pixels, int, int, int pitch, int) {
+            writer->submit(pixels, pitch);
+        });
+    }
+
+    RenderContext & rContext = headless.getRenderContext();
+    Bitmap randomBitmap = createRandomBitmap(100, 100);
+
+    std::vector<VertexCacheStats> cacheStats;
+    std::vector<Mesh> box = loadDannyFile("res/box.danny", &cacheStats);
+
+    auto view = djc_math::createMat4ViewMatrix(djc_math::Vec3f(-4, 0, 3), djc_math::Vec3f(0), djc_math::Vec3f(0, 1, 0));
+    auto proj = djc_math::createMat4ProjectionMatrix(djc_math::toRadians(70.0f), aspect, 0.1f, 1000.0f);
+    auto viewProjection = proj * view;
+
+    Scene scene;
+    std::vector<InstanceId> boxInstances;
+    for(auto & mesh : box) {
+        boxInstances.push_back(scene.addInstance(mesh, djc_math::createMat4TranslationMatrix(djc_math::Vec3f(0.0f, 0.0f, -3.0f))));
+    }
+
+    size_t instancesDrawn = 0;
+    auto begin = clock::now();
+
+    for(int frame = 0; frame < frameCount; frame++) {
+        float x = static_cast<float>(frame) * 0.1f;
+        auto modelMatrix = djc_math::createMat4TranslationMatrix(djc_math::Vec3f(x, 0.0f, -3.0f));
+        for(auto instance : boxInstances) {
+            scene.setTransform(instance, modelMatrix);
+        }
+
+        headless.clear();
+        rContext.clearDepthBuffer();
+        instancesDrawn += scene.draw(rContext, viewProjection, randomBitmap);
+        headless.swapBackBuffer();
+    }
+
+    float renderElapsed = FpMilliseconds(clock::now() - begin).count();
+
+    if(writer) {
+        writer->flush();
+    }
+
+    float elapsed = FpMilliseconds(clock::now() - begin).count();
+
+    // stdout may be carrying the video stream
+    std::cerr << headless.getFrameCount() << " frames rendered in " << renderElapsed << "ms, written in " << elapsed << "ms" << std::endl;
+
+    RenderContext::CullStats const & cullStats = rContext.getCullStats();
+    std::cerr << "culling: " << instancesDrawn << "/" << scene.getInstanceCount() * frameCount << " instances passed the scene, "
+              << cullStats.meshesCulled << "/" << cullStats.meshesTested << " of those outside the frustum" << std::endl;
+
+    for(size_t i = 0; i < cacheStats.size(); i++) {
+        std::cerr << "mesh " << i << ": ACMR " << cacheStats[i].acmrBefore << " before, " << cacheStats[i].acmrAfter << " after vertex cache optimisation" << std::endl;
+    }
+
+    if(writer) {
+        FrameWriter::Stats stats = writer->getStats();
+        std::cerr << "writer: " << stats.written << "/" << stats.submitted << " written, "
+                  << stats.dropped << " dropped, "
+                  << stats.blockedSubmits << " blocked submits (" << stats.blockedMs << "ms), "
+                  << "max queued " << stats.maxQueued << ", "
+                  << "write time " << stats.writeMs << "ms" << std::endl;
+    }
+
+    return 0;
+}
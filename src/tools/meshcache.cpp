@@ -0,0 +1,72 @@
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// my
+#include "MeshCache.hpp"
+
+/*
+    SoftRenderMeshCache
+
+    - loads a .danny or .obj file through the processed mesh cache twice and reports both times
+    - usage: SoftRenderMeshCache cacheDirectory input.danny|input.obj [lodLevels]
+    - the input's entry is removed first, so the first load is cold and the second warm
+*/
+
+//------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    using clock = std::chrono::high_resolution_clock;
+    using FpMilliseconds = std::chrono::duration<float, std::milli>;
+
+    if(argc < 3) {
+        std::cerr << "usage: " << argv[0] << " cacheDirectory input.danny|input.obj [lodLevels]" << std::endl;
+        return 1;
+    }
+
+    std::string cacheDirectory = argv[1];
+    std::string input          = argv[2];
+
+    MeshProcessOptions options;
+    options.lodLevels = argc > 3 ? static_cast<size_t>(std::max(std::atoi(argv[3]), 1)) : LOD_MAX_LEVELS;
+
+    uint64_t contentHash;
+    if(!hashFileContents(input, contentHash)) {
+        return 1;
+    }
+
+    std::error_code error;
+    std::string cachePath = getMeshCachePath(cacheDirectory, contentHash, options);
+    std::filesystem::remove(cachePath, error);
+
+    char const * names[2] = { "cold", "warm" };
+    for(int run = 0; run < 2; run++) {
+        auto begin = clock::now();
+        bool hit = false;
+        std::vector<LodChain> chains = loadProcessedMeshes(input, cacheDirectory, options, &hit);
+        float elapsed = FpMilliseconds(clock::now() - begin).count();
+
+        if(chains.empty()) {
+            return 1;
+        }
+
+        size_t levels = 0;
+        size_t triangles = 0;
+        for(auto const & chain : chains) {
+            levels += chain.levels.size();
+            for(auto const & level : chain.levels) {
+                triangles += level.mesh.indices.size() / 3;
+            }
+        }
+
+        std::cerr << names[run] << ": " << elapsed << "ms, cache " << (hit ? "hit" : "miss") << ", "
+                  << chains.size() << " meshes, " << levels << " lod levels, " << triangles << " triangles" << std::endl;
+    }
+
+    std::cerr << "entry " << cachePath << std::endl;
+    return 0;
+}
@@ -0,0 +1,127 @@
+// std
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// my
+#include "Mesh.hpp"
+#include "MeshCompression.hpp"
+#include "MeshFile.hpp"
+#include "PackedMesh.hpp"
+#include "TextParse.hpp"
+
+/*
+    SoftRenderMeshConvert
+
+    - converts a .danny file into a .srmesh file that MappedMeshFile maps without parsing
+    - usage: SoftRenderMeshConvert input.danny output.srmesh
+    - an output ending in .srmeshz is packed and compressed instead, see MeshCompression.hpp, and
+      reports the sizes and decode time
+    - meshes are cache ordered and get their bounds and meshlets on the way, as loadDannyFile does
+    - reports the load time of both files so the difference is visible
+*/
+
+namespace {
+
+//------------------------------------------------------------
+int
+writeCompressed(std::vector<Mesh> const & meshes, std::string const & output) {
+    using clock = std::chrono::high_resolution_clock;
+    using FpMilliseconds = std::chrono::duration<float, std::milli>;
+
+    size_t packedSize = 0;
+    size_t compressedSize = 0;
+    std::vector<CompressedMesh> compressed;
+    for(Mesh const & mesh : meshes) {
+        PackedMesh packed = packMesh(mesh);
+        packedSize += packed.vertices.size() * sizeof(PackedVertex) + packed.indices.size() * sizeof(unsigned int)
+                    + packed.meshlets.clusters.size() * sizeof(Meshlet) + packed.meshlets.vertices.size() * sizeof(unsigned int)
+                    + packed.meshlets.triangles.size();
+
+        compressed.push_back(compressMesh(packed));
+        compressedSize += compressed.back().data.size();
+    }
+
+    if(!writeCompressedMeshFile(output, compressed)) {
+        return 1;
+    }
+
+    std::vector<CompressedMesh> loaded = loadCompressedMeshFile(output);
+    if(loaded.size() != meshes.size()) {
+        return 1;
+    }
+
+    auto begin = clock::now();
+    PackedMesh decoded;
+    for(CompressedMesh const & mesh : loaded) {
+        if(!decompressMesh(mesh, decoded)) {
+            return 1;
+        }
+    }
+    float decodeElapsed = FpMilliseconds(clock::now() - begin).count();
+
+    std::cerr << "packed " << packedSize << " bytes, compressed " << compressedSize << " bytes, decoded in "
+              << decodeElapsed << "ms (" << getMeshCodecPath() << ")" << std::endl;
+    return 0;
+}
+
+}
+
+//------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    using clock = std::chrono::high_resolution_clock;
+    using FpMilliseconds = std::chrono::duration<float, std::milli>;
+
+    if(argc < 3) {
+        std::cerr << "usage: " << argv[0] << " input.danny output.srmesh" << std::endl;
+        return 1;
+    }
+
+    std::string input  = argv[1];
+    std::string output = argv[2];
+
+    auto begin = clock::now();
+    std::vector<VertexCacheStats> cacheStats;
+    std::vector<Mesh> meshes = loadDannyFile(input, &cacheStats);
+    float dannyElapsed = FpMilliseconds(clock::now() - begin).count();
+
+    if(meshes.empty()) {
+        std::cerr << "no meshes in " << input << std::endl;
+        return 1;
+    }
+
+    size_t vertexCount = 0;
+    size_t triangleCount = 0;
+    for(size_t i = 0; i < meshes.size(); i++) {
+        vertexCount += meshes[i].vertices.size();
+        triangleCount += meshes[i].indices.size() / 3;
+        std::cerr << "mesh " << i << ": " << meshes[i].vertices.size() << " vertices, " << meshes[i].indices.size() / 3 << " triangles, "
+                  << "ACMR " << cacheStats[i].acmrBefore << " before, " << cacheStats[i].acmrAfter << " after" << std::endl;
+    }
+
+    if(endsWith(output, ".srmeshz")) {
+        return writeCompressed(meshes, output);
+    }
+
+    if(!writeMeshFile(output, meshes)) {
+        return 1;
+    }
+
+    // the same meshes from the new file, mapped and then copied out
+    begin = clock::now();
+    MappedMeshFile mapped;
+    if(!mapped.open(output)) {
+        return 1;
+    }
+    float mapElapsed = FpMilliseconds(clock::now() - begin).count();
+
+    std::vector<Mesh> loaded = loadMeshFile(output);
+    float loadElapsed = FpMilliseconds(clock::now() - begin).count() - mapElapsed;
+
+    std::cerr << meshes.size() << " meshes, " << vertexCount << " vertices, " << triangleCount << " triangles" << std::endl;
+    std::cerr << input << " loaded in " << dannyElapsed << "ms, " << output << " mapped in " << mapElapsed
+              << "ms and copied into meshes in " << loadElapsed << "ms" << std::endl;
+
+    return loaded.size() == meshes.size() ? 0 : 1;
+}